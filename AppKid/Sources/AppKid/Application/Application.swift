@@ -8,7 +8,7 @@
 import Foundation
 import CoreFoundation
 import CXlib
-import CairoGraphics
+@_spi(AppKid) import CairoGraphics
 @_spi(AppKid) import ContentAnimation
 import TinyFoundation
 
@@ -67,6 +67,9 @@ open class Application: Responder {
     internal var renderScheduler: RenderScheduler? = nil
 
     internal var softwareRenderers: [Int: SoftwareRenderer] = [:]
+
+    internal var eventRecorder: EventRecorder? = nil
+    internal var eventReplayer: EventReplayer? = nil
     
     internal var eventQueue = [Event]()
     open fileprivate(set) var currentEvent: Event?
@@ -79,19 +82,28 @@ open class Application: Responder {
     internal var stopRequested = false
 
     internal lazy var softwareRenderTimer: Timer = Timer(timeInterval: 1.0 / 60.0, repeats: true) { [unowned self] _ in
+        var renderedWindowsCount = 0
+
         windowsByNumber.values
             .lazy
             .filter {
                 $0.nativeWindow.syncRequested == false && $0.isMapped == true
             }
-            .map {
-                ($0, self.softwareRenderers[$0.windowNumber])
-            }
-            .forEach {
-                $0.1?.render(window: $0.0)
+            .forEach { window in
+                guard let renderer = self.softwareRenderers[window.windowNumber] else {
+                    return
+                }
+
+                renderer.render(window: window)
+                renderedWindowsCount += 1
             }
 
         self.displayServer.flush()
+
+        // smumriak: timer starts ticking before any window is mapped, those ticks present nothing
+        if renderedWindowsCount > 0 {
+            StartupTrace.shared?.firstFramePresented()
+        }
     }
 
     // MARK: - Initialization
@@ -101,19 +113,66 @@ open class Application: Responder {
     }
     
     internal override init() {
-        displayServer = X11DisplayServer(applicationName: "AppKid")
-
-        do {
-            try VolcanoRenderStack.setupGlobalStack()
-            let renderStack: VolcanoRenderStack = VolcanoRenderStack.global
-            CABackingStoreContext.setupGlobalContext(device: renderStack.device, accessQueues: [renderStack.queues.graphics, renderStack.queues.transfer])
-            isVolcanoRenderingEnabled = true
-            renderScheduler = try RenderScheduler(renderStack: renderStack, runLoop: CFRunLoopGetCurrent())
-        } catch {
-            debugPrint("Could not start vulkan rendering. Falling back to software rendering. Error: \(error)")
+        // smumriak: vulkan driver may talk to X11 from background thread below, so xlib has to be made thread safe before anything else touches it
+        XInitThreads()
+
+        // smumriak: vulkan device, shader modules and fonts do not depend on X11 connection, so they are set up on background threads while main thread connects to display server
+        let renderStackSetup = DispatchGroup()
+        var renderStackError: Error? = nil
+
+        DispatchQueue.global(qos: .userInitiated).async(group: renderStackSetup) {
+            do {
+                try StartupTrace.phase("Vulkan device") {
+                    try VolcanoRenderStack.setupGlobalStack()
+                }
+
+                let renderStack: VolcanoRenderStack = VolcanoRenderStack.global
+
+                StartupTrace.phase("Backing store context") {
+                    CABackingStoreContext.setupGlobalContext(device: renderStack.device, accessQueues: [renderStack.queues.graphics, renderStack.queues.transfer])
+                }
+
+                try StartupTrace.phase("Shader modules") {
+                    try renderStack.shaderLibrary.preload()
+                }
+            } catch {
+                renderStackError = error
+            }
         }
 
-        displayServer.activate()
+        DispatchQueue.global(qos: .utility).async {
+            StartupTrace.phase("Font map warm up") {
+                TextFontMap.warmUp()
+            }
+        }
+
+        let displayServer = StartupTrace.phase("X11 connection") {
+            X11DisplayServer(applicationName: "AppKid")
+        }
+        self.displayServer = displayServer
+
+        StartupTrace.phase("Waiting for vulkan device") {
+            renderStackSetup.wait()
+        }
+
+        if let renderStackError = renderStackError {
+            debugPrint("Could not start vulkan rendering. Falling back to software rendering. Error: \(renderStackError)")
+        } else {
+            do {
+                let renderStack: VolcanoRenderStack = VolcanoRenderStack.global
+                isVolcanoRenderingEnabled = true
+                renderScheduler = try RenderScheduler(renderStack: renderStack, runLoop: CFRunLoopGetCurrent())
+                #if os(Linux)
+                    renderStack.fenceCompletionPort.schedule(in: .current, forMode: .common)
+                #endif
+            } catch {
+                debugPrint("Could not start vulkan rendering. Falling back to software rendering. Error: \(error)")
+            }
+        }
+
+        StartupTrace.phase("X11 activation") {
+            displayServer.activate()
+        }
 
         super.init()
     }
@@ -151,6 +210,9 @@ open class Application: Responder {
             let windows = self.windows
             windows.forEach { $0.close() }
 
+            eventRecorder?.close()
+            InputLatencyTracker.shared?.writeReport()
+
             if isVolcanoRenderingEnabled {
                 let renderStack: VolcanoRenderStack = VolcanoRenderStack.global
                 do {
@@ -181,8 +243,14 @@ open class Application: Responder {
             RunLoop.current.add(softwareRenderTimer, forMode: .common)
         }
 
-        let _ = delegate?.application(self, willFinishLaunchingWithOptions: nil)
-        let _ = delegate?.application(self, didFinishLaunchingWithOptions: nil)
+        StartupTrace.phase("Will finish launching") {
+            let _ = delegate?.application(self, willFinishLaunchingWithOptions: nil)
+        }
+        StartupTrace.phase("Did finish launching") {
+            let _ = delegate?.application(self, didFinishLaunchingWithOptions: nil)
+        }
+
+        startEventRecordingAndReplay()
 
         while isRunning {
             guard let event = nextEvent(matching: .any, until: .distantFuture, in: .default, dequeue: true) else {
@@ -218,9 +286,40 @@ open class Application: Responder {
     }
     
     open func send(event: Event) {
+        InputLatencyTracker.shared?.eventDispatched(event)
+
         event.window?.send(event: event)
     }
 
+    internal func startEventRecordingAndReplay() {
+        if let path = kEventRecordingPath {
+            do {
+                eventRecorder = try EventRecorder(path: path)
+            } catch {
+                debugPrint("Could not start recording events to \(path). Error: \(error)")
+            }
+        }
+
+        if let path = kEventReplayPath {
+            do {
+                let replayer = try EventReplayer(path: path, speed: kEventReplayAtMaximumSpeed ? .maximum : .original)
+
+                // smumriak: giving the last frames a moment to present before terminating so their latency is accounted
+                replayer.completion = { [unowned self] in
+                    let timer = Timer(timeInterval: 0.5, repeats: false) { [unowned self] _ in
+                        self.terminate()
+                    }
+                    RunLoop.current.add(timer, forMode: .common)
+                }
+
+                eventReplayer = replayer
+                replayer.start()
+            } catch {
+                debugPrint("Could not replay events from \(path). Error: \(error)")
+            }
+        }
+    }
+
     internal func indexOfEvent(matching mask: Event.EventTypeMask, serviceDisplayServerEventQueue: Bool = true) -> Array<Event>.Index? {
         if serviceDisplayServerEventQueue {
             displayServer.serviceEventsQueue()
@@ -279,7 +378,9 @@ open class Application: Responder {
     @_spi(AppKid) public func add(window: Window) {
         if isVolcanoRenderingEnabled {
             do {
-                try renderScheduler?.createRenderer(for: window)
+                try StartupTrace.phase("Renderer for window \(window.windowNumber)") {
+                    try renderScheduler?.createRenderer(for: window)
+                }
             } catch {
                 fatalError("Failed to create window renderer with error: \(error)")
             }
@@ -0,0 +1,82 @@
+//
+//  StartupTrace.swift
+//  AppKid
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import CoreFoundation
+import TinyFoundation
+
+internal let kStartupTraceEnabled: Bool = ProcessInfo.processInfo.environment["APPKID_STARTUP_TRACE"] != nil
+
+/// Records phases of application startup that run on main and background threads and prints them once first frame of any window is presented
+internal final class StartupTrace {
+    static let shared: StartupTrace? = kStartupTraceEnabled ? StartupTrace() : nil
+
+    struct Phase {
+        let name: String
+        let isMainThread: Bool
+        let start: TimeInterval
+        let end: TimeInterval
+    }
+
+    internal let startTime = CFAbsoluteTimeGetCurrent()
+
+    fileprivate let lock = Lock()
+    fileprivate var phases: [Phase] = []
+    fileprivate var isReported = false
+
+    static func phase<R>(_ name: @autoclosure () -> String, _ body: () throws -> R) rethrows -> R {
+        guard let shared = shared else {
+            return try body()
+        }
+
+        return try shared.phase(name(), body)
+    }
+
+    func phase<R>(_ name: String, _ body: () throws -> R) rethrows -> R {
+        let start = CFAbsoluteTimeGetCurrent() - startTime
+        defer {
+            let phase = Phase(name: name, isMainThread: Thread.isMainThread, start: start, end: CFAbsoluteTimeGetCurrent() - startTime)
+
+            lock.synchronized {
+                phases.append(phase)
+            }
+        }
+
+        return try body()
+    }
+
+    func firstFramePresented() {
+        let presentTime = CFAbsoluteTimeGetCurrent() - startTime
+
+        let phases: [Phase]? = lock.synchronized {
+            if isReported {
+                return nil
+            }
+
+            isReported = true
+
+            return self.phases
+        }
+
+        guard let phases = phases else {
+            return
+        }
+
+        print("Startup trace, first frame presented at \(format(presentTime)) ms")
+
+        phases
+            .sorted { $0.start < $1.start }
+            .forEach {
+                let thread = $0.isMainThread ? "main" : "background"
+                print("  \($0.name.padding(toLength: 28, withPad: " ", startingAt: 0)) \(thread.padding(toLength: 10, withPad: " ", startingAt: 0)) at \(format($0.start)) ms, took \(format($0.end - $0.start)) ms")
+            }
+    }
+
+    private func format(_ value: TimeInterval) -> String {
+        String(format: "%.2f", value * 1000)
+    }
+}
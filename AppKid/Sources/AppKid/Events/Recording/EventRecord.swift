@@ -0,0 +1,273 @@
+//
+//  EventRecord.swift
+//  AppKid
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+
+internal enum EventRecordingError: Error {
+    case failedToOpenFile(path: String)
+    case invalidHeader
+    case unsupportedVersion(UInt16)
+    case truncatedRecord(index: Int)
+}
+
+/// Compact binary representation of converted input event. Session file starts with "AKEV" magic and format version, followed by records of fixed size part and two length prefixed UTF-8 strings. All numbers are little endian
+internal struct EventRecord {
+    static let magic: [UInt8] = Array("AKEV".utf8)
+    static let version: UInt16 = 1
+    static let recordedTypes: Event.EventTypeMask = [.anyMouse, .anyKeyboard, .flagsChanged, .mouseEntered, .mouseExited]
+
+    // smumriak: X11 window ids are different on every run, so windows are stored as index in the list of application windows sorted by window number
+    var timestamp: Double = 0
+    var type: UInt8 = 0
+    var subType: UInt8 = 0
+    var windowIndex: UInt8 = 0
+    var flags: UInt8 = 0
+    var modifierFlags: UInt32 = 0
+    var keyCode: UInt32 = 0
+    var buttonNumber: Int16 = 0
+    var clickCount: Int16 = 0
+    var locationX: Float = 0
+    var locationY: Float = 0
+    var deltaX: Float = 0
+    var deltaY: Float = 0
+    var deltaZ: Float = 0
+    var scrollingDeltaX: Float = 0
+    var scrollingDeltaY: Float = 0
+    var characters: String? = nil
+    var charactersIgnoringModifiers: String? = nil
+
+    private static let isARepeatFlag: UInt8 = 1 << 0
+    private static let hasPreciseScrollingDeltasFlag: UInt8 = 1 << 1
+    private static let isDirectionInvertedFromDeviceFlag: UInt8 = 1 << 2
+    private static let nilStringLength: UInt16 = .max
+
+    init(event: Event, windowIndex: Int) {
+        timestamp = event.timestamp
+        type = UInt8(truncatingIfNeeded: event.type.rawValue)
+        subType = UInt8(truncatingIfNeeded: event.subType.rawValue)
+        self.windowIndex = UInt8(truncatingIfNeeded: windowIndex)
+        modifierFlags = UInt32(truncatingIfNeeded: event.modifierFlags.rawValue)
+        keyCode = UInt32(event.keyCode)
+        buttonNumber = Int16(truncatingIfNeeded: event.buttonNumber)
+        clickCount = Int16(truncatingIfNeeded: event.clickCount)
+        locationX = Float(event.locationInWindow.x)
+        locationY = Float(event.locationInWindow.y)
+        deltaX = Float(event.deltaX)
+        deltaY = Float(event.deltaY)
+        deltaZ = Float(event.deltaZ)
+        scrollingDeltaX = Float(event.scrollingDeltaX)
+        scrollingDeltaY = Float(event.scrollingDeltaY)
+        characters = event.characters
+        charactersIgnoringModifiers = event.charactersIgnoringModifiers
+
+        if event.isARepeat {
+            flags |= Self.isARepeatFlag
+        }
+        if event.hasPreciseScrollingDeltas {
+            flags |= Self.hasPreciseScrollingDeltasFlag
+        }
+        if event.isDirectionInvertedFromDevice {
+            flags |= Self.isDirectionInvertedFromDeviceFlag
+        }
+    }
+
+    private init() {}
+
+    /// Creates event targeting window with given number. Returns nil if the record has event type unknown to this build
+    func makeEvent(windowNumber: Int, timestamp: TimeInterval) -> Event? {
+        guard let type = Event.EventType(rawValue: UInt(type)), let subType = Event.EventSubtype(rawValue: UInt(subType)) else {
+            return nil
+        }
+
+        let event = Event(type: type, location: CGPoint(x: CGFloat(locationX), y: CGFloat(locationY)), modifierFlags: Event.ModifierFlags(rawValue: UInt(modifierFlags)), windowNumber: windowNumber)
+        event.subType = subType
+        event.timestamp = timestamp
+        event.keyCode = CUnsignedInt(keyCode)
+        event.buttonNumber = Int(buttonNumber)
+        event.clickCount = Int(clickCount)
+        event.deltaX = CGFloat(deltaX)
+        event.deltaY = CGFloat(deltaY)
+        event.deltaZ = CGFloat(deltaZ)
+        event.scrollingDeltaX = CGFloat(scrollingDeltaX)
+        event.scrollingDeltaY = CGFloat(scrollingDeltaY)
+        event.characters = characters
+        event.charactersIgnoringModifiers = charactersIgnoringModifiers
+        event.isARepeat = flags & Self.isARepeatFlag != 0
+        event.hasPreciseScrollingDeltas = flags & Self.hasPreciseScrollingDeltasFlag != 0
+        event.isDirectionInvertedFromDevice = flags & Self.isDirectionInvertedFromDeviceFlag != 0
+
+        return event
+    }
+}
+
+internal extension EventRecord {
+    static var header: Data {
+        var data = Data(magic)
+        data.appendLittleEndian(version)
+        data.appendLittleEndian(UInt16(0))
+        return data
+    }
+
+    func encode(into data: inout Data) {
+        data.appendLittleEndian(timestamp.bitPattern)
+        data.append(contentsOf: [type, subType, windowIndex, flags])
+        data.appendLittleEndian(modifierFlags)
+        data.appendLittleEndian(keyCode)
+        data.appendLittleEndian(buttonNumber)
+        data.appendLittleEndian(clickCount)
+        [locationX, locationY, deltaX, deltaY, deltaZ, scrollingDeltaX, scrollingDeltaY].forEach {
+            data.appendLittleEndian($0.bitPattern)
+        }
+        Self.encode(string: characters, into: &data)
+        Self.encode(string: charactersIgnoringModifiers, into: &data)
+    }
+
+    static func decodeSession(from data: Data) throws -> [EventRecord] {
+        var reader = LittleEndianReader(data: data)
+
+        guard let magic = reader.readBytes(count: magic.count), magic == Self.magic else {
+            throw EventRecordingError.invalidHeader
+        }
+
+        guard let version: UInt16 = reader.read(), let _: UInt16 = reader.read() else {
+            throw EventRecordingError.invalidHeader
+        }
+
+        guard version == Self.version else {
+            throw EventRecordingError.unsupportedVersion(version)
+        }
+
+        var result: [EventRecord] = []
+
+        while reader.isAtEnd == false {
+            guard let record = decode(from: &reader) else {
+                throw EventRecordingError.truncatedRecord(index: result.count)
+            }
+
+            result.append(record)
+        }
+
+        return result
+    }
+
+    private static func decode(from reader: inout LittleEndianReader) -> EventRecord? {
+        var record = EventRecord()
+
+        guard let timestamp: UInt64 = reader.read(), let bytes = reader.readBytes(count: 4) else {
+            return nil
+        }
+
+        record.timestamp = Double(bitPattern: timestamp)
+        record.type = bytes[0]
+        record.subType = bytes[1]
+        record.windowIndex = bytes[2]
+        record.flags = bytes[3]
+
+        guard let modifierFlags: UInt32 = reader.read(),
+              let keyCode: UInt32 = reader.read(),
+              let buttonNumber: Int16 = reader.read(),
+              let clickCount: Int16 = reader.read() else {
+            return nil
+        }
+
+        record.modifierFlags = modifierFlags
+        record.keyCode = keyCode
+        record.buttonNumber = buttonNumber
+        record.clickCount = clickCount
+
+        var floats: [Float] = []
+        for _ in 0..<7 {
+            guard let value: UInt32 = reader.read() else {
+                return nil
+            }
+            floats.append(Float(bitPattern: value))
+        }
+
+        record.locationX = floats[0]
+        record.locationY = floats[1]
+        record.deltaX = floats[2]
+        record.deltaY = floats[3]
+        record.deltaZ = floats[4]
+        record.scrollingDeltaX = floats[5]
+        record.scrollingDeltaY = floats[6]
+
+        guard let characters = decodeString(from: &reader), let charactersIgnoringModifiers = decodeString(from: &reader) else {
+            return nil
+        }
+
+        record.characters = characters
+        record.charactersIgnoringModifiers = charactersIgnoringModifiers
+
+        return record
+    }
+
+    private static func encode(string: String?, into data: inout Data) {
+        guard let string = string else {
+            data.appendLittleEndian(nilStringLength)
+            return
+        }
+
+        let bytes = Array(string.utf8.prefix(Int(nilStringLength - 1)))
+        data.appendLittleEndian(UInt16(bytes.count))
+        data.append(contentsOf: bytes)
+    }
+
+    // smumriak: double optional. outer nil means the record is truncated, inner nil means string was nil when recorded
+    private static func decodeString(from reader: inout LittleEndianReader) -> String?? {
+        guard let length: UInt16 = reader.read() else {
+            return nil
+        }
+
+        if length == nilStringLength {
+            return .some(nil)
+        }
+
+        guard let bytes = reader.readBytes(count: Int(length)) else {
+            return nil
+        }
+
+        return .some(String(decoding: bytes, as: UTF8.self))
+    }
+}
+
+internal struct LittleEndianReader {
+    let data: Data
+    private(set) var offset: Int
+
+    init(data: Data) {
+        self.data = data
+        offset = data.startIndex
+    }
+
+    var isAtEnd: Bool { offset >= data.endIndex }
+
+    mutating func readBytes(count: Int) -> [UInt8]? {
+        guard data.endIndex - offset >= count else {
+            return nil
+        }
+
+        defer { offset += count }
+
+        return Array(data[offset..<offset + count])
+    }
+
+    mutating func read<T: FixedWidthInteger>() -> T? {
+        guard let bytes = readBytes(count: MemoryLayout<T>.size) else {
+            return nil
+        }
+
+        return bytes.reversed().reduce(T.zero) { ($0 << 8) | T(truncatingIfNeeded: $1) }
+    }
+}
+
+internal extension Data {
+    mutating func appendLittleEndian<T: FixedWidthInteger>(_ value: T) {
+        withUnsafeBytes(of: value.littleEndian) {
+            append(contentsOf: $0)
+        }
+    }
+}
@@ -0,0 +1,66 @@
+//
+//  EventRecorder.swift
+//  AppKid
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+
+internal let kEventRecordingPath: String? = ProcessInfo.processInfo.environment["APPKID_RECORD_EVENTS"]
+
+/// Writes input events converted from display server events into session file that can be replayed with `EventReplayer`
+internal final class EventRecorder {
+    private let fileHandle: FileHandle
+    private var buffer = Data()
+    private let flushThreshold = 64 * 1024
+
+    init(path: String) throws {
+        guard FileManager.default.createFile(atPath: path, contents: nil), let fileHandle = FileHandle(forWritingAtPath: path) else {
+            throw EventRecordingError.failedToOpenFile(path: path)
+        }
+
+        self.fileHandle = fileHandle
+        buffer.append(EventRecord.header)
+    }
+
+    deinit {
+        close()
+    }
+
+    func record(_ event: Event, in application: Application) {
+        guard EventRecord.recordedTypes.contains(event.type.mask) else {
+            return
+        }
+
+        guard let windowIndex = application.sortedWindowNumbers.firstIndex(of: event.windowNumber) else {
+            return
+        }
+
+        EventRecord(event: event, windowIndex: windowIndex).encode(into: &buffer)
+
+        if buffer.count >= flushThreshold {
+            flush()
+        }
+    }
+
+    func flush() {
+        if buffer.isEmpty {
+            return
+        }
+
+        fileHandle.write(buffer)
+        buffer.removeAll(keepingCapacity: true)
+    }
+
+    func close() {
+        flush()
+        fileHandle.synchronizeFile()
+    }
+}
+
+internal extension Application {
+    var sortedWindowNumbers: [Int] {
+        windowsByNumber.keys.sorted()
+    }
+}
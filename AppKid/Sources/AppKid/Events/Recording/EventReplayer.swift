@@ -0,0 +1,97 @@
+//
+//  EventReplayer.swift
+//  AppKid
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import CoreFoundation
+
+internal let kEventReplayPath: String? = ProcessInfo.processInfo.environment["APPKID_REPLAY_EVENTS"]
+internal let kEventReplayAtMaximumSpeed: Bool = ProcessInfo.processInfo.environment["APPKID_REPLAY_SPEED"] == "maximum"
+
+/// Feeds recorded session back into application event queue. Events get timestamps of the moment they are posted, so latency is measured from the replayed post and not from the original session
+internal final class EventReplayer {
+    enum Speed {
+        /// Keeps original intervals between events
+        case original
+        /// Posts next event as soon as previous one was taken from the event queue
+        case maximum
+    }
+
+    let records: [EventRecord]
+    let speed: Speed
+    var completion: (() -> ())? = nil
+
+    private var nextIndex = 0
+    private var startTime: CFAbsoluteTime = 0
+    private var lastPostedEvent: Event? = nil
+    private var timer: Timer? = nil
+
+    init(path: String, speed: Speed) throws {
+        records = try EventRecord.decodeSession(from: Data(contentsOf: URL(fileURLWithPath: path)))
+        self.speed = speed
+    }
+
+    deinit {
+        timer?.invalidate()
+    }
+
+    func start() {
+        startTime = CFAbsoluteTimeGetCurrent()
+        scheduleNext()
+    }
+
+    private func scheduleNext() {
+        guard nextIndex < records.count else {
+            completion?()
+            return
+        }
+
+        let fireDate: Date
+        switch speed {
+            case .original:
+                let offset = records[nextIndex].timestamp - records[0].timestamp
+                fireDate = Date(timeIntervalSinceReferenceDate: startTime + offset)
+
+            case .maximum:
+                fireDate = Date()
+        }
+
+        let timer = Timer(fire: fireDate, interval: 0, repeats: false) { [unowned self] _ in
+            self.fire()
+        }
+        RunLoop.current.add(timer, forMode: .common)
+        self.timer = timer
+    }
+
+    private func fire() {
+        let application = Application.shared
+
+        // smumriak: at maximum speed events are still posted one per run loop iteration, otherwise the whole session would be coalesced into a couple of frames
+        if speed == .maximum, let lastPostedEvent = lastPostedEvent, application.eventQueue.contains(where: { $0 === lastPostedEvent }) {
+            scheduleNext()
+            return
+        }
+
+        let now = CFAbsoluteTimeGetCurrent()
+        let windowNumbers = application.sortedWindowNumbers
+
+        repeat {
+            let record = records[nextIndex]
+            nextIndex += 1
+
+            guard Int(record.windowIndex) < windowNumbers.count else {
+                continue
+            }
+
+            if let event = record.makeEvent(windowNumber: windowNumbers[Int(record.windowIndex)], timestamp: now - application.startTime) {
+                application.post(event: event, atStart: false)
+                lastPostedEvent = event
+            }
+        } while speed == .original && nextIndex < records.count && records[nextIndex].timestamp - records[0].timestamp <= now - startTime
+
+        scheduleNext()
+    }
+}
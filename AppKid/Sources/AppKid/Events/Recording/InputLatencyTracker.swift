@@ -0,0 +1,179 @@
+//
+//  InputLatencyTracker.swift
+//  AppKid
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import CoreFoundation
+
+internal let kInputLatencyReportPath: String? = ProcessInfo.processInfo.environment["APPKID_INPUT_LATENCY_REPORT"]
+
+/// Measures time from input event timestamp to the present of the first frame of event's window that started rendering after the event was dispatched
+internal final class InputLatencyTracker {
+    static let shared: InputLatencyTracker? = {
+        let environment = ProcessInfo.processInfo.environment
+        if environment["APPKID_INPUT_LATENCY"] != nil || kEventReplayPath != nil || kInputLatencyReportPath != nil {
+            return InputLatencyTracker()
+        } else {
+            return nil
+        }
+    }()
+
+    struct Sample: Codable {
+        let type: String
+        let timestamp: Double
+        let latencyMilliseconds: Double
+    }
+
+    struct Histogram: Codable {
+        struct Bucket: Codable {
+            /// Upper bound in milliseconds, nil for the last open ended bucket
+            let upperBound: Double?
+            let count: Int
+        }
+
+        let type: String
+        let count: Int
+        let p50: Double
+        let p90: Double
+        let p99: Double
+        let max: Double
+        let buckets: [Bucket]
+
+        static let bucketUpperBounds: [Double] = [1, 2, 4, 8, 12, 16, 24, 33, 50, 66, 100, 200, 500]
+
+        init(type: String, latencies: [Double]) {
+            let sorted = latencies.sorted()
+
+            func percentile(_ value: Double) -> Double {
+                if sorted.isEmpty {
+                    return 0
+                }
+
+                return sorted[Int((Double(sorted.count - 1) * value).rounded())]
+            }
+
+            self.type = type
+            count = sorted.count
+            p50 = percentile(0.5)
+            p90 = percentile(0.9)
+            p99 = percentile(0.99)
+            max = sorted.last ?? 0
+
+            var counts = Array(repeating: 0, count: Self.bucketUpperBounds.count + 1)
+            sorted.forEach { latency in
+                counts[Self.bucketUpperBounds.firstIndex(where: { latency < $0 }) ?? Self.bucketUpperBounds.count] += 1
+            }
+
+            buckets = counts.enumerated().map { index, count in
+                Bucket(upperBound: index < Self.bucketUpperBounds.count ? Self.bucketUpperBounds[index] : nil, count: count)
+            }
+        }
+    }
+
+    struct Report: Codable {
+        let histograms: [Histogram]
+        let events: [Sample]
+        let unpresentedEvents: Int
+    }
+
+    private struct PendingEvent {
+        let type: String
+        let timestamp: TimeInterval
+    }
+
+    private var dispatchedEvents: [Int: [PendingEvent]] = [:]
+    private var renderingEvents: [Int: [PendingEvent]] = [:]
+    private(set) var samples: [Sample] = []
+
+    private var currentTime: TimeInterval {
+        CFAbsoluteTimeGetCurrent() - Application.shared.startTime
+    }
+
+    func eventDispatched(_ event: Event) {
+        guard EventRecord.recordedTypes.contains(event.type.mask) else {
+            return
+        }
+
+        dispatchedEvents[event.windowNumber, default: []].append(PendingEvent(type: event.type.latencyCategory, timestamp: event.timestamp))
+    }
+
+    /// Events dispatched to the window so far are considered reflected by the frame that starts rendering now. Frames that fail to present keep the events for the next one
+    func frameWillRender(windowNumber: Int) {
+        guard let events = dispatchedEvents.removeValue(forKey: windowNumber) else {
+            return
+        }
+
+        renderingEvents[windowNumber, default: []].append(contentsOf: events)
+    }
+
+    func framePresented(windowNumber: Int) {
+        guard let events = renderingEvents.removeValue(forKey: windowNumber) else {
+            return
+        }
+
+        let presentTime = currentTime
+
+        samples.append(contentsOf: events.map {
+            Sample(type: $0.type, timestamp: $0.timestamp, latencyMilliseconds: (presentTime - $0.timestamp) * 1000)
+        })
+    }
+
+    func makeReport() -> Report {
+        let grouped = Dictionary(grouping: samples, by: { $0.type })
+        var histograms = grouped.keys.sorted().map { type in
+            Histogram(type: type, latencies: grouped[type]!.map { $0.latencyMilliseconds })
+        }
+        histograms.insert(Histogram(type: "all", latencies: samples.map { $0.latencyMilliseconds }), at: 0)
+
+        let unpresentedEvents = dispatchedEvents.values.reduce(0) { $0 + $1.count } + renderingEvents.values.reduce(0) { $0 + $1.count }
+
+        return Report(histograms: histograms, events: samples, unpresentedEvents: unpresentedEvents)
+    }
+
+    /// Writes JSON report to APPKID_INPUT_LATENCY_REPORT path if it is set, prints histograms otherwise
+    func writeReport() {
+        let report = makeReport()
+
+        if let path = kInputLatencyReportPath {
+            do {
+                let encoder = JSONEncoder()
+                encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+                try encoder.encode(report).write(to: URL(fileURLWithPath: path), options: .atomic)
+            } catch {
+                debugPrint("Failed to write input latency report to \(path). Error: \(error)")
+            }
+            return
+        }
+
+        print("Event to present latency, \(samples.count) events, \(report.unpresentedEvents) never presented")
+
+        report.histograms.forEach { histogram in
+            print("  \(histogram.type): count \(histogram.count), p50 \(format(histogram.p50)) ms, p90 \(format(histogram.p90)) ms, p99 \(format(histogram.p99)) ms, max \(format(histogram.max)) ms")
+
+            let maxCount = histogram.buckets.map { $0.count }.max() ?? 0
+            histogram.buckets.filter { $0.count > 0 }.forEach { bucket in
+                let label = bucket.upperBound.map { "< \(format($0, precision: 0)) ms" } ?? "longer"
+                let bar = String(repeating: "#", count: maxCount > 0 ? max(1, bucket.count * 40 / maxCount) : 0)
+                print("    \(label.padding(toLength: 10, withPad: " ", startingAt: 0)) \(bar) \(bucket.count)")
+            }
+        }
+    }
+
+    private func format(_ value: Double, precision: Int = 2) -> String {
+        String(format: "%.\(precision)f", value)
+    }
+}
+
+fileprivate extension Event.EventType {
+    var latencyCategory: String {
+        switch self {
+            case .keyDown, .keyUp, .flagsChanged: return "keyboard"
+            case .scrollWheel: return "scroll"
+            case .mouseMoved, .leftMouseDragged, .rightMouseDragged, .otherMouseDragged, .mouseEntered, .mouseExited: return "pointer motion"
+            default: return "pointer button"
+        }
+    }
+}
@@ -14,18 +14,31 @@ import CairoGraphics
 #endif
 
 public final class Image {
-    public internal(set) var cgImage: CGImage?
+    public let dataProvider: CGDataProvider
+    public let size: CGSize
     public internal(set) var images: [Image]?
 
-    public var size: CGSize {
-        if let cgImage = cgImage {
-            return CGSize(width: cgImage.width, height: cgImage.height)
-        } else {
-            return .zero
+    // smumriak: full resolution bitmap is decoded lazily only when somebody asks for it. views should prefer decoder with explicit pixel size
+    public internal(set) lazy var cgImage: CGImage? = CGImage(dataProvider: dataProvider)
+
+    internal init?(dataProvider: CGDataProvider) {
+        guard let size = CGImage.pixelSize(of: dataProvider) else {
+            return nil
         }
+
+        self.dataProvider = dataProvider
+        self.size = size
+    }
+
+    public func cachedImage(pixelSize: CGSize) -> CGImage? {
+        return CGImageDecoder.shared.cachedImage(dataProvider: dataProvider, pixelSize: pixelSize)
+    }
+
+    public func decode(pixelSize: CGSize, completion: @escaping (_ image: CGImage?) -> ()) {
+        CGImageDecoder.shared.decode(dataProvider: dataProvider, pixelSize: pixelSize, completion: completion)
     }
 
-    public init?(named name: String, in bundle: Bundle = Bundle.main) {
+    public convenience init?(named name: String, in bundle: Bundle = Bundle.main) {
         let nameCasted = name as NSString
         
         let fileName = nameCasted.deletingPathExtension
@@ -68,25 +81,25 @@ public final class Image {
             return nil
         }
 
-        cgImage = CGImage(dataProvider: dataProvider)
+        self.init(dataProvider: dataProvider)
     }
 
-    public init?(data: Data) {
+    public convenience init?(data: Data) {
         guard let dataProvider = CGDataProvider(data: data) else {
             return nil
         }
 
-        cgImage = CGImage(dataProvider: dataProvider)
+        self.init(dataProvider: dataProvider)
     }
 
-    public init?(contentsOfFile path: String) {
+    public convenience init?(contentsOfFile path: String) {
         let url = URL(fileURLWithPath: path, isDirectory: false)
 
         guard let dataProvider = CGDataProvider(url: url) else {
             return nil
         }
 
-        cgImage = CGImage(dataProvider: dataProvider)
+        self.init(dataProvider: dataProvider)
     }
 }
 
@@ -11,6 +11,8 @@ import TinyFoundation
 @_spi(AppKid) import ContentAnimation
 import Volcano
 
+internal let kBatchedWindowFramesEnabled: Bool = ProcessInfo.processInfo.environment["APPKID_BATCHED_WINDOW_FRAMES"] != nil
+
 internal class RenderScheduler {
     private var syncRenderers: [Int: VolcanoSwapchainRenderer] = [:]
     // private var lastRenderStartedDates: [Int: Date] = [:]
@@ -18,21 +20,37 @@ internal class RenderScheduler {
 
     private var presentationQueues: [Int: Queue] = [:]
     private let renderStack: VolcanoRenderStack
+    private let runLoop: CFRunLoop
     private var observer: CFRunLoopObserver? = nil
+    private var pipelineCompilationObserver: NSObjectProtocol? = nil
 
     internal let submitSemaphore: Volcano.Semaphore
     internal let submitTimelineSemaphore: TimelineSemaphore
+    internal let batchFence: Fence
+    /// Batch fence can be reused only after GPU has finished previous batch
+    internal var isBatchInFlight: Bool = false
     
     deinit {
         if let observer = observer {
             CFRunLoopObserverInvalidate(observer)
         }
+
+        if let pipelineCompilationObserver = pipelineCompilationObserver {
+            NotificationCenter.default.removeObserver(pipelineCompilationObserver)
+        }
     }
 
     init(renderStack: VolcanoRenderStack, runLoop: CFRunLoop) throws {
         self.renderStack = renderStack
+        self.runLoop = runLoop
         submitSemaphore = try Semaphore(device: renderStack.device)
         submitTimelineSemaphore = try TimelineSemaphore(device: renderStack.device, initialValue: 0)
+        #if os(Linux)
+            batchFence = try renderStack.fenceCompletionPort.createFence()
+        #else
+            batchFence = try Fence(device: renderStack.device)
+        #endif
+        try batchFence.reset()
 
         let activity: CFRunLoopActivity = [.beforeWaiting]
         let observer = CFRunLoopObserverCreateWithHandler(kCFAllocatorDefault, activity.rawValue, true, CFIndex.max) { [unowned self] observer, activity in
@@ -42,6 +60,15 @@ internal class RenderScheduler {
         CFRunLoopAddObserver(runLoop, observer, CFRunLoopCommonModesConstant)
 
         self.observer = observer
+
+        pipelineCompilationObserver = NotificationCenter.default.addObserver(forName: .renderPipelineDidCompile, object: nil, queue: nil) { [unowned self] _ in
+            self.requestRender()
+        }
+    }
+
+    /// Makes run loop go through another iteration, so windows are rendered before it goes to sleep again
+    func requestRender() {
+        CFRunLoopWakeUp(runLoop)
     }
 
     func createRenderer(for window: Window) throws {
@@ -68,7 +95,7 @@ internal class RenderScheduler {
 
     func windowWasResized(_ window: Window) {
         let renderer = syncRenderers[window.windowNumber]
-        renderer?.recreateSwapchainOnNextRun = true
+        renderer?.windowWasResized()
     }
 
     func sendRenderRequests() {
@@ -100,6 +127,21 @@ internal class RenderScheduler {
             return
         }
 
+        let profilerEnabled = FrameProfiler.isEnabled
+        if profilerEnabled {
+            FrameProfiler.shared.beginFrame()
+        }
+        defer {
+            if profilerEnabled {
+                FrameProfiler.shared.endFrame()
+            }
+        }
+
+        if kBatchedWindowFramesEnabled && renderesToRecord.count > 1 {
+            try renderBatched(renderesToRecord)
+            return
+        }
+
         try renderesToRecord.forEach { renderer in
             renderer.window?.beforeFrameRender()
             
@@ -108,4 +150,106 @@ internal class RenderScheduler {
             renderer.window?.afterFrameRender()
         }
     }
+
+    /// Renders all windows as one frame: every window acquires its image and records its command buffer, then all command buffers go to GPU with single submit, swapchains are presented with one call per presentation queue and completion of the whole batch is handled once
+    func renderBatched(_ renderers: [VolcanoSwapchainRenderer]) throws {
+        if isBatchInFlight {
+            return
+        }
+
+        var frames: [(renderer: VolcanoSwapchainRenderer, index: Int)] = []
+
+        for renderer in renderers where renderer.isRendering == false {
+            renderer.window?.beforeFrameRender()
+
+            if let index = try renderer.prepareFrame() {
+                frames.append((renderer: renderer, index: index))
+            } else {
+                renderer.window?.afterFrameRender()
+            }
+        }
+
+        if frames.isEmpty {
+            return
+        }
+
+        frames.forEach {
+            $0.renderer.isRendering = true
+        }
+        defer {
+            if isBatchInFlight == false {
+                frames.forEach {
+                    $0.renderer.isRendering = false
+                }
+            }
+        }
+
+        let descriptors = try frames.map {
+            try $0.renderer.makeSubmitDescriptor()
+        }
+
+        try FrameProfiler.scope("Submit", category: .submit) {
+            try renderStack.queues.graphics.submit(with: descriptors, fence: batchFence)
+        }
+
+        frames.forEach {
+            $0.renderer.layerRenderer.didSubmitCommandBuffer()
+        }
+
+        isBatchInFlight = true
+        try renderStack.whenCompleted(batchFence) { [self] in
+            try frames.forEach {
+                try $0.renderer.finishFrame()
+                $0.renderer.isRendering = false
+            }
+            isBatchInFlight = false
+        }
+
+        // smumriak: windows on different screens can end up with different presentation queues. vulkan allows presenting multiple swapchains only on the same queue
+        var presentationGroups: [ObjectIdentifier: [(renderer: VolcanoSwapchainRenderer, index: Int)]] = [:]
+        frames.forEach {
+            presentationGroups[ObjectIdentifier($0.renderer.presentationQueue), default: []].append($0)
+        }
+
+        try FrameProfiler.scope("Present", category: .present) {
+            for group in presentationGroups.values {
+                let presentationQueue = group[0].renderer.presentationQueue
+
+                let results = try presentationQueue.presentReturningResults(swapchains: group.map { $0.renderer.swapchain },
+                                                                            waitSemaphores: group.map { $0.renderer.commandBufferExecutionCompleteSemaphore },
+                                                                            imageIndices: group.map { CUnsignedInt($0.index) })
+
+                try zip(group, results).forEach { frame, result in
+                    try frame.renderer.handlePresentResult(result)
+                }
+            }
+        }
+
+        frames.forEach {
+            $0.renderer.window?.afterFrameRender()
+        }
+    }
+}
+
+internal extension VolcanoRenderStack {
+    /// Calls `completion` once GPU has signaled submitted `fence`. On Linux completion is delivered through completion port on the run loop it is scheduled in, so main thread never blocks on GPU. Fence is reset by the time `completion` is called
+    func whenCompleted(_ fence: Fence, completion: @escaping () throws -> ()) throws {
+        #if os(Linux)
+            try fenceCompletionPort.notify(when: fence) { result in
+                do {
+                    try result.get()
+                    try completion()
+                } catch {
+                    fatalError("Failed to render with error: \(error)")
+                }
+            }
+        #else
+            try FrameProfiler.scope("Fence wait", category: .submit) {
+                try fence.wait()
+            }
+            try fence.reset()
+
+            try completion()
+        #endif
+    }
 }
@@ -6,21 +6,48 @@
 //
 
 import Foundation
-import CairoGraphics
+@_spi(AppKid) import CairoGraphics
+import ContentAnimation
+import CCairo
 
 #if os(macOS)
     import struct CairoGraphics.CGAffineTransform
     import class CairoGraphics.CGContext
 #endif
 
-internal final class SoftwareRenderer {
-    let context: CGContext
+internal let kTiledSoftwareRenderingEnabled: Bool = ProcessInfo.processInfo.environment["APPKID_TILED_SOFTWARE_RENDERING"] != nil
 
-    init(context: CGContext) {
+@_spi(AppKid) public final class SoftwareRenderer {
+    internal struct Tile {
+        /// Area of the window surface covered by the tile, in pixels
+        let rect: CGRect
+        let context: CGContext
+    }
+
+    public let context: CGContext
+
+    /// Size of the tile side in pixels. When set, window is split into tiles, tiles that intersect damage of the frame are rasterized in parallel and then composited into the window context. When nil whole window is rasterized on the calling thread
+    public var tileSize: Int? = kTiledSoftwareRenderingEnabled ? 256 : nil {
+        didSet {
+            tiles = []
+        }
+    }
+
+    internal fileprivate(set) var tiles: [Tile] = []
+    internal fileprivate(set) var redrawnTilesCount: Int = 0
+    fileprivate var tilesPixelSize: (width: Int, height: Int) = (0, 0)
+    fileprivate var damageTracker = DamageTracker()
+
+    public init(context: CGContext) {
         self.context = context
     }
 
     func render(window: Window) {
+        if let tileSize = tileSize {
+            renderTiles(of: window, tileSize: tileSize)
+            return
+        }
+
         CGContext.push(context)
         
         let transform = CGAffineTransform(scaleX: window.nativeWindow.displayScale, y: window.nativeWindow.displayScale)
@@ -30,7 +57,7 @@ internal final class SoftwareRenderer {
         CGContext.pop()
     }
     
-    fileprivate func render(view: View, in context: CGContext, with transform: CGAffineTransform) {
+    fileprivate func render(view: View, in context: CGContext, with transform: CGAffineTransform, visibleRect: CGRect? = nil) {
         context.saveState()
 
         let bounds = view.bounds
@@ -58,12 +85,223 @@ internal final class SoftwareRenderer {
             for subview in view.subviews {
                 let frameInWindowSpace = view.convert(subview.frame, to: window)
                 
-                if frameInWindowSpace.intersects(window.bounds) {
-                    render(view: subview, in: context, with: transform)
+                if frameInWindowSpace.intersects(visibleRect ?? window.bounds) {
+                    render(view: subview, in: context, with: transform, visibleRect: visibleRect)
+                }
+            }
+        }
+
+        context.restoreState()
+    }
+
+    fileprivate func renderTiles(of window: Window, tileSize: Int) {
+        let scale = window.nativeWindow.displayScale
+        let pixelWidth = Int((window.bounds.width * scale).rounded(.up))
+        let pixelHeight = Int((window.bounds.height * scale).rounded(.up))
+
+        if pixelWidth <= 0 || pixelHeight <= 0 {
+            return
+        }
+
+        var damage = collectDamage(in: window)
+
+        if tiles.isEmpty || tilesPixelSize.width != pixelWidth || tilesPixelSize.height != pixelHeight {
+            rebuildTiles(width: pixelWidth, height: pixelHeight, tileSize: tileSize)
+            damage = window.bounds
+        }
+
+        guard let damage = damage else {
+            redrawnTilesCount = 0
+            return
+        }
+
+        let damagedTiles = Self.tiles(tiles, intersecting: damage, scale: scale)
+        redrawnTilesCount = damagedTiles.count
+
+        // smumriak: each tile has it's own surface. text layouts are shared between tiles through TextLayoutCache and pango is not thread safe, so ShapedText serializes all pango drawing. everything else drawn by views goes into tile's own surface in parallel
+        DispatchQueue.concurrentPerform(iterations: damagedTiles.count) { tileIndex in
+            let tile = damagedTiles[tileIndex]
+            let tileContext = tile.context
+
+            tileContext.setIdentityTransform()
+            tileContext.clear(CGRect(origin: .zero, size: tile.rect.size))
+
+            let transform = CGAffineTransform(scaleX: scale, y: scale)
+                .concatenating(CGAffineTransform(translationX: -tile.rect.minX, y: -tile.rect.minY))
+            let visibleRect = tile.rect.applying(CGAffineTransform(scaleX: 1.0 / scale, y: 1.0 / scale))
+
+            render(view: window, in: tileContext, with: transform, visibleRect: visibleRect)
+
+            tileContext.flush()
+        }
+
+        composite(damagedTiles)
+    }
+
+    internal func rebuildTiles(width: Int, height: Int, tileSize: Int) {
+        var tiles: [Tile] = []
+
+        for y in stride(from: 0, to: height, by: tileSize) {
+            for x in stride(from: 0, to: width, by: tileSize) {
+                let tileWidth = min(tileSize, width - x)
+                let tileHeight = min(tileSize, height - y)
+
+                guard let tileContext = CGContext(width: tileWidth, height: tileHeight, bitsPerComponent: 8, bytesPerRow: tileWidth * 4, colorSpace: CGColorSpace(), bitmapInfo: []) else {
+                    fatalError("Error creating context with known arguments")
                 }
+                tileContext.shouldAntialias = context.shouldAntialias
+
+                tiles.append(Tile(rect: CGRect(x: x, y: y, width: tileWidth, height: tileHeight), context: tileContext))
+            }
+        }
+
+        self.tiles = tiles
+        tilesPixelSize = (width, height)
+    }
+
+    /// Tiles that intersect `damage` given in window coordinates
+    internal static func tiles(_ tiles: [Tile], intersecting damage: CGRect, scale: CGFloat) -> [Tile] {
+        let damageInPixels = damage.applying(CGAffineTransform(scaleX: scale, y: scale))
+
+        return tiles.filter { $0.rect.intersects(damageInPixels) }
+    }
+
+    /// Copies redrawn tiles into the window surface in one go, so the window never shows a partially updated frame
+    fileprivate func composite(_ tiles: [Tile]) {
+        if tiles.isEmpty {
+            return
+        }
+
+        let cairoContext = context.context.pointer
+
+        cairo_save(cairoContext)
+        cairo_identity_matrix(cairoContext)
+        cairo_set_operator(cairoContext, CAIRO_OPERATOR_SOURCE)
+
+        for tile in tiles {
+            cairo_set_source_surface(cairoContext, tile.context.surface.pointer, Double(tile.rect.minX), Double(tile.rect.minY))
+            cairo_rectangle(cairoContext, Double(tile.rect.minX), Double(tile.rect.minY), Double(tile.rect.width), Double(tile.rect.height))
+            cairo_fill(cairoContext)
+        }
+
+        cairo_restore(cairoContext)
+
+        context.flush()
+    }
+
+    /// Union of areas that changed since previous frame in window coordinates: rects passed to `setNeedsDisplay(in:)`, old and new frames of views that moved, appeared or were removed. Returns nil if nothing changed
+    fileprivate func collectDamage(in window: Window) -> CGRect? {
+        var windowFrames: [ObjectIdentifier: CGRect] = [:]
+        windowFrames.reserveCapacity(damageTracker.previousWindowFrames.count)
+        var dirtyRects: [CGRect] = []
+
+        func visit(_ view: View) {
+            windowFrames[ObjectIdentifier(view)] = view.convert(view.bounds, to: window)
+
+            if let dirtyRect = view.dirtyRect {
+                dirtyRects.append(view.convert(dirtyRect, to: window))
+                view.dirtyRect = nil
             }
+
+            view.subviews.forEach(visit)
+        }
+
+        visit(window)
+
+        return damageTracker.damage(windowFrames: windowFrames, dirtyRects: dirtyRects, bounds: window.bounds)
+    }
+
+    /// Draws layer tree straight into the context the same way views are drawn: background, delegate drawing, sublayers and border. Corner radius, shadows and layer masks are not supported by this path
+    public func render(layer: CALayer) {
+        CGContext.push(context)
+
+        render(layer: layer, in: context, with: .identity)
+
+        CGContext.pop()
+    }
+
+    fileprivate func render(layer: CALayer, in context: CGContext, with transform: CGAffineTransform) {
+        if layer.isHidden || layer.opacity <= 0.01 {
+            return
+        }
+
+        context.saveState()
+
+        let bounds = layer.bounds
+        let position = layer.position
+        let anchorPoint = layer.anchorPoint
+
+        let transform: CGAffineTransform = .identity
+            .concatenating(CGAffineTransform(translationX: -bounds.minX, y: -bounds.minY))
+            .concatenating(CGAffineTransform(translationX: -bounds.width * anchorPoint.x, y: -bounds.height * anchorPoint.y))
+            .concatenating(layer.transform.affineTransform)
+            .concatenating(CGAffineTransform(translationX: position.x, y: position.y))
+            .concatenating(transform)
+
+        context.ctm = transform
+
+        if layer.masksToBounds {
+            context.addRect(bounds)
+            context.clip()
+        }
+
+        if let backgroundColor = layer.backgroundColor {
+            context.fillColor = backgroundColor
+            context.fill(bounds)
+        }
+
+        layer.draw(in: context)
+
+        layer.sublayers?.forEach {
+            render(layer: $0, in: context, with: transform)
+        }
+
+        if layer.borderWidth > 0, let borderColor = layer.borderColor {
+            context.ctm = transform
+            context.strokeColor = borderColor
+            context.lineWidth = layer.borderWidth
+            context.stroke(bounds.insetBy(dx: layer.borderWidth * 0.5, dy: layer.borderWidth * 0.5))
         }
 
         context.restoreState()
     }
 }
+
+/// Remembers window frames of views between frames, so views that moved, appeared or were removed damage both their old and new areas
+internal struct DamageTracker {
+    internal fileprivate(set) var previousWindowFrames: [ObjectIdentifier: CGRect] = [:]
+
+    /// `windowFrames` has to contain frame of every view that is currently in the window. Returns nil if nothing changed within `bounds`
+    internal mutating func damage(windowFrames: [ObjectIdentifier: CGRect], dirtyRects: [CGRect], bounds: CGRect) -> CGRect? {
+        var damage: CGRect? = nil
+
+        func add(_ rect: CGRect) {
+            damage = damage?.union(rect) ?? rect
+        }
+
+        var removedWindowFrames = previousWindowFrames
+
+        for (identifier, windowFrame) in windowFrames {
+            let previousWindowFrame = removedWindowFrames.removeValue(forKey: identifier)
+
+            if previousWindowFrame != windowFrame {
+                add(windowFrame)
+                if let previousWindowFrame = previousWindowFrame {
+                    add(previousWindowFrame)
+                }
+            }
+        }
+
+        dirtyRects.forEach(add)
+
+        // smumriak: whatever is left belongs to views that are not in the window anymore
+        removedWindowFrames.values.forEach(add)
+        previousWindowFrames = windowFrames
+
+        guard let result = damage?.intersection(bounds), result.isNull == false, result.isEmpty == false else {
+            return nil
+        }
+
+        return result
+    }
+}
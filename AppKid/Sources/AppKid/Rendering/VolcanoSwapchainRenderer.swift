@@ -6,12 +6,13 @@
 //
 
 internal let kMultisamplingEnabled: Bool = ProcessInfo.processInfo.environment["APPKID_MULTISAMPLED_RENDERING"] != nil
+internal let kVideoMemoryReportEnabled: Bool = ProcessInfo.processInfo.environment["APPKID_VRAM_REPORT"] != nil
 
 import Foundation
 import CoreFoundation
 import TinyFoundation
 @_spi(AppKid) import ContentAnimation
-import Volcano
+@_spi(AppKid) import Volcano
 
 public enum VolcanoSwapchainRendererError: Error {
     case noPresentationQueueFound
@@ -47,7 +48,8 @@ internal class VolcanoSwapchainRenderer {
     internal let timelineSemaphore: TimelineSemaphore
 
     internal var device: Device { renderStack.device }
-    internal var aliasingTextures: [Texture] = []
+    /// Single multisampled attachment that render targets of all swapchain images render into and resolve from. Frames of one window never overlap on GPU, so one is enough
+    internal var multisampledTexture: Texture?
     internal var swapchainTextures: [Texture] = []
 
     @Synchronized internal var state: State = .idle
@@ -78,7 +80,11 @@ internal class VolcanoSwapchainRenderer {
         layerRenderer = try VolcanoRenderer(pixelFormat: surface.imageFormat, commandPool: commandPool)
         layerRenderer.layer = window.layer
 
-        fence = try Fence(device: device)
+        #if os(Linux)
+            fence = try renderStack.fenceCompletionPort.createFence()
+        #else
+            fence = try Fence(device: device)
+        #endif
         try fence.reset()
         
         timelineSemaphore = try TimelineSemaphore(device: device, initialValue: 0)
@@ -86,14 +92,22 @@ internal class VolcanoSwapchainRenderer {
         try setupSwapchain()
     }
 
-    func setupSwapchain() throws {
+    /// Size of window in pixels
+    var desiredSwapchainSize: VkExtent2D? {
         guard let window = window else {
-            return
+            return nil
         }
 
         let windowSize = window.bounds.size
         let displayScale = window.nativeWindow.displayScale
-        let desiredSize = VkExtent2D(width: UInt32(windowSize.width * displayScale), height: UInt32(windowSize.height * displayScale))
+
+        return VkExtent2D(width: UInt32(windowSize.width * displayScale), height: UInt32(windowSize.height * displayScale))
+    }
+
+    func setupSwapchain() throws {
+        guard let desiredSize = desiredSwapchainSize else {
+            return
+        }
         
         try surface.refreshCapabilities()
         let capabilities = surface.capabilities
@@ -111,23 +125,52 @@ internal class VolcanoSwapchainRenderer {
 
         swapchainTextures = try swapchain.createTextures()
 
-        let textureDescriptor = TextureDescriptor.texture2DDescriptor(pixelFormat: swapchain.imageFormat, width: Int(swapchain.size.width), height: Int(swapchain.size.height), mipmapped: false)
-        textureDescriptor.usage = [.renderTarget, .shaderRead]
-        textureDescriptor.tiling = .optimal
-        textureDescriptor.setAccessQueues([renderStack.queues.graphics, renderStack.queues.transfer])
         if kMultisamplingEnabled {
-            textureDescriptor.sampleCount = .four
-        } else {
-            textureDescriptor.sampleCount = .one
-        }
-        
-        if kMultisamplingEnabled {
-            aliasingTextures = try swapchainTextures.map { _ in
-                try device.createTexture(with: textureDescriptor)
+            let width = Int(swapchain.size.width)
+            let height = Int(swapchain.size.height)
+
+            if let multisampledTexture = multisampledTexture, multisampledTexture.width == width, multisampledTexture.height == height, multisampledTexture.pixelFormat == swapchain.imageFormat {
+                // smumriak: swapchain was recreated with the same size, i.e. after suboptimal present. attachment is still good
+            } else {
+                // smumriak: contents of multisampled attachment are only resolved and never stored, so it's transient and lives in tile memory on GPUs that have lazily allocated memory
+                let textureDescriptor = TextureDescriptor.texture2DDescriptor(pixelFormat: swapchain.imageFormat, width: width, height: height, mipmapped: false)
+                textureDescriptor.usage = [.transientAttachment]
+                textureDescriptor.tiling = .optimal
+                textureDescriptor.sampleCount = .four
+                textureDescriptor.preferredMemoryProperties = .lazilyAllocated
+                textureDescriptor.setAccessQueues([renderStack.queues.graphics])
+
+                multisampledTexture = nil
+                multisampledTexture = try device.createTexture(with: textureDescriptor)
             }
+        } else {
+            multisampledTexture = nil
         }
 
         oldSwapchain = nil
+
+        if kVideoMemoryReportEnabled {
+            reportVideoMemoryUsage()
+        }
+    }
+
+    func reportVideoMemoryUsage() {
+        let mebibyte = Double(1 << 20)
+        // smumriak: swapchain images are owned by presentation engine, their size is an estimate for 32 bit formats
+        let imageSize = Double(swapchain.size.width) * Double(swapchain.size.height) * 4
+        let swapchainSize = imageSize * Double(swapchainTextures.count)
+
+        var report = "Window \(window?.windowNumber ?? 0) video memory at \(swapchain.size.width)x\(swapchain.size.height): \(swapchainTextures.count) swapchain images \(String(format: "%.1f", swapchainSize / mebibyte)) MiB"
+
+        if let multisampledTexture = multisampledTexture {
+            let multisampledSize = Double(multisampledTexture.allocatedMemorySize)
+            let perImageSize = imageSize * 4 * Double(swapchainTextures.count)
+            let lazily = multisampledTexture.isLazilyAllocated ? ", lazily allocated" : ""
+
+            report += ", shared multisampled attachment \(String(format: "%.1f", multisampledSize / mebibyte)) MiB\(lazily) (\(String(format: "%.1f", perImageSize / mebibyte)) MiB with multisampled attachment per swapchain image)"
+        }
+
+        print(report)
     }
     
     func clearSwapchain() throws {
@@ -149,8 +192,46 @@ internal class VolcanoSwapchainRenderer {
         }
 
         isRendering = true
-        defer { isRendering = false }
+        // smumriak: renderer stays busy until GPU finishes the frame, which on Linux is reported asynchronously by completion port
+        var isFrameInFlight = false
+        defer {
+            if isFrameInFlight == false {
+                isRendering = false
+            }
+        }
+
+        guard let index = try prepareFrame() else {
+            return
+        }
+
+        do {
+            try layerRenderer.submitCommandBuffer(waitSemaphores: [textureReadySemaphore], signalSemaphores: [commandBufferExecutionCompleteSemaphore], fence: fence)
+
+            isFrameInFlight = true
+            try renderStack.whenCompleted(fence) { [self] in
+                try finishFrame()
+                isRendering = false
+            }
 
+            try FrameProfiler.scope("Present", category: .present) {
+                try presentationQueue.present(swapchains: [swapchain], waitSemaphores: [commandBufferExecutionCompleteSemaphore], imageIndices: [CUnsignedInt(index)])
+            }
+
+            didPresentFrame()
+        } catch VulkanError.badResult(let errorCode) {
+            if errorCode == .errorOutOfDateKhr || errorCode == .suboptimalKhr {
+                recreateSwapchainOnNextRun = true
+            } else {
+                throw VulkanError.badResult(errorCode)
+            }
+        }
+    }
+
+    /// Acquires next swapchain image and records command buffer that renders into it. Returns index of acquired image or nil if the frame has to be skipped
+    func prepareFrame() throws -> Int? {
+        layerRenderer.isInLiveResize = window?.inLiveResize ?? false
+
+        // smumriak: any number of resize events between two frames results in at most one swapchain recreation here. old swapchain is handed to the new one so presentation engine can reuse its resources
         if recreateSwapchainOnNextRun {
             recreateSwapchainOnNextRun = false
             
@@ -176,7 +257,7 @@ internal class VolcanoSwapchainRenderer {
                 if errorCode == .errorOutOfDateKhr || errorCode == .suboptimalKhr {
                     if skipRecreation == true {
                         recreateSwapchainOnNextRun = true
-                        return
+                        return nil
                     }
 
                     try clearSwapchain()
@@ -190,36 +271,88 @@ internal class VolcanoSwapchainRenderer {
         }
 
         guard let index = index, let swapchainTexture = swapchainTexture else {
-            return
+            return nil
         }
 
         do {
-            if kMultisamplingEnabled {
-                let aliasingTexture = aliasingTextures[index]
-                try layerRenderer.setDestination(target: aliasingTexture, resolve: swapchainTexture)
+            if let multisampledTexture = multisampledTexture {
+                try layerRenderer.setDestination(target: multisampledTexture, resolve: swapchainTexture)
             } else {
                 try layerRenderer.setDestination(target: swapchainTexture)
             }
 
-            try layerRenderer.beginFrame(atTime: 0)
+            if let window = window {
+                InputLatencyTracker.shared?.frameWillRender(windowNumber: window.windowNumber)
+            }
 
-            try layerRenderer.render(waitSemaphores: [textureReadySemaphore], signalSemaphores: [commandBufferExecutionCompleteSemaphore], fence: fence)
+            try layerRenderer.beginFrame(atTime: 0)
 
-            try fence.wait()
-            try fence.reset()
+            try layerRenderer.buildRenderOperations()
 
-            try presentationQueue.present(swapchains: [swapchain], waitSemaphores: [commandBufferExecutionCompleteSemaphore], imageIndices: [CUnsignedInt(index)])
+            try layerRenderer.performRenderOperations()
 
-            try layerRenderer.endFrame()
+            return index
         } catch VulkanError.badResult(let errorCode) {
             if errorCode == .errorOutOfDateKhr || errorCode == .suboptimalKhr {
                 recreateSwapchainOnNextRun = true
+                return nil
             } else {
                 throw VulkanError.badResult(errorCode)
             }
         }
     }
 
+    /// Submission of the prepared frame that waits for acquired image and signals presentation semaphore
+    func makeSubmitDescriptor() throws -> SubmitDescriptor {
+        try layerRenderer.makeSubmitDescriptor(waitSemaphores: [textureReadySemaphore], signalSemaphores: [commandBufferExecutionCompleteSemaphore])
+    }
+
+    func handlePresentResult(_ result: VkResult) throws {
+        switch result {
+            case .success:
+                didPresentFrame()
+
+            case .suboptimalKhr:
+                didPresentFrame()
+                recreateSwapchainOnNextRun = true
+
+            case .errorOutOfDateKhr:
+                recreateSwapchainOnNextRun = true
+
+            default:
+                throw VulkanError.badResult(result)
+        }
+    }
+
+    /// Swapchain is recreated on next frame only if window's size in pixels differs from swapchain's, i.e. configuration changes that only move the window are ignored
+    func windowWasResized() {
+        guard let swapchain = swapchain, let desiredSize = desiredSwapchainSize else {
+            recreateSwapchainOnNextRun = true
+            return
+        }
+
+        if swapchain.size.width != desiredSize.width || swapchain.size.height != desiredSize.height {
+            recreateSwapchainOnNextRun = true
+        }
+    }
+
+    func didPresentFrame() {
+        if let window = window {
+            InputLatencyTracker.shared?.framePresented(windowNumber: window.windowNumber)
+        }
+
+        StartupTrace.shared?.firstFramePresented()
+    }
+
+    /// Has to be called only after GPU has finished executing the frame
+    func finishFrame() throws {
+        if FrameProfiler.isEnabled {
+            try layerRenderer.resolveGPUTimestamps()
+        }
+
+        try layerRenderer.endFrame()
+    }
+
     internal func resetState(to state: State = .idle) {
         self.state = state
     }
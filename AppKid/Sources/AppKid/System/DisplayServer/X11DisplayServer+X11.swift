@@ -132,6 +132,8 @@ internal extension X11DisplayServer {
                     break
             }
 
+            application.eventRecorder?.record(event, in: application)
+
             application.post(event: event, atStart: false)
         }
     }
@@ -10,13 +10,36 @@ import TinyFoundation
 import CairoGraphics
 import ContentAnimation
 
+#if os(macOS)
+    import class CairoGraphics.CGImage
+#endif
+
 public class ImageView: View, CALayerDisplayDelegate {
     public var image: Image? {
         didSet {
+            if image !== oldValue {
+                decodedImage = nil
+                decodedPixelSize = .zero
+            }
+
             setNeedsDisplay()
         }
     }
 
+    internal var decodedImage: CGImage? = nil
+    internal var decodedPixelSize: CGSize = .zero
+
+    // smumriak: image is decoded only at the size it is going to be displayed at, never bigger than it's natural size
+    internal var targetPixelSize: CGSize {
+        let pixelSize = CGSize(width: bounds.width * contentScaleFactor, height: bounds.height * contentScaleFactor)
+
+        if pixelSize.width <= 0 || pixelSize.height <= 0 {
+            return image?.size ?? .zero
+        } else {
+            return pixelSize
+        }
+    }
+
     public init(image: Image?) {
         var frame: CGRect = .zero
 
@@ -30,9 +53,49 @@ public class ImageView: View, CALayerDisplayDelegate {
         setNeedsDisplay()
     }
 
+    public override func layoutSubviews() {
+        super.layoutSubviews()
+
+        if image != nil && targetPixelSize != decodedPixelSize {
+            setNeedsDisplay()
+        }
+    }
+
     // MARK: CALayerDisplayDelegate
 
     public func display(_ layer: CALayer) {
-        layer.contents = image?.cgImage
+        guard let image = image else {
+            layer.contents = nil
+            return
+        }
+
+        let pixelSize = targetPixelSize
+
+        // smumriak: vulkan renderer decodes data provider contents on background queue straight into staging memory at layer's pixel size, decoded bitmap is only needed for software rendering
+        if isVolcanoRenderingEnabled {
+            decodedPixelSize = pixelSize
+            layer.contents = image.dataProvider
+            return
+        }
+
+        if decodedImage == nil || decodedPixelSize != pixelSize {
+            if let cachedImage = image.cachedImage(pixelSize: pixelSize) {
+                decodedImage = cachedImage
+                decodedPixelSize = pixelSize
+            } else {
+                // smumriak: previously decoded image stays on screen until new one arrives
+                image.decode(pixelSize: pixelSize) { [weak self] result in
+                    guard let self = self, self.image === image, let result = result else {
+                        return
+                    }
+
+                    self.decodedImage = result
+                    self.decodedPixelSize = pixelSize
+                    self.setNeedsDisplay()
+                }
+            }
+        }
+
+        layer.contents = decodedImage
     }
 }
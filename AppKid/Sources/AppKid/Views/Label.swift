@@ -8,13 +8,15 @@
 import Foundation
 import CoreFoundation
 @_spi(AppKid) import CairoGraphics
-import ContentAnimation
+@_spi(AppKid) import ContentAnimation
 
 #if os(macOS)
     import struct CairoGraphics.CGColor
     import class CairoGraphics.CGContext
 #endif
 
+internal let kGlyphAtlasTextEnabled: Bool = ProcessInfo.processInfo.environment["APPKID_GLYPH_ATLAS_TEXT"] != nil
+
 public enum TextAlignment: Int {
     case left
     case right
@@ -48,9 +50,9 @@ open class Label: View {
     open var textAlignment: TextAlignment = .center {
         didSet {
             switch textAlignment {
-                case .left: layout.layout.alignment = .left
-                case .center: layout.layout.alignment = .center
-                case .right: layout.layout.alignment = .right
+                case .left: layout.alignment = .left
+                case .center: layout.alignment = .center
+                case .right: layout.alignment = .right
             }
         }
     }
@@ -67,7 +69,7 @@ open class Label: View {
         layout.text = text
         layout.textColor = textColor
         layout.font = font
-        layout.layout.alignment = .center
+        layout.alignment = .center
     }
 
     open override var frame: CGRect {
@@ -106,3 +108,19 @@ open class Label: View {
         layout.render(in: context, rect: textRect)
     }
 }
+
+extension Label: CALayerDisplayDelegate {
+    public func display(_ layer: CALayer) {
+        guard kGlyphAtlasTextEnabled else {
+            layer.displayIntoBackingStore()
+            return
+        }
+
+        // smumriak: renderer draws text with quads from shared glyph atlas, so changing text does not redraw and upload backing store
+        let textRect = self.textRect(for: bounds, limitedToNumberOfLines: 0)
+
+        layer.textContents = layout.shapedText(in: textRect, scale: layer.contentsScale).map {
+            CATextContents(shapedText: $0.shapedText, origin: $0.origin, color: textColor)
+        }
+    }
+}
@@ -24,6 +24,29 @@ open class ScrollView: View {
         }
         set {
             bounds.origin = newValue
+
+            updateTiledContent()
+        }
+    }
+
+    open override func layoutSubviews() {
+        super.layoutSubviews()
+
+        updateTiledContent()
+    }
+
+    open override func didAddSubview(_ subview: View) {
+        super.didAddSubview(subview)
+
+        updateTiledContent()
+    }
+
+    /// Tells tiled subviews which part of them is visible, so they draw only tiles that are on screen or about to be. Scrolling itself never redraws anything, tiles are moved together with scroll view's bounds
+    internal func updateTiledContent() {
+        for case let tiledView as TiledView in subviews {
+            let visibleRect = convert(bounds, to: tiledView).intersection(tiledView.bounds)
+
+            tiledView.tiledLayer.setVisibleRect(visibleRect)
         }
     }
 
@@ -0,0 +1,57 @@
+//
+//  TiledView.swift
+//  AppKid
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import CairoGraphics
+import ContentAnimation
+
+#if os(macOS)
+    import class CairoGraphics.CGContext
+#endif
+
+/// View backed by `CATiledLayer`. Meant to be the content of `ScrollView` that is much bigger than the screen: only tiles around the visible part are drawn, on background threads, and scrolling moves already drawn tiles
+/// - Note: `drawContents(in:)` is called on background threads
+open class TiledView: View {
+    public var tiledLayer: CATiledLayer {
+        return layer as! CATiledLayer
+    }
+
+    public override init(frame: CGRect) {
+        super.init(frame: frame)
+
+        // smumriak: view creates plain layer in its initializer, tiled view replaces it before view gets into any hierarchy
+        let tiledLayer = CATiledLayer()
+        tiledLayer.bounds = layer.bounds
+        tiledLayer.position = layer.position
+        tiledLayer.backgroundColor = layer.backgroundColor
+        tiledLayer.masksToBounds = layer.masksToBounds
+        tiledLayer.delegate = self
+
+        layer = tiledLayer
+    }
+
+    /// Draws contents of the view. Context is clipped to one tile, but coordinates are the coordinates of view's bounds
+    open func drawContents(in context: CGContext) {
+    }
+
+    open override func setNeedsDisplay(in rect: CGRect) {
+        dirtyRect = dirtyRect?.union(rect) ?? rect
+        tiledLayer.setNeedsDisplay(in: rect)
+    }
+
+    // MARK: - Rendering
+
+    open override func render(in context: CGContext) {
+        super.render(in: context)
+
+        drawContents(in: context)
+    }
+
+    public override func draw(_ layer: CALayer, in context: CGContext) {
+        drawContents(in: context)
+    }
+}
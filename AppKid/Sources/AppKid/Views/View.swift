@@ -154,6 +154,9 @@ open class View: Responder, CALayerActionDelegate {
         }
         set {
             layer.backgroundColor = newValue
+
+            // smumriak: background is drawn from layer property on GPU, so layer contents stay valid. only software renderer needs to know the area changed
+            dirtyRect = bounds
         }
     }
     
@@ -13,6 +13,8 @@ import CairoGraphics
 // smumriak: Start from 1
 internal var globalWindowCounter: Int = 1
 
+internal let kLiveResizeEnabled: Bool = ProcessInfo.processInfo.environment["APPKID_LIVE_RESIZE"] != nil
+
 #if os(macOS)
     import struct CairoGraphics.CGAffineTransform
 #endif
@@ -20,6 +22,8 @@ internal var globalWindowCounter: Int = 1
 public extension Notification.Name {
     static let windowDidExpose = Notification.Name(rawValue: "windowDidExpose")
     static let windowDidResize = Notification.Name(rawValue: "windowDidResize")
+    static let windowWillStartLiveResize = Notification.Name(rawValue: "windowWillStartLiveResize")
+    static let windowDidEndLiveResize = Notification.Name(rawValue: "windowDidEndLiveResize")
 
     static let windowDidReceiveSyncRequest = Notification.Name(rawValue: "windowDidReceiveSyncRequest") // XSync requests
 }
@@ -154,6 +158,12 @@ open class Window: View {
 
     internal var isMapped: Bool = false
 
+    /// True while window is resized interactively. Live resize ends once window size did not change for `liveResizeEndDelay`
+    public internal(set) var inLiveResize: Bool = false
+
+    internal static let liveResizeEndDelay: TimeInterval = 0.15
+    fileprivate var liveResizeEndTimer: Timer? = nil
+
     internal func updateSurface() {
         if !isVolcanoRenderingEnabled {
             _graphicsContext?.updateSurface()
@@ -166,11 +176,55 @@ open class Window: View {
         bounds.size = currentRect.size
         center = CGPoint(x: bounds.midX, y: bounds.midY)
 
+        // smumriak: during live resize root view keeps the size it had when resize started and is stretched to fill the window. nothing is laid out or redrawn until resize ends
+        if inLiveResize, let rootView = rootViewController?.view, rootView.bounds.width > 0, rootView.bounds.height > 0 {
+            rootView.transform = CGAffineTransform(scaleX: bounds.width / rootView.bounds.width, y: bounds.height / rootView.bounds.height)
+            rootView.center = center
+            return
+        }
+
         rootViewController?.view.frame = bounds
         rootViewController?.view.setNeedsLayout()
         rootViewController?.view.layoutIfNeeded()
     }
 
+    internal func liveResizeDidChangeSize() {
+        if inLiveResize {
+            liveResizeEndTimer?.fireDate = Date(timeIntervalSinceNow: Self.liveResizeEndDelay)
+            return
+        }
+
+        NotificationCenter.default.post(name: .windowWillStartLiveResize, object: self)
+
+        inLiveResize = true
+
+        let timer = Timer(timeInterval: Self.liveResizeEndDelay, repeats: false) { [weak self] _ in
+            self?.endLiveResize()
+        }
+        RunLoop.current.add(timer, forMode: .common)
+
+        liveResizeEndTimer = timer
+    }
+
+    internal func endLiveResize() {
+        guard inLiveResize else {
+            return
+        }
+
+        liveResizeEndTimer?.invalidate()
+        liveResizeEndTimer = nil
+
+        inLiveResize = false
+
+        rootViewController?.view.transform = .identity
+
+        if isMapped {
+            updateSurface()
+        }
+
+        NotificationCenter.default.post(name: .windowDidEndLiveResize, object: self)
+    }
+
     internal func createRenderer() -> SoftwareRenderer {
         if isVolcanoRenderingEnabled {
             fatalError("Vulkan renderer is enabled")
@@ -387,6 +441,10 @@ fileprivate extension Window {
 
                 if sizeChanged {
                     if isMapped {
+                        if kLiveResizeEnabled {
+                            liveResizeDidChangeSize()
+                        }
+
                         updateSurface()
                     }
                 }
@@ -0,0 +1,61 @@
+//
+//  SoftwareRendererTests.swift
+//  AppKid
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import AppKid
+@_spi(AppKid) import CairoGraphics
+
+final class SoftwareRendererTests: XCTestCase {
+    func testDamageOfChangedViews() {
+        let bounds = CGRect(x: 0, y: 0, width: 1000, height: 1000)
+        let first = NSObject()
+        let second = NSObject()
+        var tracker = DamageTracker()
+
+        let firstFrame = CGRect(x: 10, y: 10, width: 100, height: 100)
+        let secondFrame = CGRect(x: 500, y: 500, width: 50, height: 50)
+        var windowFrames = [ObjectIdentifier(first): firstFrame, ObjectIdentifier(second): secondFrame]
+
+        // smumriak: everything is new on the first frame
+        XCTAssertEqual(tracker.damage(windowFrames: windowFrames, dirtyRects: [], bounds: bounds), firstFrame.union(secondFrame))
+
+        XCTAssertNil(tracker.damage(windowFrames: windowFrames, dirtyRects: [], bounds: bounds))
+
+        let dirtyRect = CGRect(x: 20, y: 20, width: 10, height: 10)
+        XCTAssertEqual(tracker.damage(windowFrames: windowFrames, dirtyRects: [dirtyRect], bounds: bounds), dirtyRect)
+
+        let movedFrame = firstFrame.offsetBy(dx: 200, dy: 0)
+        windowFrames[ObjectIdentifier(first)] = movedFrame
+        XCTAssertEqual(tracker.damage(windowFrames: windowFrames, dirtyRects: [], bounds: bounds), firstFrame.union(movedFrame))
+
+        windowFrames.removeValue(forKey: ObjectIdentifier(second))
+        XCTAssertEqual(tracker.damage(windowFrames: windowFrames, dirtyRects: [], bounds: bounds), secondFrame)
+
+        XCTAssertNil(tracker.damage(windowFrames: windowFrames, dirtyRects: [CGRect(x: 2000, y: 2000, width: 10, height: 10)], bounds: bounds))
+    }
+
+    func testOnlyDamagedTilesAreSelected() throws {
+        let context = try XCTUnwrap(CGContext(width: 600, height: 300, bitsPerComponent: 8, bytesPerRow: 600 * 4, colorSpace: CGColorSpace(), bitmapInfo: []))
+        let renderer = SoftwareRenderer(context: context)
+
+        renderer.rebuildTiles(width: 600, height: 300, tileSize: 256)
+
+        XCTAssertEqual(renderer.tiles.count, 6)
+        XCTAssertEqual(renderer.tiles.last?.rect, CGRect(x: 512, y: 256, width: 88, height: 44))
+
+        // smumriak: damage is in window coordinates, tiles are in pixels
+        let insideFirstTile = SoftwareRenderer.tiles(renderer.tiles, intersecting: CGRect(x: 10, y: 10, width: 20, height: 20), scale: 2.0)
+        XCTAssertEqual(insideFirstTile.map { $0.rect }, [CGRect(x: 0, y: 0, width: 256, height: 256)])
+
+        let acrossColumns = SoftwareRenderer.tiles(renderer.tiles, intersecting: CGRect(x: 120, y: 10, width: 20, height: 20), scale: 2.0)
+        XCTAssertEqual(acrossColumns.map { $0.rect }, [CGRect(x: 0, y: 0, width: 256, height: 256), CGRect(x: 256, y: 0, width: 256, height: 256)])
+
+        let everything = SoftwareRenderer.tiles(renderer.tiles, intersecting: CGRect(x: 0, y: 0, width: 300, height: 150), scale: 2.0)
+        XCTAssertEqual(everything.count, 6)
+    }
+}
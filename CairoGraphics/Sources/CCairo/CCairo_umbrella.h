@@ -14,6 +14,7 @@ struct _cairo {};
 struct _cairo_surface {};
 struct _cairo_pattern {};
 struct _cairo_font_options {};
+struct _cairo_scaled_font {};
 
 #include <cairo.h>
 #if defined(__linux__)
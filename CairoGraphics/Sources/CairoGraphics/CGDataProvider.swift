@@ -98,13 +98,59 @@ public class CGDataProvider {
         info = nil
     }
 
+    // smumriak: stable identifier of the underlying source for caching purposes. only providers backed by files have one
+    public var sourceIdentifier: String? {
+        switch providerType {
+            case .url(let url): return url.standardizedFileURL.absoluteString
+            case .filename(let filename): return URL(fileURLWithPath: filename).standardizedFileURL.absoluteString
+            default: return nil
+        }
+    }
+
     public var data: Data? {
         switch providerType {
             case .directData(let data, let size, _): return Data(bytes: data, count: size)
             case .data(let data): return data
-            case .url(let url): return try? Data(contentsOf: url)
-            case .filename(let filename): return FileManager.default.contents(atPath: filename)
+            case .url(let url):
+                if url.isFileURL {
+                    return Self.mappedData(path: url.path)
+                } else {
+                    return try? Data(contentsOf: url)
+                }
+
+            case .filename(let filename): return Self.mappedData(path: filename)
             default: fatalError("NOT YET IMPLEMENTED")
         }
     }
 }
+
+internal extension CGDataProvider {
+    // smumriak: file backed providers map the file instead of reading it. pages are unmapped as soon as returned data is released, so encoded bytes never outlive decoding
+    static func mappedData(path: String) -> Data? {
+        let fileDescriptor = open(path, O_RDONLY | O_CLOEXEC)
+
+        if fileDescriptor < 0 {
+            return nil
+        }
+
+        defer {
+            close(fileDescriptor)
+        }
+
+        var fileStat = stat()
+
+        if fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size <= 0 {
+            return nil
+        }
+
+        let size = Int(fileStat.st_size)
+
+        guard let address = mmap(nil, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0), address != UnsafeMutableRawPointer(bitPattern: -1) else {
+            return FileManager.default.contents(atPath: path)
+        }
+
+        return Data(bytesNoCopy: address, count: size, deallocator: .custom { pointer, size in
+            munmap(pointer, size)
+        })
+    }
+}
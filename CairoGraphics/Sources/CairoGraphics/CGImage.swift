@@ -9,6 +9,7 @@ import Foundation
 import CoreFoundation
 import TinyFoundation
 import STBImageRead
+import STBImageResize
 
 enum ImageFormat: CaseIterable {
     case png
@@ -26,6 +27,16 @@ enum ImageFormat: CaseIterable {
     static var maxHeaderSize: Int = Array<ImageFormat>(arrayLiteral: .png, .jpeg, .gif)
         .map { $0.header.count }
         .reduce(0) { max($0, $1) }
+
+    static func isSupported(data: Data) -> Bool {
+        guard data.count >= maxHeaderSize else {
+            return false
+        }
+
+        let header = data.prefix(maxHeaderSize).map { $0 }
+
+        return allCases.contains { header.starts(with: $0.header) }
+    }
 }
 
 public final class CGImage {
@@ -47,36 +58,154 @@ public final class CGImage {
         }
     }
 
-    public init?(dataProvider: CGDataProvider) {
-        guard let data = dataProvider.data else {
+    public convenience init?(dataProvider: CGDataProvider) {
+        self.init(dataProvider: dataProvider, pixelSize: nil)
+    }
+
+    /// Decodes image from data provider
+    /// - Parameters:
+    ///     - `dataProvider`: source of encoded PNG, JPEG or GIF data
+    ///     - `pixelSize`: desired pixel size of resulting bitmap. Image is downsampled preserving aspect ratio so it covers the requested size, it is never upscaled. `nil` means full resolution
+    public init?(dataProvider: CGDataProvider, pixelSize: CGSize?) {
+        // smumriak: encoded data is released right after this scope, for file backed providers it means the file gets unmapped
+        guard let data = dataProvider.data, let decoded = CGImage.loadPixels(from: data) else {
             return nil
         }
 
-        let headerSize = ImageFormat.maxHeaderSize
-        let header = data[0..<headerSize].map { $0 }
+        var pixelData = decoded.pixels
+        var width = decoded.width
+        var height = decoded.height
+        let channels = CGImage.decodedChannels
+
+        if let pixelSize = pixelSize {
+            let (targetWidth, targetHeight) = CGImage.downsampledSize(width: width, height: height, fitting: pixelSize)
+
+            if targetWidth != width || targetHeight != height {
+                let resizedPixelData = UnsafeMutablePointer<stbi_uc>.allocate(capacity: targetWidth * targetHeight * channels)
 
-        if header.starts(with: ImageFormat.jpeg.header) || header.starts(with: ImageFormat.png.header) || header.starts(with: ImageFormat.gif.header) {
-            var width: Int32 = 0
-            var height: Int32 = 0
-            var bitsPerPixel: Int32 = 0
+                let result = CGImage.resizePixels(pixelData, width: width, height: height, into: resizedPixelData, targetWidth: targetWidth, targetHeight: targetHeight)
 
-            let pixelData: UnsafeMutablePointer<stbi_uc> = data.withUnsafeBytes { pngData in
-                let boundData = pngData.bindMemory(to: stbi_uc.self)
-                return stbi_load_from_memory(boundData.baseAddress!, Int32(pngData.count), &width, &height, &bitsPerPixel, 4)
+                // smumriak: full resolution bitmap is never kept around when downsampling
+                stbi_image_free(pixelData)
+
+                if result == false {
+                    resizedPixelData.deallocate()
+                    return nil
+                }
+
+                pixelData = resizedPixelData
+                width = targetWidth
+                height = targetHeight
             }
+        }
+
+        self.isMask = false
+        self.width = width
+        self.height = height
+        self.bitsPerComponent = 8
+        self.bitsPerPixel = bitsPerComponent * channels
+        self.bytesPerRow = width * channels
 
-            self.isMask = false
-            self.width = Int(width)
-            self.height = Int(height)
-            self.bitsPerComponent = 8
-            self.bitsPerPixel = Int(bitsPerPixel)
-            self.bytesPerRow = Int(width) * Int(bitsPerPixel)
+        self.bitmap = UnsafeMutableRawBufferPointer(start: UnsafeMutableRawPointer(pixelData), count: bytesPerRow * height)
+        self.dataProvider = dataProvider
+    }
+
+    /// Decodes image straight into memory supplied by the caller, i.e. mapped staging buffer, without creating intermediate `CGImage`. Pixels are written as tightly packed RGBA
+    /// - Parameters:
+    ///     - `dataProvider`: source of encoded PNG, JPEG or GIF data
+    ///     - `pixelSize`: desired pixel size, same semantics as in `init?(dataProvider:pixelSize:)`
+    ///     - `destination`: called once final dimensions are known, has to return memory of at least `bytesPerRow * height` bytes
+    /// - Returns: dimensions of decoded image or `nil` if data could not be decoded
+    public static func decode(dataProvider: CGDataProvider, pixelSize: CGSize?, into destination: (_ width: Int, _ height: Int, _ bytesPerRow: Int) throws -> UnsafeMutableRawPointer) rethrows -> (width: Int, height: Int)? {
+        guard let data = dataProvider.data, let decoded = loadPixels(from: data) else {
+            return nil
+        }
 
-            self.bitmap = UnsafeMutableRawBufferPointer(start: UnsafeMutableRawPointer(pixelData), count: self.width)
-            self.dataProvider = dataProvider
+        let pixelData = decoded.pixels
+        let width = decoded.width
+        let height = decoded.height
+
+        defer {
+            stbi_image_free(pixelData)
+        }
+
+        let (targetWidth, targetHeight) = pixelSize.map { downsampledSize(width: width, height: height, fitting: $0) } ?? (width, height)
+        let bytesPerRow = targetWidth * decodedChannels
+
+        let destinationPixelData = try destination(targetWidth, targetHeight, bytesPerRow)
+
+        if targetWidth != width || targetHeight != height {
+            let result = resizePixels(pixelData, width: width, height: height, into: destinationPixelData.assumingMemoryBound(to: stbi_uc.self), targetWidth: targetWidth, targetHeight: targetHeight)
+
+            if result == false {
+                return nil
+            }
         } else {
+            destinationPixelData.copyMemory(from: pixelData, byteCount: bytesPerRow * targetHeight)
+        }
+
+        return (targetWidth, targetHeight)
+    }
+
+    /// Reads dimensions of encoded image without decoding pixels
+    public static func pixelSize(of dataProvider: CGDataProvider) -> CGSize? {
+        guard let data = dataProvider.data, ImageFormat.isSupported(data: data) else {
+            return nil
+        }
+
+        var width: Int32 = 0
+        var height: Int32 = 0
+        var channelsInFile: Int32 = 0
+
+        let result = data.withUnsafeBytes { encodedData in
+            let boundData = encodedData.bindMemory(to: stbi_uc.self)
+            return stbi_info_from_memory(boundData.baseAddress!, Int32(encodedData.count), &width, &height, &channelsInFile)
+        }
+
+        if result == 0 {
             return nil
         }
+
+        return CGSize(width: Int(width), height: Int(height))
+    }
+
+    internal static let decodedChannels = 4
+
+    internal static func loadPixels(from data: Data) -> (pixels: UnsafeMutablePointer<stbi_uc>, width: Int, height: Int)? {
+        guard ImageFormat.isSupported(data: data) else {
+            return nil
+        }
+
+        var width: Int32 = 0
+        var height: Int32 = 0
+        var channelsInFile: Int32 = 0
+
+        let pixelData: UnsafeMutablePointer<stbi_uc>? = data.withUnsafeBytes { encodedData in
+            let boundData = encodedData.bindMemory(to: stbi_uc.self)
+            return stbi_load_from_memory(boundData.baseAddress!, Int32(encodedData.count), &width, &height, &channelsInFile, Int32(decodedChannels))
+        }
+
+        guard let pixelData = pixelData else {
+            return nil
+        }
+
+        return (pixelData, Int(width), Int(height))
+    }
+
+    internal static func resizePixels(_ pixelData: UnsafePointer<stbi_uc>, width: Int, height: Int, into destination: UnsafeMutablePointer<stbi_uc>, targetWidth: Int, targetHeight: Int) -> Bool {
+        let channels = decodedChannels
+
+        return stbir_resize_uint8(pixelData, Int32(width), Int32(height), Int32(width * channels), destination, Int32(targetWidth), Int32(targetHeight), Int32(targetWidth * channels), Int32(channels)) != 0
+    }
+
+    internal static func downsampledSize(width: Int, height: Int, fitting pixelSize: CGSize) -> (width: Int, height: Int) {
+        guard width > 0, height > 0, pixelSize.width > 0, pixelSize.height > 0 else {
+            return (width, height)
+        }
+
+        let scale = min(1.0, max(pixelSize.width / CGFloat(width), pixelSize.height / CGFloat(height)))
+
+        return (max(1, Int((CGFloat(width) * scale).rounded(.up))), max(1, Int((CGFloat(height) * scale).rounded(.up))))
     }
 
     internal init?(context: CGContext) {
@@ -108,4 +237,27 @@ public final class CGImage {
         //
         //        self.bitmap = UnsafeMutableRawBufferPointer(start: copyData, count: size)
     }
+
+    /// Image that owns a copy of context's pixels, so it stays valid after the context's memory is reused
+    @_spi(AppKid) public init?(copyingPixelsOf context: CGContext) {
+        guard let pixelData = context.data else {
+            return nil
+        }
+
+        let size = context.height * context.bytesPerRow
+
+        let copyData = UnsafeMutableRawPointer.allocate(byteCount: size, alignment: 64)
+        copyData.copyMemory(from: pixelData, byteCount: size)
+
+        self.dataStore = nil
+        self.bitmap = UnsafeMutableRawBufferPointer(start: copyData, count: size)
+
+        self.isMask = false
+        self.width = context.width
+        self.height = context.height
+        self.bitsPerComponent = context.bitsPerComponent
+        self.bitsPerPixel = context.bitsPerPixel
+        self.bytesPerRow = context.bytesPerRow
+        self.dataProvider = CGDataProvider(data: Data(bytesNoCopy: copyData, count: size, deallocator: .none))!
+    }
 }
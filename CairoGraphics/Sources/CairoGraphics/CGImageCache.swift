@@ -0,0 +1,132 @@
+//
+//  CGImageCache.swift
+//  CairoGraphics
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import TinyFoundation
+
+public final class CGImageCache {
+    public struct Key: Hashable {
+        public let sourceIdentifier: String
+        public let pixelWidth: Int
+        public let pixelHeight: Int
+
+        public init(sourceIdentifier: String, pixelSize: CGSize?) {
+            self.sourceIdentifier = sourceIdentifier
+            // smumriak: zero size stands for full resolution
+            self.pixelWidth = pixelSize.map { Int($0.width.rounded(.up)) } ?? 0
+            self.pixelHeight = pixelSize.map { Int($0.height.rounded(.up)) } ?? 0
+        }
+    }
+
+    internal final class Entry {
+        let image: CGImage
+        let cost: Int
+        var lastUseStamp: UInt64
+
+        init(image: CGImage, cost: Int, lastUseStamp: UInt64) {
+            self.image = image
+            self.cost = cost
+            self.lastUseStamp = lastUseStamp
+        }
+    }
+
+    public static let defaultMemoryBudget = 64 * 1024 * 1024
+
+    internal let lock = Lock()
+    internal var entries: [Key: Entry] = [:]
+    internal var useStamp: UInt64 = 0
+    internal var _totalCost: Int = 0
+    internal var _memoryBudget: Int
+
+    public var totalCost: Int {
+        lock.synchronized {
+            _totalCost
+        }
+    }
+
+    public var memoryBudget: Int {
+        get {
+            lock.synchronized {
+                _memoryBudget
+            }
+        }
+        set {
+            lock.synchronized {
+                _memoryBudget = newValue
+                trimIfNeeded()
+            }
+        }
+    }
+
+    public init(memoryBudget: Int = CGImageCache.defaultMemoryBudget) {
+        _memoryBudget = memoryBudget
+    }
+
+    public func image(for key: Key) -> CGImage? {
+        lock.synchronized {
+            guard let entry = entries[key] else {
+                return nil
+            }
+
+            useStamp += 1
+            entry.lastUseStamp = useStamp
+
+            return entry.image
+        }
+    }
+
+    public func insert(_ image: CGImage, for key: Key) {
+        let cost = image.bytesPerRow * image.height
+
+        lock.synchronized {
+            useStamp += 1
+
+            if let existing = entries[key] {
+                _totalCost -= existing.cost
+            }
+
+            entries[key] = Entry(image: image, cost: cost, lastUseStamp: useStamp)
+            _totalCost += cost
+
+            trimIfNeeded()
+        }
+    }
+
+    public func removeImage(for key: Key) {
+        lock.synchronized {
+            if let entry = entries.removeValue(forKey: key) {
+                _totalCost -= entry.cost
+            }
+        }
+    }
+
+    public func removeAll() {
+        lock.synchronized {
+            entries.removeAll()
+            _totalCost = 0
+        }
+    }
+
+    // smumriak: has to be called with the lock held
+    internal func trimIfNeeded() {
+        guard _totalCost > _memoryBudget else {
+            return
+        }
+
+        let sortedKeys = entries.sorted { $0.value.lastUseStamp < $1.value.lastUseStamp }.map { $0.key }
+
+        for key in sortedKeys {
+            if _totalCost <= _memoryBudget {
+                break
+            }
+
+            if let entry = entries.removeValue(forKey: key) {
+                _totalCost -= entry.cost
+            }
+        }
+    }
+}
@@ -0,0 +1,107 @@
+//
+//  CGImageDecoder.swift
+//  CairoGraphics
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import TinyFoundation
+
+public final class CGImageDecoder {
+    public typealias Completion = (_ image: CGImage?) -> ()
+
+    public static let shared = CGImageDecoder()
+
+    public let cache: CGImageCache
+    internal let operationQueue: OperationQueue
+    internal let completionQueue: DispatchQueue
+
+    internal let lock = Lock()
+    internal var pendingCompletions: [CGImageCache.Key: [Completion]] = [:]
+
+    public init(cache: CGImageCache = CGImageCache(), maximumConcurrentDecodes: Int = max(1, ProcessInfo.processInfo.activeProcessorCount - 1), completionQueue: DispatchQueue = .main) {
+        self.cache = cache
+        self.completionQueue = completionQueue
+
+        operationQueue = OperationQueue()
+        operationQueue.name = "CGImageDecoder"
+        operationQueue.qualityOfService = .userInitiated
+        operationQueue.maxConcurrentOperationCount = maximumConcurrentDecodes
+    }
+
+    /// Returns cached image right away if it is available, otherwise returns `nil`
+    public func cachedImage(dataProvider: CGDataProvider, pixelSize: CGSize?) -> CGImage? {
+        guard let sourceIdentifier = dataProvider.sourceIdentifier else {
+            return nil
+        }
+
+        return cache.image(for: CGImageCache.Key(sourceIdentifier: sourceIdentifier, pixelSize: pixelSize))
+    }
+
+    /// Decodes image on background queue and calls `completion` on completion queue. Requests for the same source and size that are in flight are coalesced into single decode
+    public func decode(dataProvider: CGDataProvider, pixelSize: CGSize?, completion: @escaping Completion) {
+        guard let sourceIdentifier = dataProvider.sourceIdentifier else {
+            operationQueue.addOperation { [completionQueue] in
+                let image = CGImage(dataProvider: dataProvider, pixelSize: pixelSize)
+
+                completionQueue.async {
+                    completion(image)
+                }
+            }
+
+            return
+        }
+
+        let key = CGImageCache.Key(sourceIdentifier: sourceIdentifier, pixelSize: pixelSize)
+
+        if let image = cache.image(for: key) {
+            completionQueue.async {
+                completion(image)
+            }
+            return
+        }
+
+        let isFirstRequest: Bool = lock.synchronized {
+            if pendingCompletions[key] != nil {
+                pendingCompletions[key]!.append(completion)
+                return false
+            } else {
+                pendingCompletions[key] = [completion]
+                return true
+            }
+        }
+
+        guard isFirstRequest else {
+            return
+        }
+
+        operationQueue.addOperation { [weak self] in
+            guard let self = self else {
+                return
+            }
+
+            let image = CGImage(dataProvider: dataProvider, pixelSize: pixelSize)
+
+            if let image = image {
+                self.cache.insert(image, for: key)
+            }
+
+            let completions: [Completion] = self.lock.synchronized {
+                self.pendingCompletions.removeValue(forKey: key) ?? []
+            }
+
+            self.completionQueue.async {
+                completions.forEach { $0(image) }
+            }
+        }
+    }
+
+    public func decode(dataProvider: CGDataProvider, pixelSize: CGSize?) async -> CGImage? {
+        await withCheckedContinuation { continuation in
+            decode(dataProvider: dataProvider, pixelSize: pixelSize) {
+                continuation.resume(returning: $0)
+            }
+        }
+    }
+}
@@ -28,3 +28,61 @@ open class CGPath {
         }
     }
 }
+
+public extension CGPath {
+    /// Smallest rectangle that contains all points of the path including control points of curves
+    var boundingBox: CGRect {
+        let path = _path.pointee
+
+        guard let data = path.data, path.num_data > 0 else {
+            return .null
+        }
+
+        var minX = CGFloat.infinity
+        var minY = CGFloat.infinity
+        var maxX = -CGFloat.infinity
+        var maxY = -CGFloat.infinity
+
+        var index = 0
+        while index < Int(path.num_data) {
+            let length = Int(data[index].header.length)
+
+            for pointIndex in 1..<max(length, 1) {
+                let point = data[index + pointIndex].point
+                minX = min(minX, CGFloat(point.x))
+                minY = min(minY, CGFloat(point.y))
+                maxX = max(maxX, CGFloat(point.x))
+                maxY = max(maxY, CGFloat(point.y))
+            }
+
+            index += max(length, 1)
+        }
+
+        if minX > maxX || minY > maxY {
+            return .null
+        }
+
+        return CGRect(x: minX, y: minY, width: maxX - minX, height: maxY - minY)
+    }
+}
+
+// smumriak: paths are compared by their elements, so two paths built the same way are equal. used as a cache key for rasterized shapes
+extension CGPath: Hashable {
+    public static func == (lhs: CGPath, rhs: CGPath) -> Bool {
+        if lhs === rhs {
+            return true
+        }
+
+        return lhs.elementsBytes.elementsEqual(rhs.elementsBytes)
+    }
+
+    public func hash(into hasher: inout Hasher) {
+        hasher.combine(bytes: elementsBytes)
+    }
+
+    internal var elementsBytes: UnsafeRawBufferPointer {
+        let path = _path.pointee
+
+        return UnsafeRawBufferPointer(start: path.data, count: Int(path.num_data) * MemoryLayout<cairo_path_data_t>.stride)
+    }
+}
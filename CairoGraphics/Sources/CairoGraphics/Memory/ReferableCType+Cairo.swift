@@ -23,3 +23,8 @@ extension cairo_pattern_t: RetainableCType {
     public static let retainFunc = cairo_pattern_reference
     public static let releaseFunc = cairo_pattern_destroy
 }
+
+extension cairo_scaled_font_t: RetainableCType {
+    public static let retainFunc = cairo_scaled_font_reference
+    public static let releaseFunc = cairo_scaled_font_destroy
+}
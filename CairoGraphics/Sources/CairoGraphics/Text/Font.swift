@@ -36,6 +36,20 @@ public struct Font {
     }()
 }
 
+extension Font: Hashable {
+    public static func == (lhs: Font, rhs: Font) -> Bool {
+        return lhs.familyName == rhs.familyName
+            && lhs.size == rhs.size
+            && lhs.weight == rhs.weight
+    }
+
+    public func hash(into hasher: inout Hasher) {
+        familyName.hash(into: &hasher)
+        size.hash(into: &hasher)
+        weight.rawValue.hash(into: &hasher)
+    }
+}
+
 public extension Font {
     static func systemFont(ofSize size: CGFloat) -> Font {
         // TODO: smumriak: Use GTK dylib to fetch system font for GTK-based environment and vice versa
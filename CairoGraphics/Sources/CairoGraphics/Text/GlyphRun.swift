@@ -0,0 +1,152 @@
+//
+//  GlyphRun.swift
+//  CairoGraphics
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import CPango
+import CCairo
+import TinyFoundation
+
+// smumriak: these are defined with casts in pango headers, so they are not imported
+internal let kPangoGlyphEmpty: PangoGlyph = 0x0FFFFFFF
+internal let kPangoGlyphUnknownFlag: PangoGlyph = 0x10000000
+
+/// Font that glyphs of shaped text are rasterized with. Pango shares one cairo scaled font between all layouts with the same font description, scale and font options, so fonts are equal when their scaled fonts are the same object
+@_spi(AppKid) public final class GlyphFont: Hashable {
+    internal let scaledFont: RetainablePointer<cairo_scaled_font_t>
+
+    internal init(scaledFont: UnsafeMutablePointer<cairo_scaled_font_t>) {
+        self.scaledFont = RetainablePointer(retaining: scaledFont)
+    }
+
+    /// Pixels per unit of text layout
+    internal var deviceScale: (x: Double, y: Double) {
+        var matrix = cairo_matrix_t()
+        cairo_scaled_font_get_ctm(scaledFont.pointer, &matrix)
+        return (matrix.xx, matrix.yy)
+    }
+
+    /// Pixel rect covered by the glyph when its origin is at `subpixelOffset` to the right of pixel grid, relative to pixel that contains the origin. Returns nil for glyphs without ink
+    public func pixelBounds(of glyph: UInt32, subpixelOffset: CGFloat) -> CGRect? {
+        var cairoGlyph = cairo_glyph_t(index: CUnsignedLong(glyph), x: 0.0, y: 0.0)
+        var extents = cairo_text_extents_t()
+        cairo_scaled_font_glyph_extents(scaledFont.pointer, &cairoGlyph, 1, &extents)
+
+        if extents.width <= 0.0 || extents.height <= 0.0 {
+            return nil
+        }
+
+        let scale = deviceScale
+
+        // smumriak: one pixel of padding on each side keeps antialiased edges and bilinear sampling inside of the rect
+        let minX = (extents.x_bearing * scale.x + Double(subpixelOffset)).rounded(.down) - 1.0
+        let maxX = ((extents.x_bearing + extents.width) * scale.x + Double(subpixelOffset)).rounded(.up) + 1.0
+        let minY = (extents.y_bearing * scale.y).rounded(.down) - 1.0
+        let maxY = ((extents.y_bearing + extents.height) * scale.y).rounded(.up) + 1.0
+
+        return CGRect(x: minX, y: minY, width: maxX - minX, height: maxY - minY)
+    }
+
+    /// Draws coverage of the glyph with given color ignoring current transform of the context. Glyph origin is placed at the point in pixels of the context
+    public func draw(_ glyph: UInt32, at point: CGPoint, in context: CGContext, color: CGColor = .white) {
+        let cairo = context.context.pointer
+
+        cairo_save(cairo)
+
+        // smumriak: cairo wants transform of the context to match the one scaled font was created with, except for translation
+        var matrix = cairo_matrix_t()
+        cairo_scaled_font_get_ctm(scaledFont.pointer, &matrix)
+        matrix.x0 = Double(point.x)
+        matrix.y0 = Double(point.y)
+        cairo_set_matrix(cairo, &matrix)
+
+        cairo_set_scaled_font(cairo, scaledFont.pointer)
+        cairo_set_source(cairo, color.cairoPattern.pointer)
+
+        var cairoGlyph = cairo_glyph_t(index: CUnsignedLong(glyph), x: 0.0, y: 0.0)
+        cairo_show_glyphs(cairo, &cairoGlyph, 1)
+
+        cairo_restore(cairo)
+    }
+
+    public func hash(into hasher: inout Hasher) {
+        hasher.combine(UInt(bitPattern: scaledFont.pointer))
+    }
+
+    public static func == (lhs: GlyphFont, rhs: GlyphFont) -> Bool {
+        lhs.scaledFont.pointer == rhs.scaledFont.pointer
+    }
+}
+
+/// Single glyph of shaped text
+@_spi(AppKid) public struct PositionedGlyph {
+    public let font: GlyphFont
+    public let glyph: UInt32
+    /// Origin of the glyph on the baseline in pixels, relative to top left corner of the layout
+    public let position: CGPoint
+}
+
+internal extension TextLayout {
+    /// Walks shaped runs of the layout and collects every glyph that has ink. Pango keeps positions in layout units, they are converted to pixels with the scale layout was shaped at
+    func positionedGlyphs(scale: CGFloat) -> [PositionedGlyph] {
+        guard let iterator = pango_layout_get_iter(pointer) else {
+            return []
+        }
+        defer {
+            pango_layout_iter_free(iterator)
+        }
+
+        let unitsToPixels = scale / CGFloat(PANGO_SCALE)
+
+        var fonts: [UnsafeMutablePointer<PangoFont>: GlyphFont] = [:]
+        var result: [PositionedGlyph] = []
+
+        repeat {
+            // smumriak: line ends have no run
+            guard let run = pango_layout_iter_get_run_readonly(iterator) else {
+                continue
+            }
+
+            guard let pangoFont = run.pointee.item.pointee.analysis.font else {
+                continue
+            }
+
+            let font: GlyphFont
+            if let existing = fonts[pangoFont] {
+                font = existing
+            } else {
+                guard let scaledFont = pango_cairo_font_get_scaled_font(OpaquePointer(pangoFont)) else {
+                    continue
+                }
+
+                font = GlyphFont(scaledFont: scaledFont)
+                fonts[pangoFont] = font
+            }
+
+            var logicalRect = PangoRectangle()
+            pango_layout_iter_get_run_extents(iterator, nil, &logicalRect)
+            let baseline = pango_layout_iter_get_baseline(iterator)
+
+            let glyphString = run.pointee.glyphs.pointee
+            var x = logicalRect.x
+
+            for index in 0..<Int(glyphString.num_glyphs) {
+                let info = glyphString.glyphs[index]
+
+                if info.glyph != kPangoGlyphEmpty && info.glyph & kPangoGlyphUnknownFlag == 0 {
+                    let position = CGPoint(x: CGFloat(x + info.geometry.x_offset) * unitsToPixels,
+                                           y: CGFloat(baseline + info.geometry.y_offset) * unitsToPixels)
+
+                    result.append(PositionedGlyph(font: font, glyph: info.glyph, position: position))
+                }
+
+                x += info.geometry.width
+            }
+        } while pango_layout_iter_next_run(iterator) != 0
+
+        return result
+    }
+}
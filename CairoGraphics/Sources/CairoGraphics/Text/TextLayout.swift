@@ -56,6 +56,18 @@ public class FontOptions: SharedPointerStorage<cairo_font_options_t> {
 
 @_spi(AppKid) public class TextFontMap: SharedPointerStorage<PangoFontMap> {
     public static let `default` = TextFontMap(handle: SharedPointer(with: pango_cairo_font_map_get_default(), deleter: .none))
+
+    /// Makes fontconfig load its configuration and font cache and resolves the font, so first text layout does not pay for it. Can be called from any thread: pango font maps are not thread safe, so it uses its own font map, while fontconfig state is shared by all of them
+    public static func warmUp(with font: Font = .systemFont(ofSize: 17)) {
+        var font = font
+
+        let fontMap = TextFontMap(handle: SharedPointer(with: pango_cairo_font_map_new()!, deleter: .custom { g_object_unref(gpointer($0)) }))
+        let context = TextContext(with: fontMap)
+
+        if let loadedFont = pango_font_map_load_font(fontMap.pointer, context.pointer, font.cairoFontDescription.pointer) {
+            g_object_unref(gpointer(loadedFont))
+        }
+    }
 }
 
 @_spi(AppKid) public class TextContext: SharedPointerStorage<PangoContext> {
@@ -207,86 +219,67 @@ public class FontOptions: SharedPointerStorage<cairo_font_options_t> {
 }
 
 @_spi(AppKid) open class LabelTextLayout {
-    fileprivate var hasChanged = false
-
-    public private(set) var layout: TextLayout
-    public private(set) var textContext: TextContext
-
-    open var font: Font = .systemFont(ofSize: 17) {
-        didSet {
-            layout.fontDescription = UnsafePointer(font.cairoFontDescription.pointer)
-            hasChanged = true
-        }
+    // smumriak: this object only holds configuration. actual shaping happens in shared cache so identical labels are shaped once
+    public var cache: TextLayoutCache = .shared
+
+    open var font: Font = .systemFont(ofSize: 17)
+    open var text: String? = nil
+    open var textColor: CGColor? = nil
+
+    open var wrap: PangoWrapMode = .word
+    open var ellipsize: PangoEllipsizeMode = .end
+    open var alignment: PangoAlignment = .center
+
+    public init() {}
+
+    public func cacheKey(text: String, size: CGSize, scale: CGFloat) -> TextLayoutCache.Key {
+        return TextLayoutCache.Key(text: text,
+                                   font: font,
+                                   width: size.width.rounded(.up).pangoUnits,
+                                   height: size.height.rounded(.up).pangoUnits,
+                                   wrap: wrap,
+                                   ellipsize: ellipsize,
+                                   alignment: alignment,
+                                   scale: scale)
     }
 
-    open var text: String? {
-        get {
-            layout.text
-        }
-        set {
-            layout.text = newValue
+    /// Size of the text when laid out in given rect. Shaped result is reused by following `render(in:rect:)` with the same rect and scale
+    open func measure(in size: CGSize, scale: CGFloat = 1.0) -> CGSize {
+        guard let text = text, text.isEmpty == false else {
+            return .zero
         }
-    }
 
-    open var textColor: CGColor? {
-        get {
-            layout.textColor
-        }
-        set {
-            layout.textColor = newValue
-        }
-    }
-    
-    public init() {
-        textContext = TextContext()
-        layout = TextLayout(with: textContext)
-        layout.fontDescription = UnsafePointer(font.cairoFontDescription.pointer)
-
-        let fontOptions = FontOptions()
-        fontOptions.antialias = .good
-        fontOptions.hintStyle = .full
-        fontOptions.hintMetrics = .on
-        fontOptions.subpixelOrder = .default
-        textContext.fontOptions = fontOptions
-
-        layout.wrap = .word
-        layout.ellipsize = .end
-        layout.alignment = .center
+        return cache.shapedText(for: cacheKey(text: text, size: size, scale: scale)).size
     }
 
-    open func render(in context: CGContext, rect: CGRect) {
+    /// Shaped text and top left corner it is drawn at when rendered in given rect. Text is centered vertically if it is shorter than the rect
+    open func shapedText(in rect: CGRect, scale: CGFloat) -> (shapedText: ShapedText, origin: CGPoint)? {
         guard let text = text, text.isEmpty == false else {
-            return
+            return nil
         }
 
-        var rect = rect
+        let shapedText = cache.shapedText(for: cacheKey(text: text, size: rect.size, scale: scale))
 
-        let width = rect.width.rounded(.up).pangoUnits
-        let height = rect.height.rounded(.up).pangoUnits
-        
-        if width != layout.width {
-            layout.width = width
-            hasChanged = true
-        }
+        var origin = rect.origin
 
-        if height != layout.height {
-            layout.height = height
-            hasChanged = true
+        let delta = rect.midY - shapedText.logicalPixelRect.midY
+        if delta > 0 {
+            origin.y += delta
         }
 
-        if hasChanged {
-            textContext.update(with: context)
-            layout.forceLayout()
-            hasChanged = false
-        }
+        return (shapedText, origin)
+    }
 
-        let delta = rect.midY - layout.logicalPixelRect.cgRect.midY
-        if delta > 0 {
-            rect.origin.y += delta
+    open func render(in context: CGContext, rect: CGRect) {
+        let ctm = context.ctm
+        let scale = (ctm.a * ctm.a + ctm.b * ctm.b).squareRoot()
+
+        guard let result = shapedText(in: rect, scale: scale) else {
+            return
         }
 
-        context.move(to: rect.origin)
-        layout.draw(in: context)
+        context.move(to: result.origin)
+        result.shapedText.draw(in: context, color: textColor)
     }
 }
 
@@ -0,0 +1,286 @@
+//
+//  TextLayoutCache.swift
+//  CairoGraphics
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import CPango
+import CCairo
+import TinyFoundation
+
+/// Result of itemization, shaping and line breaking of a piece of text. Instances are shared between everybody who asks for the same text with the same attributes, so they must never be mutated
+@_spi(AppKid) public final class ShapedText {
+    /// Shared layouts keep using fonts of the font map they were shaped with, on whatever thread they are drawn. Pango font maps and layouts are not thread safe, so shaping and every use of a layout after it is shaped go through this lock. Cache lookups never take it
+    internal static let pangoLock = Lock()
+
+    public let key: TextLayoutCache.Key
+    internal let layout: TextLayout
+
+    public let logicalPixelRect: CGRect
+    public let inkPixelRect: CGRect
+    public let lineCount: Int
+    public let baseline: CGFloat
+
+    private var _glyphs: [PositionedGlyph]? = nil
+
+    /// Glyphs with ink in pixels of `key.scale`. Collected from shaped runs on first access
+    public var glyphs: [PositionedGlyph] {
+        Self.pangoLock.synchronized {
+            if let result = _glyphs {
+                return result
+            }
+
+            let result = layout.positionedGlyphs(scale: key.scale)
+            _glyphs = result
+            return result
+        }
+    }
+
+    public var size: CGSize {
+        logicalPixelRect.size
+    }
+
+    internal init(key: TextLayoutCache.Key, layout: TextLayout) {
+        self.key = key
+        self.layout = layout
+
+        logicalPixelRect = layout.logicalPixelRect.cgRect
+        inkPixelRect = layout.inkPixelRect.cgRect
+        lineCount = Int(pango_layout_get_line_count(layout.pointer))
+        baseline = CGFloat(pango_layout_get_baseline(layout.pointer)) / CGFloat(PANGO_SCALE)
+    }
+
+    public func draw(in context: CGContext, color: CGColor?) {
+        if let color = color {
+            cairo_set_source(context.context.pointer, color.cairoPattern.pointer)
+        }
+
+        Self.pangoLock.synchronized {
+            pango_cairo_show_layout(context.context.pointer, layout.pointer)
+        }
+    }
+}
+
+@_spi(AppKid) public final class TextLayoutCache {
+    public struct Key: Hashable {
+        public let text: String
+        public let font: Font
+        public let width: CInt
+        public let height: CInt
+        public let wrap: PangoWrapMode
+        public let ellipsize: PangoEllipsizeMode
+        public let alignment: PangoAlignment
+        public let scale: CGFloat
+
+        public init(text: String, font: Font, width: CInt, height: CInt = -1, wrap: PangoWrapMode = .word, ellipsize: PangoEllipsizeMode = .end, alignment: PangoAlignment = .center, scale: CGFloat = 1.0) {
+            self.text = text
+            self.font = font
+            self.width = width
+            self.height = height
+            self.wrap = wrap
+            self.ellipsize = ellipsize
+            self.alignment = alignment
+            self.scale = scale
+        }
+
+        public func hash(into hasher: inout Hasher) {
+            text.hash(into: &hasher)
+            font.hash(into: &hasher)
+            width.hash(into: &hasher)
+            height.hash(into: &hasher)
+            wrap.rawValue.hash(into: &hasher)
+            ellipsize.rawValue.hash(into: &hasher)
+            alignment.rawValue.hash(into: &hasher)
+            scale.hash(into: &hasher)
+        }
+
+        public static func == (lhs: Key, rhs: Key) -> Bool {
+            return lhs.text == rhs.text
+                && lhs.font == rhs.font
+                && lhs.width == rhs.width
+                && lhs.height == rhs.height
+                && lhs.wrap.rawValue == rhs.wrap.rawValue
+                && lhs.ellipsize.rawValue == rhs.ellipsize.rawValue
+                && lhs.alignment.rawValue == rhs.alignment.rawValue
+                && lhs.scale == rhs.scale
+        }
+    }
+
+    public struct Statistics {
+        public var hits: UInt64 = 0
+        public var misses: UInt64 = 0
+        public var evictions: UInt64 = 0
+
+        public var hitRate: Double {
+            let total = hits + misses
+            return total == 0 ? 0.0 : Double(hits) / Double(total)
+        }
+    }
+
+    internal final class Entry {
+        let shapedText: ShapedText
+        var lastUseStamp: UInt64
+
+        init(shapedText: ShapedText, lastUseStamp: UInt64) {
+            self.shapedText = shapedText
+            self.lastUseStamp = lastUseStamp
+        }
+    }
+
+    public static let shared = TextLayoutCache()
+
+    internal let lock = Lock()
+    internal var entries: [Key: Entry] = [:]
+    internal var useStamp: UInt64 = 0
+    internal var _statistics = Statistics()
+    internal var _countLimit: Int
+
+    public var countLimit: Int {
+        get {
+            lock.synchronized { _countLimit }
+        }
+        set {
+            lock.synchronized {
+                _countLimit = newValue
+                trimIfNeeded()
+            }
+        }
+    }
+
+    public var statistics: Statistics {
+        lock.synchronized { _statistics }
+    }
+
+    public var count: Int {
+        lock.synchronized { entries.count }
+    }
+
+    public init(countLimit: Int = 1024) {
+        _countLimit = countLimit
+    }
+
+    /// Returns shaped text for given key, shaping it only if nobody has asked for it before
+    public func shapedText(for key: Key) -> ShapedText {
+        let cached: ShapedText? = lock.synchronized {
+            useStamp += 1
+
+            if let entry = entries[key] {
+                _statistics.hits += 1
+                entry.lastUseStamp = useStamp
+                return entry.shapedText
+            }
+
+            _statistics.misses += 1
+
+            return nil
+        }
+
+        if let cached = cached {
+            return cached
+        }
+
+        // smumriak: shaping happens outside of the cache lock, so lookups of texts that are already shaped never wait for it
+        let shapedText: ShapedText = ShapedText.pangoLock.synchronized {
+            let layout = TextLayout(with: Self.textContext(for: key.scale))
+            var font = key.font
+            layout.fontDescription = UnsafePointer(font.cairoFontDescription.pointer)
+            layout.wrap = key.wrap
+            layout.ellipsize = key.ellipsize
+            layout.alignment = key.alignment
+            layout.width = key.width
+            layout.height = key.height
+            layout.text = key.text
+
+            return ShapedText(key: key, layout: layout)
+        }
+
+        return lock.synchronized {
+            // smumriak: another thread could have shaped the same text in the meantime. first result wins, so everybody shares the same instance
+            if let entry = entries[key] {
+                return entry.shapedText
+            }
+
+            useStamp += 1
+            entries[key] = Entry(shapedText: shapedText, lastUseStamp: useStamp)
+
+            trimIfNeeded()
+
+            return shapedText
+        }
+    }
+
+    /// Measures text without drawing it. Result is cached, so following render of the same text does not shape it again
+    public func size(of text: String, font: Font, width: CGFloat?, wrap: PangoWrapMode = .word, ellipsize: PangoEllipsizeMode = .end, scale: CGFloat = 1.0) -> CGSize {
+        let key = Key(text: text, font: font, width: width.map { $0.rounded(.up).pangoUnits } ?? -1, wrap: wrap, ellipsize: ellipsize, scale: scale)
+        return shapedText(for: key).size
+    }
+
+    public func removeAll() {
+        lock.synchronized {
+            entries.removeAll()
+        }
+    }
+
+    public func resetStatistics() {
+        lock.synchronized {
+            _statistics = Statistics()
+        }
+    }
+
+    // smumriak: pango font maps and contexts are not thread safe. every thread shapes with contexts created from its own default font map, one per scale. font options match the ones LabelTextLayout always used
+    internal static func textContext(for scale: CGFloat) -> TextContext {
+        let key = "TextLayoutCache.textContext.\(scale)"
+        let threadDictionary = Thread.current.threadDictionary
+
+        if let result = threadDictionary[key] as? TextContext {
+            return result
+        }
+
+        let fontMap = TextFontMap(handle: SharedPointer(with: pango_cairo_font_map_get_default(), deleter: .none))
+        let result = TextContext(with: fontMap)
+
+        let fontOptions = FontOptions()
+        fontOptions.antialias = .good
+        fontOptions.hintStyle = .full
+        fontOptions.hintMetrics = .on
+        fontOptions.subpixelOrder = .default
+        result.fontOptions = fontOptions
+
+        var matrix = PangoMatrix(xx: Double(scale), xy: 0.0, yx: 0.0, yy: Double(scale), x0: 0.0, y0: 0.0)
+        pango_context_set_matrix(result.pointer, &matrix)
+
+        threadDictionary[key] = result
+
+        return result
+    }
+
+    // smumriak: has to be called with the lock held
+    internal func trimIfNeeded() {
+        guard entries.count > _countLimit else {
+            return
+        }
+
+        let overflow = entries.count - _countLimit
+        let keysToEvict: [Key]
+
+        // smumriak: full cache overflows by one entry on every miss, linear scan is enough for it. sorting is only for shrinking count limit
+        if overflow == 1 {
+            keysToEvict = entries
+                .min { $0.value.lastUseStamp < $1.value.lastUseStamp }
+                .map { [$0.key] } ?? []
+        } else {
+            keysToEvict = entries
+                .sorted { $0.value.lastUseStamp < $1.value.lastUseStamp }
+                .prefix(overflow)
+                .map { $0.key }
+        }
+
+        keysToEvict.forEach {
+            entries.removeValue(forKey: $0)
+        }
+
+        _statistics.evictions += UInt64(keysToEvict.count)
+    }
+}
@@ -0,0 +1,77 @@
+//
+//  CGImageCacheTests.swift
+//  CairoGraphics
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import CairoGraphics
+
+final class CGImageCacheTests: XCTestCase {
+    // smumriak: 16x16 pixels, 4 bytes each
+    let imageCost = 16 * 16 * 4
+
+    func makeImage() throws -> CGImage {
+        let context = try XCTUnwrap(CGContext(width: 16, height: 16, bitsPerComponent: 8, bytesPerRow: 16 * 4, colorSpace: CGColorSpace(), bitmapInfo: []))
+        return try XCTUnwrap(CGImage(copyingPixelsOf: context))
+    }
+
+    func key(_ identifier: String) -> CGImageCache.Key {
+        CGImageCache.Key(sourceIdentifier: identifier, pixelSize: nil)
+    }
+
+    func testLeastRecentlyUsedImageIsEvictedOverBudget() throws {
+        let cache = CGImageCache(memoryBudget: imageCost * 3)
+
+        cache.insert(try makeImage(), for: key("first"))
+        cache.insert(try makeImage(), for: key("second"))
+        cache.insert(try makeImage(), for: key("third"))
+
+        XCTAssertEqual(cache.totalCost, imageCost * 3)
+
+        // smumriak: touching the oldest image makes the second one least recently used
+        XCTAssertNotNil(cache.image(for: key("first")))
+
+        cache.insert(try makeImage(), for: key("fourth"))
+
+        XCTAssertEqual(cache.totalCost, imageCost * 3)
+        XCTAssertNotNil(cache.entries[key("first")])
+        XCTAssertNil(cache.entries[key("second")])
+        XCTAssertNotNil(cache.entries[key("third")])
+        XCTAssertNotNil(cache.entries[key("fourth")])
+    }
+
+    func testLoweringBudgetTrimsOldestFirst() throws {
+        let cache = CGImageCache(memoryBudget: imageCost * 3)
+
+        cache.insert(try makeImage(), for: key("first"))
+        cache.insert(try makeImage(), for: key("second"))
+        cache.insert(try makeImage(), for: key("third"))
+
+        cache.memoryBudget = imageCost
+
+        XCTAssertEqual(cache.totalCost, imageCost)
+        XCTAssertEqual(Array(cache.entries.keys), [key("third")])
+    }
+
+    func testCostAccounting() throws {
+        let cache = CGImageCache(memoryBudget: imageCost * 4)
+
+        cache.insert(try makeImage(), for: key("first"))
+        cache.insert(try makeImage(), for: key("second"))
+
+        // smumriak: replacing image under the same key does not count it twice
+        cache.insert(try makeImage(), for: key("first"))
+        XCTAssertEqual(cache.totalCost, imageCost * 2)
+
+        cache.removeImage(for: key("second"))
+        XCTAssertEqual(cache.totalCost, imageCost)
+        XCTAssertNil(cache.image(for: key("second")))
+
+        cache.removeAll()
+        XCTAssertEqual(cache.totalCost, 0)
+        XCTAssertNil(cache.image(for: key("first")))
+    }
+}
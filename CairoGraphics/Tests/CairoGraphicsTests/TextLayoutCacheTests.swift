@@ -0,0 +1,84 @@
+//
+//  TextLayoutCacheTests.swift
+//  CairoGraphics
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import CairoGraphics
+
+final class TextLayoutCacheTests: XCTestCase {
+    func testConcurrentShapingSharesSingleInstance() {
+        let cache = TextLayoutCache()
+        let key = TextLayoutCache.Key(text: "Shaped once", font: .systemFont(ofSize: 17), width: -1)
+
+        let lock = Lock()
+        var results: [ShapedText] = []
+
+        DispatchQueue.concurrentPerform(iterations: 8) { _ in
+            let shapedText = cache.shapedText(for: key)
+
+            lock.synchronized {
+                results.append(shapedText)
+            }
+        }
+
+        XCTAssertEqual(cache.count, 1)
+        XCTAssertTrue(results.allSatisfy { $0 === results[0] })
+        XCTAssertGreaterThan(results[0].size.width, 0)
+    }
+
+    func testStatisticsCountHitsMissesAndEvictions() {
+        let cache = TextLayoutCache(countLimit: 2)
+        let font: Font = .systemFont(ofSize: 17)
+
+        _ = cache.shapedText(for: TextLayoutCache.Key(text: "First", font: font, width: -1))
+        _ = cache.shapedText(for: TextLayoutCache.Key(text: "First", font: font, width: -1))
+        _ = cache.shapedText(for: TextLayoutCache.Key(text: "Second", font: font, width: -1))
+        _ = cache.shapedText(for: TextLayoutCache.Key(text: "Third", font: font, width: -1))
+
+        let statistics = cache.statistics
+        XCTAssertEqual(statistics.hits, 1)
+        XCTAssertEqual(statistics.misses, 3)
+        XCTAssertEqual(statistics.evictions, 1)
+        XCTAssertEqual(statistics.hitRate, 0.25, accuracy: 0.0001)
+        XCTAssertEqual(cache.count, 2)
+
+        cache.resetStatistics()
+        XCTAssertEqual(cache.statistics.hits, 0)
+        XCTAssertEqual(cache.statistics.misses, 0)
+        XCTAssertEqual(cache.statistics.evictions, 0)
+    }
+
+    func testLeastRecentlyUsedEntryIsEvicted() {
+        let cache = TextLayoutCache(countLimit: 3)
+        let font: Font = .systemFont(ofSize: 17)
+        let keys = ["First", "Second", "Third", "Fourth"].map {
+            TextLayoutCache.Key(text: $0, font: font, width: -1)
+        }
+
+        let first = cache.shapedText(for: keys[0])
+        _ = cache.shapedText(for: keys[1])
+        _ = cache.shapedText(for: keys[2])
+
+        // smumriak: touching the oldest entry makes the second one least recently used
+        XCTAssertTrue(cache.shapedText(for: keys[0]) === first)
+
+        _ = cache.shapedText(for: keys[3])
+
+        XCTAssertEqual(cache.count, 3)
+        XCTAssertNotNil(cache.entries[keys[0]])
+        XCTAssertNil(cache.entries[keys[1]])
+        XCTAssertNotNil(cache.entries[keys[2]])
+        XCTAssertNotNil(cache.entries[keys[3]])
+
+        // smumriak: lowering the limit drops several entries at once, oldest first
+        cache.countLimit = 1
+
+        XCTAssertEqual(cache.count, 1)
+        XCTAssertNotNil(cache.entries[keys[3]])
+        XCTAssertEqual(cache.statistics.evictions, 3)
+    }
+}
@@ -46,6 +46,7 @@ let package = Package(
             name: "ContentAnimation",
             dependencies: [
                 .product(name: "CairoGraphics", package: "CairoGraphics"),
+                .product(name: "STBImageWrite", package: "CairoGraphics"),
                 .product(name: "TinyFoundation", package: "TinyFoundation"),
                 .product(name: "Volcano", package: "Volcano"),
                 .product(name: "SimpleGLM", package: "SimpleGLM"),
@@ -24,77 +24,175 @@ import TinyFoundation
     public init(rawValue: RawValue) {
         self.rawValue = rawValue
     }
+
+    // smumriak: draw straight into the front buffer instead of swapping. only valid when nobody reads the front buffer concurrently, i.e. after renderer has consumed it
+    public static let singleBuffered: CABackingStoreFlags = .init(rawValue: 1 << 0)
 }
 
 @_spi(AppKid) public class CABackingStoreContext {
     public let device: Device
     public let accessQueues: [Queue]
+    public let pool: CABackingStorePool
 
-    internal init(device: Device, accessQueues: [Queue]) {
+    internal init(device: Device, accessQueues: [Queue], memoryBudget: Int) {
         self.device = device
         self.accessQueues = accessQueues
+        self.pool = CABackingStorePool(memoryBudget: memoryBudget)
     }
 
     public static var global: CABackingStoreContext! = nil
 
-    public static func setupGlobalContext(device: Device, accessQueues: [Queue]) {
+    public static func setupGlobalContext(device: Device, accessQueues: [Queue], memoryBudget: Int = CABackingStorePool.defaultMemoryBudget) {
         guard Self.global == nil else {
             fatalError("Global backing store context has already been set up")
         }
 
-        CABackingStoreContext.global = CABackingStoreContext(device: device, accessQueues: accessQueues)
+        CABackingStoreContext.global = CABackingStoreContext(device: device, accessQueues: accessQueues, memoryBudget: memoryBudget)
+    }
+
+    public var residentBytes: Int {
+        pool.residentBytes
     }
 
     public func createBackingStore(size: CGSize, scale: CGFloat) throws -> CABackingStore {
-        return try CABackingStore(size: size, scale: scale, device: device, accessQueues: accessQueues)
+        return try CABackingStore(size: size, scale: scale, pool: pool)
     }
 }
 
 @_spi(AppKid) public class CABackingStore {
     public fileprivate(set) var frontContext: CGContext
-    public fileprivate(set) var backContext: CGContext
+    public fileprivate(set) var backContext: CGContext?
     public fileprivate(set) var bitsPerComponent: Int
     public fileprivate(set) var bytesPerPixel: Int
     public fileprivate(set) var bytesPerRow: Int
     public fileprivate(set) var colorSpace: CGColorSpace
-    public let width: Int
-    public let height: Int
+    public fileprivate(set) var width: Int
+    public fileprivate(set) var height: Int
+    public fileprivate(set) var scale: CGFloat
+
+    public let pool: CABackingStorePool
+    internal var frontBuffer: CABackingStoreBuffer
+    internal var backBuffer: CABackingStoreBuffer?
+
+    public var isSingleBuffered: Bool {
+        return backContext == nil
+    }
+
+    public var residentBytes: Int {
+        return frontBuffer.capacity + (backBuffer?.capacity ?? 0)
+    }
+
+    internal static let bitmapInfo: CGContext.CGBitmapInfo = {
+        let alphaInfo: CGContext.CGImageAlphaInfo = .premultipliedFirst
+        let pixelFormat: CGContext.CGImagePixelFormatInfo = .packed
 
-    public init(size: CGSize, scale: CGFloat, device: Device, accessQueues: [Queue]) throws {
-        let pixelSize = CGSize(width: size.width * scale, height: size.height * scale)
+        return [alphaInfo.bitmapInfo, pixelFormat.bitmapInfo]
+    }()
 
-        width = Int(pixelSize.width.rounded(.up))
-        height = Int(pixelSize.height.rounded(.up))
+    deinit {
+        pool.enqueueBuffer(frontBuffer)
+
+        if let backBuffer = backBuffer {
+            pool.enqueueBuffer(backBuffer)
+        }
+    }
+
+    public init(size: CGSize, scale: CGFloat, pool: CABackingStorePool) throws {
+        self.pool = pool
+        self.scale = scale
+
+        (width, height) = Self.pixelSize(for: size, scale: scale)
 
         bitsPerComponent = 8
         bytesPerPixel = 4
         bytesPerRow = width * bytesPerPixel
         colorSpace = CGColorSpace()
 
-        let alphaInfo: CGContext.CGImageAlphaInfo = .premultipliedFirst
-        let pixelFormat: CGContext.CGImagePixelFormatInfo = .packed
-
-        let bitmapInfo: CGContext.CGBitmapInfo = [alphaInfo.bitmapInfo, pixelFormat.bitmapInfo]
+        frontBuffer = pool.dequeueBuffer(byteCount: bytesPerRow * height)
+        backBuffer = pool.dequeueBuffer(byteCount: bytesPerRow * height)
 
-        frontContext = CGContext(width: width, height: height, bitsPerComponent: bitsPerComponent, bytesPerRow: bytesPerRow, colorSpace: colorSpace, bitmapInfo: bitmapInfo)!
-        frontContext.scaleBy(x: scale, y: scale)
-        
-        backContext = CGContext(width: width, height: height, bitsPerComponent: bitsPerComponent, bytesPerRow: bytesPerRow, colorSpace: colorSpace, bitmapInfo: bitmapInfo)!
-        backContext.scaleBy(x: scale, y: scale)
+        frontContext = Self.makeContext(buffer: frontBuffer, width: width, height: height, bitsPerComponent: bitsPerComponent, bytesPerRow: bytesPerRow, colorSpace: colorSpace, scale: scale)
+        backContext = Self.makeContext(buffer: backBuffer!, width: width, height: height, bitsPerComponent: bitsPerComponent, bytesPerRow: bytesPerRow, colorSpace: colorSpace, scale: scale)
     }
 
+    // smumriak: front buffer goes back to the pool on resize and release, so image gets its own copy of the pixels
     public var image: CGImage? {
-        return frontContext.makeImage()
+        return CGImage(copyingPixelsOf: frontContext)
     }
 
     public func update(flags: CABackingStoreFlags = [], callback: (_ context: CGContext) -> ()) {
-        callback(backContext)
-        Swift.swap(&frontContext, &backContext)
+        if flags.contains(.singleBuffered) {
+            releaseBackBuffer()
+        }
+
+        if let backContext = backContext {
+            callback(backContext)
+            self.backContext = frontContext
+            frontContext = backContext
+
+            let newFrontBuffer = backBuffer!
+            backBuffer = frontBuffer
+            frontBuffer = newFrontBuffer
+        } else {
+            callback(frontContext)
+        }
     }
 
     public func fits(size: CGSize, scale: CGFloat) -> Bool {
-        let scaledSize = size * scale
-        return width == Int(scaledSize.width.rounded(.up)) && height == Int(scaledSize.height.rounded(.up))
+        let (width, height) = Self.pixelSize(for: size, scale: scale)
+        return self.width == width && self.height == height
+    }
+
+    // smumriak: renderer calls this once contents of front buffer were copied to GPU. back buffer is not needed anymore because next update can safely draw into front buffer
+    public func contentsDidUpload() {
+        releaseBackBuffer()
+    }
+
+    public func releaseBackBuffer() {
+        guard let backBuffer = backBuffer else {
+            return
+        }
+
+        backContext = nil
+        self.backBuffer = nil
+        pool.enqueueBuffer(backBuffer)
+    }
+
+    // smumriak: keeps existing buffers if they are big enough, otherwise swaps them for ones from the pool. this is what makes interactive resizes cheap
+    public func resize(size: CGSize, scale: CGFloat) {
+        (width, height) = Self.pixelSize(for: size, scale: scale)
+        self.scale = scale
+        bytesPerRow = width * bytesPerPixel
+
+        let byteCount = bytesPerRow * height
+        let bucketCapacity = CABackingStorePool.bucketCapacity(for: byteCount)
+
+        if frontBuffer.capacity != bucketCapacity {
+            let oldFrontBuffer = frontBuffer
+            frontBuffer = pool.dequeueBuffer(byteCount: byteCount)
+            pool.enqueueBuffer(oldFrontBuffer)
+        }
+
+        frontContext = Self.makeContext(buffer: frontBuffer, width: width, height: height, bitsPerComponent: bitsPerComponent, bytesPerRow: bytesPerRow, colorSpace: colorSpace, scale: scale)
+
+        if let oldBackBuffer = backBuffer {
+            if oldBackBuffer.capacity != bucketCapacity {
+                backBuffer = pool.dequeueBuffer(byteCount: byteCount)
+                pool.enqueueBuffer(oldBackBuffer)
+            }
+
+            backContext = Self.makeContext(buffer: backBuffer!, width: width, height: height, bitsPerComponent: bitsPerComponent, bytesPerRow: bytesPerRow, colorSpace: colorSpace, scale: scale)
+        }
+    }
+
+    internal static func pixelSize(for size: CGSize, scale: CGFloat) -> (width: Int, height: Int) {
+        return (Int((size.width * scale).rounded(.up)), Int((size.height * scale).rounded(.up)))
+    }
+
+    internal static func makeContext(buffer: CABackingStoreBuffer, width: Int, height: Int, bitsPerComponent: Int, bytesPerRow: Int, colorSpace: CGColorSpace, scale: CGFloat) -> CGContext {
+        let result = CGContext(data: buffer.data, width: width, height: height, bitsPerComponent: bitsPerComponent, bytesPerRow: bytesPerRow, colorSpace: colorSpace, bitmapInfo: bitmapInfo)!
+        result.scaleBy(x: scale, y: scale)
+        return result
     }
 }
 
@@ -0,0 +1,153 @@
+//
+//  CABackingStorePool.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import TinyFoundation
+
+@_spi(AppKid) public final class CABackingStoreBuffer {
+    public let data: UnsafeMutableRawPointer
+    public let capacity: Int
+    internal var lastUseStamp: UInt64 = 0
+
+    deinit {
+        data.deallocate()
+    }
+
+    internal init(capacity: Int) {
+        self.capacity = capacity
+        // smumriak: cairo requires 4 byte alignment for image surfaces, 64 keeps rows friendly to SIMD paths in pixman
+        data = UnsafeMutableRawPointer.allocate(byteCount: capacity, alignment: 64)
+    }
+}
+
+@_spi(AppKid) public final class CABackingStorePool {
+    // smumriak: budget in megabytes can be overriden with APPKID_BACKING_STORE_BUDGET_MB
+    public static let defaultMemoryBudget: Int = {
+        let megabytes = ProcessInfo.processInfo.environment["APPKID_BACKING_STORE_BUDGET_MB"].flatMap { Int($0) } ?? 128
+        return megabytes * 1024 * 1024
+    }()
+
+    internal let lock = Lock()
+    internal var freeBuffers: [Int: [CABackingStoreBuffer]] = [:]
+    internal var useStamp: UInt64 = 0
+
+    public var memoryBudget: Int {
+        didSet {
+            lock.synchronized {
+                trimIfNeeded()
+            }
+        }
+    }
+
+    // smumriak: bytes currently handed out to backing stores
+    internal var _usedBytes: Int = 0
+    // smumriak: bytes kept in the pool for reuse
+    internal var _cachedBytes: Int = 0
+
+    public var usedBytes: Int {
+        lock.synchronized {
+            _usedBytes
+        }
+    }
+
+    public var cachedBytes: Int {
+        lock.synchronized {
+            _cachedBytes
+        }
+    }
+
+    public var residentBytes: Int {
+        lock.synchronized {
+            _usedBytes + _cachedBytes
+        }
+    }
+
+    public init(memoryBudget: Int = CABackingStorePool.defaultMemoryBudget) {
+        self.memoryBudget = memoryBudget
+    }
+
+    // smumriak: buckets grow in quarter steps between powers of two, so the worst case slack is 25% instead of 100% while still letting slightly resized layers land in the same bucket
+    public static func bucketCapacity(for byteCount: Int) -> Int {
+        let minimumCapacity = 4096
+
+        if byteCount <= minimumCapacity {
+            return minimumCapacity
+        }
+
+        let highBit = Int.bitWidth - (byteCount - 1).leadingZeroBitCount - 1
+        let power = 1 << highBit
+        let step = power >> 2
+        return ((byteCount + step - 1) / step) * step
+    }
+
+    public func dequeueBuffer(byteCount: Int) -> CABackingStoreBuffer {
+        let capacity = Self.bucketCapacity(for: byteCount)
+
+        return lock.synchronized {
+            let result: CABackingStoreBuffer
+
+            if var buffers = freeBuffers[capacity], let buffer = buffers.popLast() {
+                freeBuffers[capacity] = buffers.isEmpty ? nil : buffers
+                _cachedBytes -= capacity
+                result = buffer
+            } else {
+                result = CABackingStoreBuffer(capacity: capacity)
+            }
+
+            _usedBytes += capacity
+            trimIfNeeded()
+
+            return result
+        }
+    }
+
+    public func enqueueBuffer(_ buffer: CABackingStoreBuffer) {
+        lock.synchronized {
+            useStamp += 1
+            buffer.lastUseStamp = useStamp
+
+            _usedBytes -= buffer.capacity
+            _cachedBytes += buffer.capacity
+            freeBuffers[buffer.capacity, default: []].append(buffer)
+
+            trimIfNeeded()
+        }
+    }
+
+    public func purge() {
+        lock.synchronized {
+            freeBuffers.removeAll()
+            _cachedBytes = 0
+        }
+    }
+
+    // smumriak: evicts least recently returned buffers until resident memory fits the budget. buffers that are in use are never touched, so the budget is a soft limit
+    internal func trimIfNeeded() {
+        guard _usedBytes + _cachedBytes > memoryBudget, _cachedBytes > 0 else {
+            return
+        }
+
+        var candidates = freeBuffers.values.flatMap { $0 }
+        candidates.sort { $0.lastUseStamp < $1.lastUseStamp }
+
+        var evicted = Set<ObjectIdentifier>()
+
+        for buffer in candidates {
+            if _usedBytes + _cachedBytes <= memoryBudget {
+                break
+            }
+
+            _cachedBytes -= buffer.capacity
+            evicted.insert(ObjectIdentifier(buffer))
+        }
+
+        freeBuffers = freeBuffers.compactMapValues { buffers in
+            let remaining = buffers.filter { evicted.contains(ObjectIdentifier($0)) == false }
+            return remaining.isEmpty ? nil : remaining
+        }
+    }
+}
@@ -55,6 +55,13 @@ internal struct CALayerFlags: OptionSet {
 open class CALayer: CAValuesContainer, CAMediaTiming {
     internal var flags: CALayerFlags = []
     internal var texture: Texture?
+    /// Region of `texture` that holds contents. Whole texture unless it was over-allocated during live resize
+    internal var contentsTextureRect: vec4s = vec4s(0.0, 0.0, 1.0, 1.0)
+    /// Data provider contents that `texture` shows or is being decoded for
+    internal var contentsDecodeRequest: LayerContentsDecodeRequest? = nil
+    internal var decodedContents: DecodedLayerContents? = nil
+
+    @_spi(AppKid) public var textContents: CATextContents? = nil
 
     open weak var delegate: CALayerDelegate? = nil
 
@@ -180,7 +187,11 @@ open class CALayer: CAValuesContainer, CAMediaTiming {
     }
 
     open var superlayer: CALayer? = nil
-    open var sublayers: [CALayer]? = nil
+    open var sublayers: [CALayer]? = nil {
+        didSet {
+            subtreeDidChange()
+        }
+    }
 
     public var beginTime: CFTimeInterval = 0.0
     public var duration: CFTimeInterval = 0.0
@@ -195,6 +206,30 @@ open class CALayer: CAValuesContainer, CAMediaTiming {
 
     internal var transformsAreValid = false
 
+    /// Changes every time geometry that affects layer's transform relative to superlayer changes
+    internal fileprivate(set) var transformVersion: UInt64 = 0
+
+    /// Changes every time this layer or any layer in its subtree gets or loses sublayers. Only trees that actually changed are invalidated, so renderers of other windows keep their cached hierarchies
+    internal fileprivate(set) var subtreeGeneration: UInt64 = 0
+
+    fileprivate func subtreeDidChange() {
+        var layer: CALayer? = self
+
+        while let currentLayer = layer {
+            currentLayer.subtreeGeneration &+= 1
+            layer = currentLayer.superlayer
+        }
+    }
+
+    /// Unique across all layers, changes every time renderer redraws layer contents
+    internal fileprivate(set) var contentsVersion: UInt64 = 0
+    fileprivate static var lastContentsVersion: UInt64 = 0
+
+    internal func contentsDidChange() {
+        CALayer.lastContentsVersion &+= 1
+        contentsVersion = CALayer.lastContentsVersion
+    }
+
     @_spi(AppKid) public func invalidateTransforms() {
         transformsAreValid = false
         sublayers?.forEach { sublayer in
@@ -372,30 +407,44 @@ open class CALayer: CAValuesContainer, CAMediaTiming {
     open func display() {
         if let delegate = delegate as? CALayerDisplayDelegate {
             delegate.display(self)
-        } else if (contents == nil || contents is CABackingStore) && (bounds.width > 0 && bounds.height > 0) {
-            do {
-                let backingStore: CABackingStore = try {
-                    if let backingStore = contents as? CABackingStore, backingStore.fits(size: bounds.size, scale: contentsScale) {
-                        return backingStore
-                    } else {
+        } else {
+            displayIntoBackingStore()
+        }
+
+        needsDisplay = false
+    }
+
+    /// Default way of displaying the layer: `draw(in:)` into backing store that is kept in contents
+    @_spi(AppKid) public func displayIntoBackingStore() {
+        guard (contents == nil || contents is CABackingStore) && (bounds.width > 0 && bounds.height > 0) else {
+            return
+        }
+
+        do {
+            let backingStore: CABackingStore = try {
+                if let backingStore = contents as? CABackingStore {
+                    if backingStore.fits(size: bounds.size, scale: contentsScale) == false {
                         flags.formUnion(.needsNewTexture)
-                        return try CABackingStoreContext.global.createBackingStore(size: bounds.size, scale: contentsScale)
+                        backingStore.resize(size: bounds.size, scale: contentsScale)
                     }
-                }()
-                
-                delegate?.layerWillDraw(self)
-                backingStore.update { context in
-                    context.clear(bounds)
-                    draw(in: context)
-                }
 
-                contents = backingStore
-            } catch {
-                fatalError("Failed to create backing store with error: \(error)")
+                    return backingStore
+                } else {
+                    flags.formUnion(.needsNewTexture)
+                    return try CABackingStoreContext.global.createBackingStore(size: bounds.size, scale: contentsScale)
+                }
+            }()
+            
+            delegate?.layerWillDraw(self)
+            backingStore.update { context in
+                context.clear(bounds)
+                draw(in: context)
             }
-        }
 
-        needsDisplay = false
+            contents = backingStore
+        } catch {
+            fatalError("Failed to create backing store with error: \(error)")
+        }
     }
 
     // MARK: - Key Value Coding
@@ -451,6 +500,14 @@ open class CALayer: CAValuesContainer, CAMediaTiming {
 
     open override func didChangeValue(forKey key: String) {
         super.didChangeValue(forKey: key)
+
+        switch key {
+            case "bounds", "position", "anchorPoint", "transform", "contentsScale":
+                transformVersion &+= 1
+
+            default:
+                break
+        }
     }
 
     // MARK: - Actions
@@ -0,0 +1,27 @@
+//
+//  CATextContents.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+@_spi(AppKid) import CairoGraphics
+
+#if os(macOS)
+    import struct CairoGraphics.CGColor
+#endif
+
+/// Text that renderer draws on top of layer's contents with quads from shared glyph atlas instead of rasterizing it into layer's backing store
+@_spi(AppKid) public struct CATextContents {
+    public let shapedText: ShapedText
+    /// Top left corner of the text in layer's coordinates
+    public let origin: CGPoint
+    public let color: CGColor
+
+    public init(shapedText: ShapedText, origin: CGPoint, color: CGColor) {
+        self.shapedText = shapedText
+        self.origin = origin
+        self.color = color
+    }
+}
@@ -0,0 +1,302 @@
+//
+//  CATiledLayer.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import CairoGraphics
+import TinyFoundation
+
+#if os(macOS)
+    import class CairoGraphics.CGContext
+    import class CairoGraphics.CGColorSpace
+#endif
+
+/// Layer that draws its contents in fixed size tiles on background threads instead of one backing store of the size of its bounds. Only tiles around visible rect are drawn and kept. Every tile is a sublayer with its own texture, so moving the layer or its superlayer's bounds only translates tiles that are already uploaded
+/// - Note: `draw(in:)` and delegate's `draw(_:in:)` are called on background threads and have to be thread safe
+open class CATiledLayer: CALayer {
+    internal struct TileIndex: Hashable {
+        let column: Int
+        let row: Int
+    }
+
+    internal final class Tile {
+        let layer = CALayer()
+        var index: TileIndex? = nil
+        var rect: CGRect = .null
+        var pixelSize: (width: Int, height: Int) = (0, 0)
+        /// Keeps pixels of the tile alive while its image is the contents of tile layer
+        var context: CGContext? = nil
+        var operation: Operation? = nil
+        var generation: UInt64 = 0
+        var lastUsedStamp: UInt64 = 0
+
+        init() {
+            layer.anchorPoint = .zero
+            layer.isHidden = true
+        }
+    }
+
+    internal static let drawingQueue: OperationQueue = {
+        let result = OperationQueue()
+        result.name = "CATiledLayer.drawing"
+        result.qualityOfService = .userInitiated
+        result.maxConcurrentOperationCount = max(1, ProcessInfo.processInfo.activeProcessorCount - 1)
+        return result
+    }()
+
+    /// Size of tiles in points
+    open var tileSize: CGSize = CGSize(width: 256.0, height: 256.0) {
+        didSet {
+            invalidateTiles()
+        }
+    }
+
+    /// Maximum number of tiles kept around. Tiles that were used least recently and are outside of visible and prefetched area are reused first
+    open var maximumTileCount: Int = 64
+
+    /// How far ahead of visible rect tiles are drawn in the direction visible rect moves to, in sizes of visible rect
+    open var prefetchDistance: CGFloat = 1.0
+
+    internal var completionQueue: DispatchQueue = .main
+
+    internal fileprivate(set) var tiles: [TileIndex: Tile] = [:]
+    internal fileprivate(set) var freeTiles: [Tile] = []
+    internal fileprivate(set) var visibleRect: CGRect = .null
+    fileprivate var scrollDirection: CGPoint = .zero
+    fileprivate var tiledBounds: CGRect = .null
+    fileprivate var tiledContentsScale: CGFloat = 0.0
+    fileprivate var useStamp: UInt64 = 0
+
+    internal var tilesCount: Int {
+        tiles.count + freeTiles.count
+    }
+
+    /// Tells the layer which part of its bounds is on screen. Missing tiles around it are drawn, prefetching in the direction the visible rect moved to
+    public func setVisibleRect(_ rect: CGRect) {
+        if visibleRect.isNull == false && rect.isNull == false {
+            let deltaX = rect.midX - visibleRect.midX
+            let deltaY = rect.midY - visibleRect.midY
+
+            if deltaX != 0.0 || deltaY != 0.0 {
+                scrollDirection = CGPoint(x: deltaX.sign == .minus ? -1.0 : (deltaX == 0.0 ? 0.0 : 1.0),
+                                          y: deltaY.sign == .minus ? -1.0 : (deltaY == 0.0 ? 0.0 : 1.0))
+            }
+        }
+
+        visibleRect = rect
+
+        updateTiles()
+    }
+
+    /// Redraws tiles that intersect the rect
+    public func setNeedsDisplay(in rect: CGRect) {
+        tiles.values
+            .filter { $0.rect.intersects(rect) }
+            .forEach { scheduleDrawing(of: $0) }
+    }
+
+    open override func display() {
+        // smumriak: tiles are drawn asynchronously, so display only schedules redrawing of existing tiles and never creates full size backing store
+        tiles.values.forEach { scheduleDrawing(of: $0) }
+
+        needsDisplay = false
+    }
+
+    internal var prefetchRect: CGRect {
+        var result = visibleRect
+
+        let prefetchWidth = visibleRect.width * prefetchDistance
+        let prefetchHeight = visibleRect.height * prefetchDistance
+
+        if scrollDirection.x < 0.0 {
+            result.origin.x -= prefetchWidth
+        }
+        if scrollDirection.x != 0.0 {
+            result.size.width += prefetchWidth
+        }
+
+        if scrollDirection.y < 0.0 {
+            result.origin.y -= prefetchHeight
+        }
+        if scrollDirection.y != 0.0 {
+            result.size.height += prefetchHeight
+        }
+
+        return result
+    }
+
+    internal func updateTiles() {
+        let bounds = self.bounds
+
+        if bounds != tiledBounds || contentsScale != tiledContentsScale {
+            invalidateTiles()
+            tiledBounds = bounds
+            tiledContentsScale = contentsScale
+        }
+
+        guard tileSize.width > 0.0, tileSize.height > 0.0, visibleRect.isNull == false else {
+            return
+        }
+
+        // smumriak: visible tiles go first, so they get drawn and cached before prefetched ones
+        let visibleIndices = tileIndices(in: visibleRect)
+            .sorted { distanceToVisibleRect(of: $0) < distanceToVisibleRect(of: $1) }
+        let prefetchedIndices = tileIndices(in: prefetchRect)
+            .filter { visibleRect.intersects(rect(of: $0)) == false }
+            .sorted { distanceToVisibleRect(of: $0) < distanceToVisibleRect(of: $1) }
+        let neededIndices = visibleIndices + prefetchedIndices
+
+        let neededSet = Set(neededIndices)
+
+        useStamp += 1
+
+        for index in neededIndices {
+            if let tile = tiles[index] {
+                tile.lastUsedStamp = useStamp
+                continue
+            }
+
+            guard let tile = dequeueTile(keeping: neededSet) else {
+                break
+            }
+
+            assign(tile, to: index)
+        }
+    }
+
+    internal func rect(of index: TileIndex) -> CGRect {
+        let origin = CGPoint(x: bounds.minX + CGFloat(index.column) * tileSize.width, y: bounds.minY + CGFloat(index.row) * tileSize.height)
+        return CGRect(origin: origin, size: tileSize).intersection(bounds)
+    }
+
+    internal func tileIndices(in rect: CGRect) -> [TileIndex] {
+        let area = rect.intersection(bounds)
+
+        if area.isNull || area.isEmpty {
+            return []
+        }
+
+        let minColumn = Int(((area.minX - bounds.minX) / tileSize.width).rounded(.down))
+        let maxColumn = Int(((area.maxX - bounds.minX) / tileSize.width).rounded(.up))
+        let minRow = Int(((area.minY - bounds.minY) / tileSize.height).rounded(.down))
+        let maxRow = Int(((area.maxY - bounds.minY) / tileSize.height).rounded(.up))
+
+        return (minRow..<maxRow).flatMap { row in
+            (minColumn..<maxColumn).map { column in
+                TileIndex(column: column, row: row)
+            }
+        }
+    }
+
+    fileprivate func distanceToVisibleRect(of index: TileIndex) -> CGFloat {
+        let tileRect = rect(of: index)
+        return abs(tileRect.midX - visibleRect.midX) + abs(tileRect.midY - visibleRect.midY)
+    }
+
+    fileprivate func dequeueTile(keeping neededIndices: Set<TileIndex>) -> Tile? {
+        if let tile = freeTiles.popLast() {
+            return tile
+        }
+
+        if tilesCount < maximumTileCount {
+            let tile = Tile()
+            addSublayer(tile.layer)
+            return tile
+        }
+
+        let leastRecentlyUsed = tiles
+            .filter { neededIndices.contains($0.key) == false }
+            .min { $0.value.lastUsedStamp < $1.value.lastUsedStamp }
+
+        guard let leastRecentlyUsed = leastRecentlyUsed else {
+            return nil
+        }
+
+        tiles.removeValue(forKey: leastRecentlyUsed.key)
+
+        return leastRecentlyUsed.value
+    }
+
+    fileprivate func assign(_ tile: Tile, to index: TileIndex) {
+        let tileRect = rect(of: index)
+
+        tile.index = index
+        tile.rect = tileRect
+        tile.lastUsedStamp = useStamp
+        tile.layer.isHidden = true
+        tile.layer.contentsScale = contentsScale
+        tile.layer.position = tileRect.origin
+        tile.layer.bounds = CGRect(origin: .zero, size: tileRect.size)
+
+        tiles[index] = tile
+
+        scheduleDrawing(of: tile)
+    }
+
+    fileprivate func invalidateTiles() {
+        tiles.values.forEach {
+            $0.operation?.cancel()
+            $0.operation = nil
+            $0.generation += 1
+            $0.index = nil
+            $0.layer.isHidden = true
+            freeTiles.append($0)
+        }
+
+        tiles.removeAll()
+    }
+
+    fileprivate func scheduleDrawing(of tile: Tile) {
+        tile.operation?.cancel()
+        tile.generation += 1
+
+        let generation = tile.generation
+        let rect = tile.rect
+        let scale = contentsScale
+        let pixelSize = CABackingStore.pixelSize(for: rect.size, scale: scale)
+
+        if pixelSize.width == 0 || pixelSize.height == 0 {
+            return
+        }
+
+        let operation = BlockOperation { [weak self, completionQueue] in
+            guard let self = self else {
+                return
+            }
+
+            guard let context = CGContext(width: pixelSize.width, height: pixelSize.height, bitsPerComponent: 8, bytesPerRow: pixelSize.width * 4, colorSpace: CGColorSpace(), bitmapInfo: CABackingStore.bitmapInfo) else {
+                fatalError("Error creating context with known arguments")
+            }
+
+            context.scaleBy(x: scale, y: scale)
+            context.translateBy(x: -rect.minX, y: -rect.minY)
+
+            self.draw(in: context)
+
+            context.flush()
+
+            completionQueue.async {
+                // smumriak: tile was reused or redrawn again while this operation was running
+                guard tile.generation == generation else {
+                    return
+                }
+
+                if tile.pixelSize != pixelSize {
+                    tile.layer.flags.insert(.needsNewTexture)
+                    tile.pixelSize = pixelSize
+                }
+
+                tile.context = context
+                tile.operation = nil
+                tile.layer.contents = context.makeImage()
+                tile.layer.isHidden = false
+            }
+        }
+
+        tile.operation = operation
+        CATiledLayer.drawingQueue.addOperation(operation)
+    }
+}
@@ -80,7 +80,7 @@ open class CARenderer {
 
         descriptorSetsLayouts = try DescriptorSetsLayouts(device: device)
 
-        let pipelines = try RenderContext.Pipelines(renderPass: renderPass, descriptorSetsLayouts: descriptorSetsLayouts)
+        let pipelines = try RenderContext.Pipelines(renderPass: renderPass, descriptorSetsLayouts: descriptorSetsLayouts, shaderLibrary: renderStack.shaderLibrary)
         
         renderContext = try RenderContext(renderStack: renderStack, pipelines: pipelines, descriptorSetsLayouts: descriptorSetsLayouts)
         
@@ -114,7 +114,7 @@ open class CARenderer {
         renderPass = try device.createMainRenderPass(pixelFormat: texture.pixelFormat)
         renderTarget = try RenderTarget(renderPass: renderPass, colorAttachment: texture, clearColor: VkClearValue(color: .red))
 
-        let pipelines = try RenderContext.Pipelines(renderPass: renderPass, descriptorSetsLayouts: descriptorSetsLayouts)
+        let pipelines = try RenderContext.Pipelines(renderPass: renderPass, descriptorSetsLayouts: descriptorSetsLayouts, shaderLibrary: renderStack.shaderLibrary)
 
         renderContext = try RenderContext(renderStack: renderStack, pipelines: pipelines, descriptorSetsLayouts: descriptorSetsLayouts)
     }
@@ -191,6 +191,40 @@ open class CARenderer {
             layer.display()
         }
 
+        let drawableContents: TextureDrawable?
+
+        // smumriak: contents are uploaded before the descriptor is built because descriptor carries the region of the texture that contents were copied into
+        if needsDisplay {
+            switch layer.contents {
+                case .some(let image as CGImage):
+                    drawableContents = image
+
+                case .some(let backingStore as CABackingStore):
+                    backingStore.frontContext.flush()
+                    drawableContents = backingStore
+
+                case .some(let dataProvider as CGDataProvider):
+                    _ = try layer.updateTexture(from: dataProvider, pixelSize: bounds.size * contentsScale, renderStack: renderStack, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool)
+                    drawableContents = nil
+
+                default:
+                    drawableContents = nil
+            }
+
+            if let drawableContents = drawableContents {
+                let fitsTexture = layer.texture.map { drawableContents.fits(in: $0, allowsLargerTexture: layer.flags.contains(.needsNewTexture) == false) } ?? false
+
+                if fitsTexture == false {
+                    layer.texture = try drawableContents.createTexture(renderStack: renderStack, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool)
+                }
+
+                layer.flags.remove(.needsNewTexture)
+                layer.contentsTextureRect = drawableContents.textureRect(in: layer.texture!)
+
+                try drawableContents.drawIn(texture: layer.texture!, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool)
+            }
+        }
+
         let toScreenScaleTransform = mat4s(scaleVector: vec3s(x: bounds.width * contentsScale, y: bounds.height * contentsScale, z: 1.0))
         let anchorPointTransform = mat4s(translationVector: vec3s(x: anchorPoint.x * bounds.width * contentsScale, y: anchorPoint.y * bounds.height * contentsScale, z: 0.0))
 
@@ -210,7 +244,7 @@ open class CARenderer {
                                                position: position.vec2,
                                                anchorPoint: layer.anchorPoint.vec2,
                                                bounds: bounds.vec4,
-                                               textureRect: .zero,
+                                               textureRect: layer.contentsTextureRect,
                                                backgroundColor: layer.backgroundColor?.vec4 ?? .zero,
                                                borderColor: layer.borderColor?.vec4 ?? .zero,
                                                borderWidth: Float(layer.borderWidth),
@@ -222,37 +256,12 @@ open class CARenderer {
                                                shadowOpacity: Float(layer.shadowOpacity),
                                                padding0: .zero)
 
-        renderContext.descriptors.append(descriptor)
+        renderContext.append(descriptor)
 
         if let backgroundColor = layer.backgroundColor, backgroundColor.alpha != 0 {
             renderContext.add(.bindVertexBuffer(index: currentLayerIndex))
             renderContext.add(.background(antiAliased: true, rounded: layer.cornerRadius > 0.0))
         }
-        
-        let drawableContents: TextureDrawable?
-
-        if needsDisplay {
-            switch layer.contents {
-                case .some(let image as CGImage):
-                    drawableContents = image
-
-                case .some(let backingStore as CABackingStore):
-                    backingStore.frontContext.flush()
-                    drawableContents = backingStore
-
-                default:
-                    drawableContents = nil
-            }
-
-            if let drawableContents = drawableContents {
-                if layer.texture == nil || layer.flags.contains(.needsNewTexture) {
-                    layer.texture = try drawableContents.createTexture(renderStack: renderStack, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool)
-                    layer.flags.remove(.needsNewTexture)
-                }
-
-                try drawableContents.drawIn(texture: layer.texture!, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool)
-            }
-        }
 
         if let layerTexture = layer.texture {
             renderContext.add(.bindVertexBuffer(index: currentLayerIndex))
@@ -0,0 +1,113 @@
+//
+//  CompactLayerRenderDescriptor.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+@_spi(AppKid) import Volcano
+import SimpleGLM
+import LayerRenderingData
+
+internal let kCompactLayerRecordsDisabled: Bool = ProcessInfo.processInfo.environment["APPKID_FULL_LAYER_RECORDS"] != nil
+
+/// Where the record of a layer ended up in render context. Render operations refer to layers by index in `RenderContext.recordLocations`
+internal struct LayerRecordLocation: Equatable {
+    let compact: Bool
+    let index: UInt
+}
+
+internal struct CompactLayerFlags: OptionSet {
+    typealias RawValue = CUnsignedInt
+    let rawValue: RawValue
+
+    static let masksToBounds = CompactLayerFlags(rawValue: 1 << 0)
+}
+
+extension CompactLayerRenderDescriptor: VertexInput {
+    public static func inputBindingDescription(binding: CUnsignedInt = 0) -> VkVertexInputBindingDescription {
+        var result = VkVertexInputBindingDescription()
+        result.binding = 0
+        result.stride = CUnsignedInt(MemoryLayout<Self>.stride)
+        result.inputRate = .instance
+
+        return result
+    }
+}
+
+internal extension CompactLayerRenderDescriptor {
+    /// Encodes descriptor compactly if its transform maps the quad onto the screen plane with 2D affine transform. Returns nil if layer needs full 3D transform
+    init?(_ descriptor: LayerRenderDescriptor) {
+        let transform = descriptor.transform
+
+        // smumriak: quad has zero z, so third column does not matter. anything else outside of 2x2 and translation would either move vertices off the screen plane or make w not equal to one
+        guard transform.m02 == 0.0, transform.m12 == 0.0, transform.m32 == 0.0,
+              transform.m03 == 0.0, transform.m13 == 0.0, transform.m33 == 1.0,
+              descriptor.contentsTransform == transform else {
+            return nil
+        }
+
+        var flags: CompactLayerFlags = []
+        if descriptor.masksToBounds != 0 {
+            flags.insert(.masksToBounds)
+        }
+
+        self.init(affine: vec4s(transform.m00, transform.m01, transform.m10, transform.m11),
+                  translation: vec2s(transform.m30, transform.m31),
+                  boundsOrigin: vec2s(descriptor.bounds.x, descriptor.bounds.y),
+                  boundsSize: vec2s(descriptor.bounds.z, descriptor.bounds.w),
+                  backgroundColor: descriptor.backgroundColor.packedUnorm8,
+                  borderColor: descriptor.borderColor.packedUnorm8,
+                  textureRect: descriptor.textureRect,
+                  shadowColor: descriptor.shadowColor.packedUnorm8,
+                  borderWidthAndCornerRadius: packHalf2x16(descriptor.borderWidth, descriptor.cornerRadius),
+                  shadowRadiusAndOpacity: packHalf2x16(descriptor.shadowRadius, descriptor.shadowOpacity),
+                  flags: flags.rawValue)
+    }
+}
+
+internal extension vec4s {
+    /// Same layout as GLSL's `packUnorm4x8`: x in the lowest byte
+    var packedUnorm8: CUnsignedInt {
+        func component(_ value: Float) -> CUnsignedInt {
+            CUnsignedInt((min(max(value, 0.0), 1.0) * 255.0).rounded())
+        }
+
+        return component(x) | component(y) << 8 | component(z) << 16 | component(w) << 24
+    }
+}
+
+/// Same layout as GLSL's `packHalf2x16`: first value in the lower 16 bits
+internal func packHalf2x16(_ first: Float, _ second: Float) -> CUnsignedInt {
+    CUnsignedInt(halfFloatBits(first)) | CUnsignedInt(halfFloatBits(second)) << 16
+}
+
+// smumriak: Float16 is not available on every platform swift runs on, so conversion is done by hand. rounds to nearest, values out of range become infinity, subnormals are flushed to zero. radii and widths never need them
+internal func halfFloatBits(_ value: Float) -> UInt16 {
+    let bits = value.bitPattern
+    let sign = UInt16((bits >> 16) & 0x8000)
+    let exponent = Int((bits >> 23) & 0xFF) - 127 + 15
+    var mantissa = bits & 0x7FFFFF
+
+    if value.isNaN {
+        return sign | 0x7E00
+    }
+
+    if exponent <= 0 {
+        return sign
+    }
+
+    // smumriak: round to nearest by adding half of dropped precision. carry into exponent is correct behavior
+    mantissa += 0x1000
+
+    if mantissa & 0x800000 != 0 {
+        return exponent + 1 >= 31 ? sign | 0x7C00 : sign | UInt16(exponent + 1) << 10
+    }
+
+    if exponent >= 31 {
+        return sign | 0x7C00
+    }
+
+    return sign | UInt16(exponent) << 10 | UInt16(mantissa >> 13)
+}
@@ -10,28 +10,17 @@ import CoreFoundation
 import Volcano
 import TinyFoundation
 
+/// Descriptor sets keyed by the object they describe. Lookups of used descriptor sets go through sharded map and do not contend with each other, only allocation from pool and recycling of free descriptor sets take the pool lock
 internal class DescriptorsSetCache {
-    let lock = RecursiveLock()
+    let poolLock = FutexLock()
     let device: Device
     let layout: DescriptorSetLayout
     let sizes: [VkDescriptorPoolSize]
     let maxSets: UInt
     
-    fileprivate var usedDescriptors: [AnyHashable: DescriptorSet] = [:]
+    fileprivate let usedDescriptors = ShardedDictionary<AnyHashable, DescriptorSet>()
     fileprivate var freeDescriptors: Set<DescriptorSet> = []
-
-    fileprivate var _currentPool: DescriptorPool? = nil
-    fileprivate var currentPool: DescriptorPool {
-        get throws {
-            return try lock.synchronized {
-                if _currentPool == nil {
-                    _currentPool = try DescriptorPool(device: device, sizes: sizes, maxSets: maxSets)
-                }
-
-                return _currentPool!
-            }
-        }
-    }
+    fileprivate var currentPool: DescriptorPool? = nil
 
     init(device: Device, layout: DescriptorSetLayout, sizes: [(type: VkDescriptorType, count: UInt)], maxSets: UInt = 1000) throws {
         self.device = device
@@ -41,59 +30,79 @@ internal class DescriptorsSetCache {
     }
 
     func clear() {
-        lock.synchronized {
-            usedDescriptors.removeAll()
+        usedDescriptors.removeAll()
+
+        poolLock.synchronized {
             freeDescriptors.removeAll()
-            _currentPool = nil
+            currentPool = nil
         }
     }
 
-    func releaseDescriptorSet(for key: AnyHashable) {
-        lock.synchronized {
-            if let descriptorSet = usedDescriptors[key] {
-                usedDescriptors.removeValue(forKey: key)
-                freeDescriptors.insert(descriptorSet)
-            }
+    /// Forgets descriptor set of `key` right away, so an object that is later created at the same address never gets it. Returned descriptor set might still be in use by GPU, it goes back to the cache with `recycle(_:)` once it is not
+    func removeDescriptorSet(for key: AnyHashable) -> DescriptorSet? {
+        // smumriak: called from texture deinit hooks on arbitrary threads
+        return usedDescriptors.removeValue(forKey: key)
+    }
+
+    func recycle(_ descriptorSet: DescriptorSet) {
+        poolLock.synchronized {
+            _ = freeDescriptors.insert(descriptorSet)
         }
     }
 
     func existingDescriptorSet(for key: AnyHashable) -> DescriptorSet? {
-        return lock.synchronized { usedDescriptors[key] }
+        return usedDescriptors[key]
     }
 
     func createDescriptorSet(for key: AnyHashable) throws -> DescriptorSet {
-        return try lock.synchronized {
-            if let result = usedDescriptors[key] {
+        // smumriak: shard stays locked while descriptor set is dequeued, so two threads never create descriptor sets for the same key. pool lock never takes shard locks, so the order is always the same
+        return try usedDescriptors.withShard(for: key) { storage in
+            if let result = storage[key] {
                 return result
-            } else if let result = freeDescriptors.randomElement() {
-                freeDescriptors.remove(result)
-            
-                usedDescriptors[key] = result
+            }
+
+            let result = try dequeueDescriptorSet()
+            storage[key] = result
+
+            return result
+        }
+    }
+
+    fileprivate func dequeueDescriptorSet() throws -> DescriptorSet {
+        return try poolLock.synchronized {
+            if let result = freeDescriptors.popFirst() {
                 return result
-            } else {
-                let result: DescriptorSet = try {
-                    do {
-                        return try currentPool.allocate(with: layout)
-                    } catch {
-                        if case let VulkanError.badResult(vulkanResult) = error {
-                            switch vulkanResult {
-                                case .errorFragmentedPool, .errorOutOfPoolMemory:
-                                    _currentPool = nil
-
-                                    return try currentPool.allocate(with: layout)
-
-                                default:
-                                    throw error
-                            }
-                        } else {
+            }
+
+            do {
+                return try pool().allocate(with: layout)
+            } catch {
+                if case let VulkanError.badResult(vulkanResult) = error {
+                    switch vulkanResult {
+                        case .errorFragmentedPool, .errorOutOfPoolMemory:
+                            currentPool = nil
+
+                            return try pool().allocate(with: layout)
+
+                        default:
                             throw error
-                        }
                     }
-                }()
-
-                usedDescriptors[key] = result
-                return result
+                } else {
+                    throw error
+                }
             }
         }
     }
+
+    // smumriak: has to be called with the pool lock held
+    fileprivate func pool() throws -> DescriptorPool {
+        if let currentPool = currentPool {
+            return currentPool
+        }
+
+        let result = try DescriptorPool(device: device, sizes: sizes, maxSets: maxSets)
+        currentPool = result
+
+        return result
+    }
 }
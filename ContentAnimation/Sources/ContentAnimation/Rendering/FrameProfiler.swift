@@ -0,0 +1,239 @@
+//
+//  FrameProfiler.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import TinyFoundation
+
+@_spi(AppKid) public final class FrameProfiler {
+    public enum Category: String {
+        case frame
+        case traversal
+        case display
+        case upload
+        case recording
+        case submit
+        case present
+        case gpu
+        case other
+    }
+
+    public struct Event {
+        public let name: String
+        public let category: Category
+        // smumriak: nanoseconds in UInt64.absoluteTime domain. GPU events are mapped into it relative to submit time
+        public let start: UInt64
+        public let duration: UInt64
+        public let threadIdentifier: UInt64
+    }
+
+    public struct FrameRecord {
+        public let index: UInt64
+        public let start: UInt64
+        public internal(set) var end: UInt64 = 0
+        public internal(set) var events: [Event] = []
+
+        public var duration: UInt64 {
+            end > start ? end - start : 0
+        }
+
+        public func totalDuration(of category: Category) -> UInt64 {
+            events.filter { $0.category == category }.reduce(0) { $0 + $1.duration }
+        }
+    }
+
+    public struct ScopeToken {
+        internal let name: String
+        internal let category: Category
+        internal let start: UInt64
+    }
+
+    // smumriak: checked before anything else happens, so with profiler disabled scopes cost one load and a branch
+    public static var isEnabled: Bool = ProcessInfo.processInfo.environment["APPKID_FRAME_PROFILER"] != nil
+
+    public static let shared = FrameProfiler()
+
+    internal let lock = Lock()
+    internal var ring: [FrameRecord?]
+    internal var ringHead: Int = 0
+    internal var frameCounter: UInt64 = 0
+    internal var currentFrame: FrameRecord? = nil
+
+    public let capacity: Int
+
+    public init(capacity: Int = 240) {
+        self.capacity = capacity
+        ring = Array(repeating: nil, count: capacity)
+    }
+
+    // MARK: - Frames
+
+    @discardableResult
+    public func beginFrame() -> UInt64 {
+        lock.synchronized {
+            if let unfinishedFrame = currentFrame {
+                storeFrame(unfinishedFrame)
+            }
+
+            frameCounter += 1
+            currentFrame = FrameRecord(index: frameCounter, start: .absoluteTime)
+            return frameCounter
+        }
+    }
+
+    public func endFrame() {
+        lock.synchronized {
+            guard var frame = currentFrame else {
+                return
+            }
+
+            frame.end = .absoluteTime
+            storeFrame(frame)
+            currentFrame = nil
+        }
+    }
+
+    public var currentFrameIndex: UInt64? {
+        lock.synchronized { currentFrame?.index }
+    }
+
+    // MARK: - Scopes
+
+    @inline(__always)
+    public static func scope<R>(_ name: @autoclosure () -> String, category: Category = .other, _ body: () throws -> R) rethrows -> R {
+        guard isEnabled else {
+            return try body()
+        }
+
+        return try shared.scope(name(), category: category, body)
+    }
+
+    public func scope<R>(_ name: String, category: Category = .other, _ body: () throws -> R) rethrows -> R {
+        let token = beginScope(name, category: category)
+        defer {
+            endScope(token)
+        }
+
+        return try body()
+    }
+
+    public func beginScope(_ name: String, category: Category = .other) -> ScopeToken {
+        return ScopeToken(name: name, category: category, start: .absoluteTime)
+    }
+
+    public func endScope(_ token: ScopeToken) {
+        let end: UInt64 = .absoluteTime
+        let event = Event(name: token.name, category: token.category, start: token.start, duration: end - token.start, threadIdentifier: currentThreadIdentifier())
+
+        lock.synchronized {
+            currentFrame?.events.append(event)
+        }
+    }
+
+    /// Adds events to a frame that might have already finished, i.e. GPU timestamps that were resolved after fence wait
+    public func add(events: [Event], toFrame index: UInt64) {
+        lock.synchronized {
+            if currentFrame?.index == index {
+                currentFrame?.events.append(contentsOf: events)
+                return
+            }
+
+            if let ringIndex = ring.firstIndex(where: { $0?.index == index }) {
+                ring[ringIndex]?.events.append(contentsOf: events)
+            }
+        }
+    }
+
+    // MARK: - Queries
+
+    /// Finished frames from oldest to newest
+    public var frames: [FrameRecord] {
+        lock.synchronized {
+            (0..<capacity).compactMap { ring[(ringHead + $0) % capacity] }
+        }
+    }
+
+    public var latestFrame: FrameRecord? {
+        lock.synchronized {
+            ring[(ringHead + capacity - 1) % capacity]
+        }
+    }
+
+    public func reset() {
+        lock.synchronized {
+            ring = Array(repeating: nil, count: capacity)
+            ringHead = 0
+            currentFrame = nil
+        }
+    }
+
+    // MARK: - Export
+
+    /// Trace Event Format JSON that can be opened in chrome://tracing or Perfetto
+    public func chromeTraceData() throws -> Data {
+        let frames = self.frames
+        let origin = frames.first?.start ?? 0
+        let processIdentifier = Int(ProcessInfo.processInfo.processIdentifier)
+
+        func microseconds(_ value: UInt64) -> Double {
+            Double(value) / 1000.0
+        }
+
+        var traceEvents: [[String: Any]] = []
+
+        for frame in frames {
+            traceEvents.append([
+                "name": "Frame \(frame.index)",
+                "cat": Category.frame.rawValue,
+                "ph": "X",
+                "ts": microseconds(frame.start - origin),
+                "dur": microseconds(frame.duration),
+                "pid": processIdentifier,
+                "tid": 0,
+            ])
+
+            for event in frame.events where event.start >= origin {
+                traceEvents.append([
+                    "name": event.name,
+                    "cat": event.category.rawValue,
+                    "ph": "X",
+                    "ts": microseconds(event.start - origin),
+                    "dur": microseconds(event.duration),
+                    "pid": processIdentifier,
+                    // smumriak: GPU events get their own track
+                    "tid": event.category == .gpu ? -1 : Int(truncatingIfNeeded: event.threadIdentifier),
+                    "args": ["frame": Int(frame.index)],
+                ])
+            }
+        }
+
+        let root: [String: Any] = [
+            "traceEvents": traceEvents,
+            "displayTimeUnit": "ms",
+        ]
+
+        return try JSONSerialization.data(withJSONObject: root, options: [])
+    }
+
+    public func writeChromeTrace(to url: URL) throws {
+        try chromeTraceData().write(to: url, options: .atomic)
+    }
+
+    // MARK: - Private
+
+    internal func storeFrame(_ frame: FrameRecord) {
+        ring[ringHead] = frame
+        ringHead = (ringHead + 1) % capacity
+    }
+
+    internal func currentThreadIdentifier() -> UInt64 {
+        #if os(Linux)
+            return UInt64(pthread_self())
+        #else
+            return UInt64(UInt(bitPattern: pthread_self()))
+        #endif
+    }
+}
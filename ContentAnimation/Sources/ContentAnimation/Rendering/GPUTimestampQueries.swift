@@ -0,0 +1,99 @@
+//
+//  GPUTimestampQueries.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import TinyFoundation
+import Volcano
+
+internal final class GPUTimestampQueries {
+    internal let queryPool: QueryPool
+    internal let timestampPeriod: Double
+    internal let validBitsMask: UInt64
+
+    internal var labels: [String] = []
+    internal var usedCount: Int = 0
+    internal var frameIndex: UInt64? = nil
+    internal var submitTime: UInt64 = 0
+
+    internal var capacity: Int {
+        queryPool.count
+    }
+
+    internal init?(device: Device, queue: Queue, capacity: Int = 64) throws {
+        let physicalDevice = device.physicalDevice
+        let validBits = physicalDevice.queueFamiliesProperties[queue.familyIndex].timestampValidBits
+
+        // smumriak: queue family does not support timestamps at all
+        if validBits == 0 {
+            return nil
+        }
+
+        validBitsMask = validBits >= 64 ? UInt64.max : (UInt64(1) << UInt64(validBits)) - 1
+        timestampPeriod = Double(physicalDevice.properties.limits.timestampPeriod)
+        queryPool = try QueryPool(device: device, type: .timestamp, count: capacity)
+    }
+
+    /// Must be recorded outside of render pass
+    internal func begin(commandBuffer: CommandBuffer, frameIndex: UInt64?) throws {
+        labels.removeAll(keepingCapacity: true)
+        usedCount = 0
+        self.frameIndex = frameIndex
+
+        try commandBuffer.reset(queryPool: queryPool, range: 0..<capacity)
+    }
+
+    internal func beginScope(_ name: String, commandBuffer: CommandBuffer) throws -> Int? {
+        guard usedCount + 2 <= capacity else {
+            return nil
+        }
+
+        let index = usedCount
+        usedCount += 2
+        labels.append(name)
+
+        try commandBuffer.writeTimestamp(to: queryPool, index: index, stage: .topOfPipe)
+
+        return index
+    }
+
+    internal func endScope(_ index: Int, commandBuffer: CommandBuffer) throws {
+        try commandBuffer.writeTimestamp(to: queryPool, index: index + 1, stage: .bottomOfPipe)
+    }
+
+    internal func markSubmitted() {
+        submitTime = .absoluteTime
+    }
+
+    /// Reads back results and hands them to profiler. Has to be called after the command buffer has finished executing
+    internal func resolve(into profiler: FrameProfiler) throws {
+        guard let frameIndex = frameIndex, usedCount > 0 else {
+            return
+        }
+
+        self.frameIndex = nil
+
+        guard let results = try queryPool.results(in: 0..<usedCount, wait: false) else {
+            return
+        }
+
+        let ticks = results.map { $0 & validBitsMask }
+        let origin = ticks.enumerated().filter { $0.offset % 2 == 0 }.map { $0.element }.min() ?? 0
+
+        // smumriak: there is no shared clock between CPU and GPU without VK_EXT_calibrated_timestamps, so GPU work is anchored at the moment of submission. Durations are exact, offsets are approximate
+        let events: [FrameProfiler.Event] = labels.enumerated().map { labelIndex, name in
+            let start = ticks[labelIndex * 2]
+            let end = ticks[labelIndex * 2 + 1]
+
+            let startOffset = UInt64(Double(start &- origin) * timestampPeriod)
+            let duration = end > start ? UInt64(Double(end - start) * timestampPeriod) : 0
+
+            return FrameProfiler.Event(name: name, category: .gpu, start: submitTime + startOffset, duration: duration, threadIdentifier: 0)
+        }
+
+        profiler.add(events: events, toFrame: frameIndex)
+    }
+}
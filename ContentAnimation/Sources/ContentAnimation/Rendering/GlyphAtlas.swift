@@ -0,0 +1,208 @@
+//
+//  GlyphAtlas.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+@_spi(AppKid) import CairoGraphics
+@_spi(AppKid) import Volcano
+import SimpleGLM
+import LayerRenderingData
+
+#if os(macOS)
+    import class CairoGraphics.CGContext
+    import class CairoGraphics.CGColorSpace
+#endif
+
+extension GlyphInstance: VertexInput {
+    public static func inputBindingDescription(binding: CUnsignedInt = 0) -> VkVertexInputBindingDescription {
+        var result = VkVertexInputBindingDescription()
+        result.binding = 0
+        result.stride = CUnsignedInt(MemoryLayout<Self>.stride)
+        result.inputRate = .instance
+
+        return result
+    }
+}
+
+/// Coverage of every glyph that renderer has drawn, packed in rows of one texture. Glyphs are rasterized once per font, glyph and horizontal subpixel position, so changing text only changes glyph instances. When atlas is full, row that was used least recently is cleared and reused. Rows used during current frame are never evicted
+internal final class GlyphAtlas {
+    internal struct Key: Hashable {
+        let font: GlyphFont
+        let glyph: UInt32
+        let subpixelPosition: Int
+    }
+
+    internal struct Entry: Equatable {
+        /// Pixel rect of the glyph relative to pixel that contains its origin
+        let rect: CGRect
+        /// Min and max corners of the glyph in normalized texture coordinates
+        let textureRect: vec4s
+        /// Index of the row that holds the glyph
+        let row: Int
+    }
+
+    fileprivate struct Row {
+        let y: Int
+        let height: Int
+        var x: Int = 0
+        var lastUsedFrame: UInt64
+        var keys: [Key] = []
+    }
+
+    /// Glyph origins are snapped to quarter of a pixel horizontally and to whole pixels vertically
+    internal static let subpixelPositionsCount = 4
+
+    /// Row heights are rounded up to multiple of this, so glyphs of similar height share rows and evicted rows fit new glyphs
+    internal static let rowHeightGranularity = 8
+
+    internal let width: Int
+    internal let height: Int
+    internal let context: CGContext
+    internal fileprivate(set) var texture: Texture? = nil
+
+    // smumriak: glyphs without ink, like spaces, are cached as nil
+    fileprivate var entries: [Key: Entry?] = [:]
+    fileprivate var rows: [Row] = []
+    fileprivate var frame: UInt64 = 0
+    fileprivate var isDirty: Bool = true
+
+    internal var count: Int { entries.count }
+
+    init(width: Int = 1024, height: Int = 1024) {
+        self.width = width
+        self.height = height
+
+        guard let context = CGContext(width: width, height: height, bitsPerComponent: 8, bytesPerRow: width * 4, colorSpace: CGColorSpace(), bitmapInfo: []) else {
+            fatalError("Error creating context with known arguments")
+        }
+
+        self.context = context
+    }
+
+    /// Rows used from now on belong to the new frame and are protected from eviction until it ends
+    internal func beginFrame() {
+        frame += 1
+    }
+
+    /// Splits horizontal pixel coordinate into whole pixel and index of subpixel position
+    internal static func snap(_ x: Float) -> (pixel: Float, subpixelPosition: Int) {
+        let count = Float(subpixelPositionsCount)
+        let snapped = (x * count).rounded() / count
+        let pixel = snapped.rounded(.down)
+
+        return (pixel, Int(((snapped - pixel) * count).rounded()))
+    }
+
+    internal func entry(for glyph: UInt32, font: GlyphFont, subpixelPosition: Int) -> Entry? {
+        let key = Key(font: font, glyph: glyph, subpixelPosition: subpixelPosition)
+
+        if let entry = entries[key] {
+            if let entry = entry {
+                rows[entry.row].lastUsedFrame = frame
+            }
+
+            return entry
+        }
+
+        let subpixelOffset = CGFloat(subpixelPosition) / CGFloat(GlyphAtlas.subpixelPositionsCount)
+
+        guard let rect = font.pixelBounds(of: glyph, subpixelOffset: subpixelOffset) else {
+            entries[key] = .some(nil)
+            return nil
+        }
+
+        // smumriak: glyph is skipped only if glyphs of current frame alone do not fit in the atlas
+        guard let location = allocate(width: Int(rect.width), height: Int(rect.height)) else {
+            return nil
+        }
+
+        font.draw(glyph, at: CGPoint(x: CGFloat(location.x) - rect.minX + subpixelOffset, y: CGFloat(location.y) - rect.minY), in: context)
+
+        let textureRect = vec4s(Float(location.x) / Float(width),
+                                Float(location.y) / Float(height),
+                                Float(location.x + Int(rect.width)) / Float(width),
+                                Float(location.y + Int(rect.height)) / Float(height))
+
+        let entry = Entry(rect: rect, textureRect: textureRect, row: location.row)
+        entries[key] = entry
+        rows[location.row].keys.append(key)
+        isDirty = true
+
+        return entry
+    }
+
+    /// Uploads atlas if glyphs were added since last upload
+    internal func uploadIfNeeded(renderContext: RenderContext, commandPool: CommandPool) throws -> Texture {
+        if let texture = texture, isDirty == false {
+            return texture
+        }
+
+        let texture = try self.texture ?? context.createTexture(renderStack: renderContext.renderStack, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool)
+
+        context.flush()
+        try context.drawIn(texture: texture, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool, resourcePool: renderContext.renderStack.resourcePool)
+
+        self.texture = texture
+        isDirty = false
+
+        return texture
+    }
+
+    fileprivate func allocate(width: Int, height: Int) -> (x: Int, y: Int, row: Int)? {
+        if width > self.width || height > self.height {
+            return nil
+        }
+
+        let granularity = GlyphAtlas.rowHeightGranularity
+        let rowHeight = min((height + granularity - 1) / granularity * granularity, self.height)
+
+        if let index = rows.indices.first(where: { rows[$0].height == rowHeight && rows[$0].x + width <= self.width }) {
+            return place(width: width, in: index)
+        }
+
+        let nextRowY = rows.last.map { $0.y + $0.height } ?? 0
+
+        if nextRowY + rowHeight <= self.height {
+            rows.append(Row(y: nextRowY, height: rowHeight, lastUsedFrame: frame))
+            return place(width: width, in: rows.count - 1)
+        }
+
+        let evictable = rows.indices
+            .filter { rows[$0].height >= height && rows[$0].lastUsedFrame != frame }
+            .min { rows[$0].lastUsedFrame < rows[$1].lastUsedFrame }
+
+        guard let index = evictable else {
+            return nil
+        }
+
+        evictRow(at: index)
+
+        return place(width: width, in: index)
+    }
+
+    fileprivate func place(width: Int, in index: Int) -> (x: Int, y: Int, row: Int) {
+        let result = (x: rows[index].x, y: rows[index].y, row: index)
+
+        rows[index].x += width
+        rows[index].lastUsedFrame = frame
+
+        return result
+    }
+
+    fileprivate func evictRow(at index: Int) {
+        let row = rows[index]
+
+        row.keys.forEach {
+            entries.removeValue(forKey: $0)
+        }
+
+        context.clear(CGRect(x: 0, y: row.y, width: width, height: row.height))
+
+        rows[index].x = 0
+        rows[index].keys.removeAll()
+        isDirty = true
+    }
+}
@@ -0,0 +1,164 @@
+//
+//  LayerContentsDecoder.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import TinyFoundation
+import SimpleGLM
+@_spi(AppKid) import CairoGraphics
+@_spi(AppKid) import Volcano
+
+#if os(macOS)
+    import class CairoGraphics.CGImage
+    import class CairoGraphics.CGDataProvider
+#endif
+
+/// Data provider and pixel size that layer's texture was requested to be decoded at
+internal final class LayerContentsDecodeRequest {
+    let dataProvider: CGDataProvider
+    let pixelSize: CGSize
+
+    init(dataProvider: CGDataProvider, pixelSize: CGSize) {
+        self.dataProvider = dataProvider
+        self.pixelSize = pixelSize
+    }
+
+    func matches(dataProvider: CGDataProvider, pixelSize: CGSize) -> Bool {
+        self.dataProvider === dataProvider && self.pixelSize == pixelSize
+    }
+}
+
+/// Pixels decoded into staging buffer that wait for renderer to upload them into layer texture
+internal struct DecodedLayerContents {
+    let request: LayerContentsDecodeRequest
+    let stagingBuffer: Buffer
+    let width: Int
+    let height: Int
+
+    func createTexture(resourcePool: ResourcePool, graphicsQueue: Queue, commandPool: CommandPool) throws -> Texture {
+        let textureDescriptor = TextureDescriptor.texture2DDescriptor(pixelFormat: .rgba8UNorm, width: width, height: height, mipmapped: false)
+        textureDescriptor.usage = [.renderTarget, .shaderRead]
+        textureDescriptor.tiling = .optimal
+        textureDescriptor.requiredMemoryProperties = .deviceLocal
+
+        let texture = try resourcePool.texture(with: textureDescriptor)
+
+        try graphicsQueue.oneShot(in: commandPool, wait: true) {
+            try $0.performPredefinedLayoutTransition(for: texture, newLayout: .transferDestinationOptimal)
+            try $0.copyBuffer(from: stagingBuffer, to: texture, texelsPerRow: CUnsignedInt(width), height: CUnsignedInt(height))
+            try $0.performPredefinedLayoutTransition(for: texture, newLayout: .shaderReadOnlyOptimal)
+        }
+
+        // smumriak: one shot submission above has already been waited on
+        resourcePool.recycle(stagingBuffer)
+
+        return texture
+    }
+}
+
+/// Decodes data provider contents of layers on background queue straight into staging buffers from resource pool. Once pixels are ready the layer is marked as needing display on completion queue, renderer uploads them on the next frame and keeps previous texture on screen until then
+internal final class LayerContentsDecoder {
+    static let shared = LayerContentsDecoder()
+
+    internal let queue = DispatchQueue(label: "LayerContentsDecoder", qos: .userInitiated, attributes: .concurrent)
+    internal let completionQueue: DispatchQueue
+
+    init(completionQueue: DispatchQueue = .main) {
+        self.completionQueue = completionQueue
+    }
+
+    /// Does nothing if the same contents at the same pixel size are already decoding or were decoded for this layer
+    func decodeIfNeeded(_ dataProvider: CGDataProvider, pixelSize: CGSize, for layer: CALayer, resourcePool: ResourcePool, graphicsQueue: Queue) {
+        if let request = layer.contentsDecodeRequest, request.matches(dataProvider: dataProvider, pixelSize: pixelSize) {
+            return
+        }
+
+        let request = LayerContentsDecodeRequest(dataProvider: dataProvider, pixelSize: pixelSize)
+        layer.contentsDecodeRequest = request
+
+        queue.async { [weak layer, completionQueue] in
+            let result = Result<DecodedLayerContents?, Error> {
+                try Self.decodeIntoStaging(request, resourcePool: resourcePool, graphicsQueue: graphicsQueue)
+            }
+
+            completionQueue.async {
+                switch result {
+                    case .success(let decoded):
+                        guard let layer = layer, layer.contentsDecodeRequest === request else {
+                            if let decoded = decoded {
+                                resourcePool.recycle(decoded.stagingBuffer)
+                            }
+                            return
+                        }
+
+                        if let previous = layer.decodedContents {
+                            resourcePool.recycle(previous.stagingBuffer)
+                        }
+
+                        layer.decodedContents = decoded
+                        layer.setNeedsDisplay()
+
+                    case .failure(let error):
+                        debugPrint("Could not decode layer contents. Error: \(error)")
+                }
+            }
+        }
+    }
+
+    internal static func decodeIntoStaging(_ request: LayerContentsDecodeRequest, resourcePool: ResourcePool, graphicsQueue: Queue) throws -> DecodedLayerContents? {
+        var stagingBuffer: Buffer? = nil
+        var isMapped = false
+
+        defer {
+            if isMapped {
+                try? stagingBuffer?.memoryChunk.unmapData()
+            }
+        }
+
+        let decodedSize = try CGImage.decode(dataProvider: request.dataProvider, pixelSize: request.pixelSize) { width, height, bytesPerRow in
+            let stagingBufferDescriptor = BufferDescriptor(stagingWithSize: VkDeviceSize(bytesPerRow * height), accessQueues: [graphicsQueue])
+            let buffer = try resourcePool.buffer(with: stagingBufferDescriptor)
+            stagingBuffer = buffer
+
+            let result = try buffer.memoryChunk.mapData()
+            isMapped = true
+            return result
+        }
+
+        guard let size = decodedSize, let stagingBuffer = stagingBuffer else {
+            if let stagingBuffer = stagingBuffer {
+                resourcePool.recycle(stagingBuffer)
+            }
+            return nil
+        }
+
+        return DecodedLayerContents(request: request, stagingBuffer: stagingBuffer, width: size.width, height: size.height)
+    }
+}
+
+internal extension CALayer {
+    /// Uploads pixels of `dataProvider` if they were decoded since last frame and requests decoding if contents at this pixel size were not requested yet. Returns texture that was replaced and has to be retired
+    func updateTexture(from dataProvider: CGDataProvider, pixelSize: CGSize, renderStack: VolcanoRenderStack, graphicsQueue: Queue, commandPool: CommandPool) throws -> Texture? {
+        var replacedTexture: Texture? = nil
+
+        if let decoded = decodedContents {
+            decodedContents = nil
+
+            if decoded.request.dataProvider === dataProvider {
+                replacedTexture = texture
+                texture = try decoded.createTexture(resourcePool: renderStack.resourcePool, graphicsQueue: graphicsQueue, commandPool: commandPool)
+                contentsTextureRect = vec4s(0.0, 0.0, 1.0, 1.0)
+                flags.remove(.needsNewTexture)
+            } else {
+                renderStack.resourcePool.recycle(decoded.stagingBuffer)
+            }
+        }
+
+        LayerContentsDecoder.shared.decodeIfNeeded(dataProvider, pixelSize: pixelSize, for: self, resourcePool: renderStack.resourcePool, graphicsQueue: graphicsQueue)
+
+        return replacedTexture
+    }
+}
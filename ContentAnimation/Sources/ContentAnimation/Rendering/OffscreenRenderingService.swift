@@ -0,0 +1,341 @@
+//
+//  OffscreenRenderingService.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+@_spi(AppKid) import Volcano
+import TinyFoundation
+import STBImageWrite
+
+/// Renders layer trees into offscreen textures and reads them back without any window or display connection. Jobs are pipelined through a ring of slots: while GPU renders one job, previous job is read back and encoded on background queue
+public final class OffscreenRenderingService {
+    public enum Error: Swift.Error {
+        case unsupportedPixelFormat(VkFormat)
+        case encodingFailed
+    }
+
+    public enum ImageFormat {
+        /// Tightly packed RGBA rows, top to bottom
+        case raw
+        case png
+    }
+
+    public struct Job {
+        public var layer: CALayer
+        public var width: Int
+        public var height: Int
+        public var format: ImageFormat
+
+        public init(layer: CALayer, width: Int, height: Int, format: ImageFormat = .png) {
+            self.layer = layer
+            self.width = width
+            self.height = height
+            self.format = format
+        }
+    }
+
+    public struct Image {
+        public let width: Int
+        public let height: Int
+        public let format: ImageFormat
+        public let data: Data
+    }
+
+    internal final class Slot {
+        let renderer: VolcanoRenderer
+        let fence: Fence
+        let readbackCommandBuffer: CommandBuffer
+        var texture: Texture? = nil
+        var readbackBuffer: Buffer? = nil
+        var pending: (index: Int, job: Job)? = nil
+        /// Result of waiting for the fence of pending job, set by completion port
+        var completion: Result<Void, Swift.Error>? = nil
+
+        init(renderStack: VolcanoRenderStack, pixelFormat: VkFormat, fence: Fence) throws {
+            let commandPool = try renderStack.queues.graphics.createCommandPool(flags: .resetCommandBuffer)
+            renderer = try VolcanoRenderer(pixelFormat: pixelFormat, commandPool: commandPool)
+            readbackCommandBuffer = try commandPool.createCommandBuffer()
+            self.fence = fence
+            try fence.reset()
+        }
+    }
+
+    public let renderStack: VolcanoRenderStack
+    public let pixelFormat: VkFormat
+    public let pipelineDepth: Int
+
+    internal let slots: [Slot]
+    internal let encodingQueue = DispatchQueue(label: "OffscreenRenderingService.encoding", qos: .userInitiated, attributes: .concurrent)
+    #if os(Linux)
+        /// Not scheduled in any run loop, it is drained by the thread that renders, so one wake up can harvest completions of several slots
+        internal let completionPort: FenceCompletionPort
+    #endif
+
+    deinit {
+        slots.forEach {
+            if let texture = $0.texture {
+                renderStack.resourcePool.recycle(texture)
+            }
+
+            if let readbackBuffer = $0.readbackBuffer {
+                renderStack.resourcePool.recycle(readbackBuffer)
+            }
+        }
+    }
+
+    /// `pipelineDepth` is number of jobs that can be in flight at the same time
+    public init(renderStack: VolcanoRenderStack = VolcanoRenderStack.global, pixelFormat: VkFormat = .rgba8UNorm, pipelineDepth: Int = 2) throws {
+        // smumriak: stb writes 8 bit per channel rgba, anything else would need conversion on readback
+        guard pixelFormat == .rgba8UNorm || pixelFormat == .r8g8b8a8SRGB else {
+            throw Error.unsupportedPixelFormat(pixelFormat)
+        }
+
+        self.renderStack = renderStack
+        self.pixelFormat = pixelFormat
+        self.pipelineDepth = max(pipelineDepth, 1)
+
+        #if os(Linux)
+            let completionPort = try FenceCompletionPort(device: renderStack.device)
+            self.completionPort = completionPort
+
+            slots = try (0..<self.pipelineDepth).map { _ in
+                try Slot(renderStack: renderStack, pixelFormat: pixelFormat, fence: completionPort.createFence())
+            }
+        #else
+            slots = try (0..<self.pipelineDepth).map { _ in
+                try Slot(renderStack: renderStack, pixelFormat: pixelFormat, fence: Fence(device: renderStack.device))
+            }
+        #endif
+    }
+
+    public func render(_ job: Job) throws -> Image {
+        try render([job])[0]
+    }
+
+    /// Renders every job and returns images in the same order
+    public func render(_ jobs: [Job]) throws -> [Image] {
+        var images = [Image?](repeating: nil, count: jobs.count)
+        let lock = Lock()
+
+        try render(jobs) { index, image in
+            lock.synchronized {
+                images[index] = image
+            }
+        }
+
+        return images.map { $0! }
+    }
+
+    /// Calls `handler` on encoding queue as soon as each image is ready. Returns when every job has been handled
+    public func render(_ jobs: [Job], handler: @escaping (_ index: Int, _ image: Image) -> ()) throws {
+        let group = DispatchGroup()
+        var encodingError: Swift.Error? = nil
+        let errorLock = Lock()
+
+        let encode: (Int, Job, Data) -> () = { index, job, pixels in
+            group.enter()
+            self.encodingQueue.async {
+                defer { group.leave() }
+
+                do {
+                    let data: Data
+                    switch job.format {
+                        case .raw: data = pixels
+                        case .png: data = try Self.encodePNG(pixels, width: job.width, height: job.height)
+                    }
+
+                    handler(index, Image(width: job.width, height: job.height, format: job.format, data: data))
+                } catch {
+                    errorLock.synchronized {
+                        if encodingError == nil {
+                            encodingError = error
+                        }
+                    }
+                }
+            }
+        }
+
+        do {
+            for (index, job) in jobs.enumerated() {
+                let slot = slots[index % slots.count]
+
+                if let pending = slot.pending {
+                    let pixels = try harvest(slot)
+                    encode(pending.index, pending.job, pixels)
+                }
+
+                try submit(job, index: index, in: slot)
+            }
+
+            // smumriak: drain in submission order, oldest job is in the slot right after the last used one
+            for offset in 0..<slots.count {
+                let slot = slots[(jobs.count + offset) % slots.count]
+
+                if let pending = slot.pending {
+                    let pixels = try harvest(slot)
+                    encode(pending.index, pending.job, pixels)
+                }
+            }
+        } catch {
+            // smumriak: slots have to be reusable by the next render call, so every job that is still on GPU is waited for and its frame is ended
+            for slot in slots where slot.pending != nil {
+                do {
+                    try waitForCompletion(of: slot)
+                    try slot.renderer.endFrame()
+                } catch {
+                    debugPrint("Could not finish offscreen job after rendering failure. Error: \(error)")
+                }
+
+                slot.pending = nil
+            }
+
+            group.wait()
+            throw error
+        }
+
+        group.wait()
+
+        if let encodingError = encodingError {
+            throw encodingError
+        }
+    }
+
+    // MARK: - Pipeline stages
+
+    internal func submit(_ job: Job, index: Int, in slot: Slot) throws {
+        try prepareDestination(in: slot, width: job.width, height: job.height)
+
+        let renderer = slot.renderer
+        let texture = slot.texture!
+        let readbackBuffer = slot.readbackBuffer!
+
+        renderer.layer = job.layer
+        try renderer.setDestination(target: texture)
+
+        try renderer.beginFrame(atTime: 0)
+        try renderer.buildRenderOperations()
+        try renderer.performRenderOperations()
+        try renderer.submitCommandBuffer()
+
+        // smumriak: submissions on the same queue are ordered, barrier in readback command buffer waits for color attachment writes of the render submitted right before it
+        let commandBuffer = slot.readbackCommandBuffer
+        try commandBuffer.reset()
+        try commandBuffer.begin(flags: .oneTimeSubmit)
+
+        texture.setLayout(.presentSourceKhr)
+        try commandBuffer.performPredefinedLayoutTransition(for: texture, newLayout: .transferSourceOptimal)
+        try commandBuffer.copyTexture(texture, to: readbackBuffer)
+        try commandBuffer.memoryBarrier(sourceStage: .transfer, destinationStage: .host, sourceAccessMask: .transferWrite, destinationAccessMask: .hostRead)
+
+        try commandBuffer.end()
+
+        try renderStack.queues.graphics.submit(with: SubmitDescriptor(commandBuffers: [commandBuffer], fence: slot.fence))
+
+        slot.pending = (index: index, job: job)
+        slot.completion = nil
+
+        #if os(Linux)
+            do {
+                try completionPort.notify(when: slot.fence) { [unowned slot] result in
+                    slot.completion = result
+                }
+            } catch {
+                // smumriak: job is already on GPU, so if port can not watch the fence it is waited for right away. otherwise slot would never complete
+                slot.completion = Result {
+                    try slot.fence.wait()
+                    try slot.fence.reset()
+                }
+            }
+        #endif
+    }
+
+    /// Waits for the slot's job to finish and resets the fence
+    internal func waitForCompletion(of slot: Slot) throws {
+        #if os(Linux)
+            while slot.completion == nil {
+                try completionPort.waitForEvents()
+            }
+
+            let completion = slot.completion!
+            slot.completion = nil
+
+            try completion.get()
+        #else
+            try slot.fence.wait()
+            try slot.fence.reset()
+        #endif
+    }
+
+    /// Waits for the slot's job to finish and copies pixels out of readback buffer so the slot can be reused right away
+    internal func harvest(_ slot: Slot) throws -> Data {
+        try waitForCompletion(of: slot)
+
+        try slot.renderer.endFrame()
+
+        let readbackBuffer = slot.readbackBuffer!
+        let byteCount = Int(slot.pending!.job.width * slot.pending!.job.height * 4)
+
+        let pixels = try readbackBuffer.memoryChunk.withMappedData { data, _ in
+            Data(bytes: data, count: byteCount)
+        }
+
+        slot.pending = nil
+
+        return pixels
+    }
+
+    internal func prepareDestination(in slot: Slot, width: Int, height: Int) throws {
+        if let texture = slot.texture, texture.width == width, texture.height == height {
+            return
+        }
+
+        let resourcePool = renderStack.resourcePool
+
+        if let texture = slot.texture {
+            resourcePool.recycle(texture)
+        }
+
+        if let readbackBuffer = slot.readbackBuffer {
+            resourcePool.recycle(readbackBuffer)
+        }
+
+        let textureDescriptor = TextureDescriptor.texture2DDescriptor(pixelFormat: pixelFormat, width: width, height: height, mipmapped: false)
+        textureDescriptor.usage = [.renderTarget, .shaderRead]
+        textureDescriptor.requiredMemoryProperties = .deviceLocal
+        slot.texture = try resourcePool.texture(with: textureDescriptor)
+
+        var bufferDescriptor = BufferDescriptor()
+        bufferDescriptor.size = VkDeviceSize(width * height * 4)
+        bufferDescriptor.usage = [.transferDestination]
+        bufferDescriptor.requiredMemoryProperties = [.hostVisible, .hostCoherent]
+        bufferDescriptor.preferredMemoryProperties = [.hostCached]
+        slot.readbackBuffer = try resourcePool.buffer(with: bufferDescriptor)
+    }
+
+    // MARK: - Encoding
+
+    internal static func encodePNG(_ pixels: Data, width: Int, height: Int) throws -> Data {
+        var result = Data()
+
+        let status: CInt = pixels.withUnsafeBytes { pixels in
+            withUnsafeMutablePointer(to: &result) { result in
+                stbi_write_png_to_func({ context, data, size in
+                    guard let context = context, let data = data, size > 0 else {
+                        return
+                    }
+
+                    context.assumingMemoryBound(to: Data.self).pointee.append(data.assumingMemoryBound(to: UInt8.self), count: Int(size))
+                }, result, CInt(width), CInt(height), 4, pixels.baseAddress, CInt(width * 4))
+            }
+        }
+
+        if status == 0 {
+            throw Error.encodingFailed
+        }
+
+        return result
+    }
+}
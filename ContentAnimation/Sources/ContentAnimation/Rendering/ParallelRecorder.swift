@@ -0,0 +1,172 @@
+//
+//  ParallelRecorder.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import Volcano
+import TinyFoundation
+
+internal let kRecordingThreadsCount: Int = ProcessInfo.processInfo.environment["APPKID_RECORDING_THREADS"].flatMap { Int($0) } ?? 1
+
+/// Records runs of draw operations into secondary command buffers on multiple threads and executes them from the primary command buffer in original order. Runs are split only at top level layer subtree boundaries, everything else, including render pass changes, is performed on the rendering thread
+internal final class ParallelRecorder {
+    // smumriak: command pools are externally synchronized, so each recording thread gets its own pool and its own set of reusable secondary command buffers
+    internal final class Slot {
+        let commandPool: CommandPool
+        let lock = Lock()
+        var freeCommandBuffers: [CommandBuffer] = []
+
+        init(queue: Queue) throws {
+            commandPool = try queue.createCommandPool(flags: .resetCommandBuffer)
+        }
+
+        func dequeueCommandBuffer() throws -> CommandBuffer {
+            if let commandBuffer = lock.synchronized({ freeCommandBuffers.popLast() }) {
+                return commandBuffer
+            }
+
+            return try commandPool.createCommandBuffer(level: .secondary)
+        }
+
+        func enqueue(_ commandBuffer: CommandBuffer) {
+            lock.synchronized {
+                freeCommandBuffers.append(commandBuffer)
+            }
+        }
+    }
+
+    internal let threadCount: Int
+    internal let minimumOperationsPerChunk: Int
+    internal let slots: [Slot]
+
+    internal init(queue: Queue, threadCount: Int, minimumOperationsPerChunk: Int = 32) throws {
+        self.threadCount = max(threadCount, 1)
+        self.minimumOperationsPerChunk = minimumOperationsPerChunk
+        slots = try (0..<self.threadCount).map { _ in try Slot(queue: queue) }
+    }
+
+    internal func perform(_ operations: [RenderOperation], in context: RenderContext) throws {
+        context.subpassContents = .secondaryCommandBuffers
+        defer {
+            context.subpassContents = .inline
+        }
+
+        var runStart: Int? = nil
+
+        for (index, operation) in operations.enumerated() {
+            if let operation = operation as? DrawRenderOperation {
+                try operation.prepare(in: context)
+
+                if runStart == nil {
+                    runStart = index
+                }
+            } else {
+                if let start = runStart {
+                    try record(operations, range: start..<index, in: context)
+                    runStart = nil
+                }
+
+                try operation.perform(in: context)
+            }
+        }
+
+        if let start = runStart {
+            try record(operations, range: start..<operations.count, in: context)
+        }
+    }
+
+    internal func record(_ operations: [RenderOperation], range: Range<Int>, in context: RenderContext) throws {
+        let chunks = self.chunks(of: range, boundaries: context.subtreeBoundaries)
+        let renderTarget = context.renderTarget
+        let initialState = try RecordingState(context: context)
+
+        var recorded = [CommandBuffer?](repeating: nil, count: chunks.count)
+        var firstError: Swift.Error? = nil
+        let errorLock = Lock()
+
+        let recordChunk: (Int) -> CommandBuffer? = { chunkIndex in
+            do {
+                let commandBuffer = try self.slots[chunkIndex].dequeueCommandBuffer()
+
+                try commandBuffer.beginSecondary(inheriting: renderTarget.renderPass, framebuffer: renderTarget.framebuffer)
+                try commandBuffer.setViewports([renderTarget.viewport])
+                try commandBuffer.setScissors([renderTarget.renderArea])
+
+                var state = initialState
+
+                for index in chunks[chunkIndex] {
+                    try (operations[index] as! DrawRenderOperation).record(into: commandBuffer, state: &state, context: context)
+                }
+
+                try commandBuffer.end()
+
+                return commandBuffer
+            } catch {
+                errorLock.synchronized {
+                    if firstError == nil {
+                        firstError = error
+                    }
+                }
+
+                return nil
+            }
+        }
+
+        if chunks.count == 1 {
+            recorded[0] = recordChunk(0)
+        } else {
+            recorded.withUnsafeMutableBufferPointer { recorded in
+                DispatchQueue.concurrentPerform(iterations: chunks.count) { chunkIndex in
+                    recorded[chunkIndex] = recordChunk(chunkIndex)
+                }
+            }
+        }
+
+        let commandBuffers = recorded.compactMap { $0 }
+
+        // smumriak: secondary command buffers go back to their slots only after the submission that executes them has completed
+        let retirementQueue = context.retirementQueue
+        let retirementValue = retirementQueue.nextValue
+        for (chunkIndex, commandBuffer) in recorded.enumerated() {
+            if let commandBuffer = commandBuffer {
+                let slot = slots[chunkIndex]
+                retirementQueue.notify(after: retirementValue) {
+                    slot.enqueue(commandBuffer)
+                }
+            }
+        }
+
+        if let firstError = firstError {
+            throw firstError
+        }
+
+        try context.commandBuffer.execute(commandBuffers: commandBuffers)
+    }
+
+    internal func chunks(of range: Range<Int>, boundaries: [Int]) -> [Range<Int>] {
+        Self.chunks(of: range, boundaries: boundaries, threadCount: threadCount, minimumOperationsPerChunk: minimumOperationsPerChunk)
+    }
+
+    /// Splits the range at subtree boundaries and merges neighbouring subtrees into at most `threadCount` contiguous chunks of roughly the same amount of operations
+    internal static func chunks(of range: Range<Int>, boundaries: [Int], threadCount: Int, minimumOperationsPerChunk: Int) -> [Range<Int>] {
+        let threadCount = max(threadCount, 1)
+        let targetCount = max(minimumOperationsPerChunk, (range.count + threadCount - 1) / threadCount)
+
+        var result: [Range<Int>] = []
+        var chunkStart = range.lowerBound
+
+        for boundary in boundaries where boundary > range.lowerBound && boundary < range.upperBound {
+            if boundary - chunkStart >= targetCount {
+                result.append(chunkStart..<boundary)
+                chunkStart = boundary
+            }
+        }
+
+        result.append(chunkStart..<range.upperBound)
+
+        return result
+    }
+}
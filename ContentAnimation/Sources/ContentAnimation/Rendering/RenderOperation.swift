@@ -33,14 +33,28 @@ import LayerRenderingData
     let transferCommandPool: CommandPool
 
     var descriptors: [LayerRenderDescriptor] = []
+    var compactDescriptors: [CompactLayerRenderDescriptor] = []
+    var recordLocations: [LayerRecordLocation] = []
+    var glyphInstances: [GlyphInstance] = []
+    /// Atlas texture that glyph instances of current frame sample from
+    internal var glyphAtlasTexture: Texture? = nil
     var operations: [RenderOperation] = []
 
     internal var currentlyBoundVertexBufferIndex: UInt? = nil
+    internal var subpassContents: VkSubpassContents = .inline
+    internal var subtreeBoundaries: [Int] = []
+    internal var parallelRecorder: ParallelRecorder? = nil
     internal var vertexBufferCopyCount: UInt64 = 0
     internal var vertexBufferCopySemaphore: TimelineSemaphore
 
     public private(set) var disposalBag = DisposalBag()
 
+    // smumriak: everything the frame referenced is kept alive here until graphics queue signals the value of submission that used it, instead of being destroyed inline in `clear()`
+    internal let retirementQueue: RetirementQueue
+
+    internal let gpuTimestamps: GPUTimestampQueries?
+    internal var gpuTimestampScopes: [Int] = []
+
     @usableFromInline internal var sceneRenderTarget: RenderTarget! {
         didSet {
             disposalBag.append(sceneRenderTarget!)
@@ -59,19 +73,60 @@ import LayerRenderingData
     @inlinable @inline(__always)
     internal var commandBuffer: CommandBuffer { commandBuffersStack.first ?? mainCommandBuffer }
 
+    /// Number of layer records appended this frame. Render operations refer to layers by index in range of `0..<layerCount`
+    internal var layerCount: Int { recordLocations.count }
+
+    /// Layers that only have 2D affine transform are stored in compact records, everything else keeps full descriptor
+    internal func append(_ descriptor: LayerRenderDescriptor) {
+        if kCompactLayerRecordsDisabled == false, let compactDescriptor = CompactLayerRenderDescriptor(descriptor) {
+            recordLocations.append(LayerRecordLocation(compact: true, index: UInt(compactDescriptors.count)))
+            compactDescriptors.append(compactDescriptor)
+        } else {
+            recordLocations.append(LayerRecordLocation(compact: false, index: UInt(descriptors.count)))
+            descriptors.append(descriptor)
+        }
+    }
+
     private var _vertexBuffer: Buffer? = nil
+    private var _compactVertexBuffer: Buffer? = nil
+    private var _glyphInstanceBuffer: Buffer? = nil
 
-    var vertexBuffer: Buffer {
+    var vertexBuffer: Buffer? {
         get throws {
-            if let vertexBuffer = _vertexBuffer, vertexBuffer.size == VkDeviceSize(MemoryLayout<LayerRenderDescriptor>.stride * descriptors.count) {
-                return vertexBuffer
-            } else {
-                _vertexBuffer = try createVertexBuffer()
-                return _vertexBuffer!
-            }
+            try reusedVertexBuffer(&_vertexBuffer, size: VkDeviceSize(MemoryLayout<LayerRenderDescriptor>.stride * descriptors.count))
+        }
+    }
+
+    var compactVertexBuffer: Buffer? {
+        get throws {
+            try reusedVertexBuffer(&_compactVertexBuffer, size: VkDeviceSize(MemoryLayout<CompactLayerRenderDescriptor>.stride * compactDescriptors.count))
+        }
+    }
+
+    var glyphInstanceBuffer: Buffer? {
+        get throws {
+            try reusedVertexBuffer(&_glyphInstanceBuffer, size: VkDeviceSize(MemoryLayout<GlyphInstance>.stride * glyphInstances.count))
         }
     }
 
+    private func reusedVertexBuffer(_ buffer: inout Buffer?, size: VkDeviceSize) throws -> Buffer? {
+        if size == 0 {
+            return nil
+        }
+
+        if let existing = buffer, existing.size == size {
+            return existing
+        }
+
+        if let existing = buffer {
+            retirementQueue.recycle(existing)
+        }
+
+        let result = try createVertexBuffer(size: size)
+        buffer = result
+        return result
+    }
+
     let modelViewProjectionBuffer: Buffer
     let modelViewProjectionDescriptorPool: DescriptorPool
     let modelViewProjectionDescriptorSet: DescriptorSet
@@ -91,40 +146,66 @@ import LayerRenderingData
 
     internal let contentsTextureSampler: Sampler
 
-    private func createVertexBuffer() throws -> Buffer {
-        let bufferSize = VkDeviceSize(MemoryLayout<LayerRenderDescriptor>.stride * descriptors.count)
-
+    private func createVertexBuffer(size: VkDeviceSize) throws -> Buffer {
         var vertexBufferDescriptor = BufferDescriptor()
-        vertexBufferDescriptor.size = bufferSize
+        vertexBufferDescriptor.size = size
         vertexBufferDescriptor.usage = [.vertexBuffer, .transferDestination]
         vertexBufferDescriptor.requiredMemoryProperties = .deviceLocal
         vertexBufferDescriptor.setAccessQueues([graphicsQueue, transferQueue])
 
-        let vertexBuffer = try renderStack.device.memoryAllocator.create(with: vertexBufferDescriptor).result
-
-        disposalBag.append(vertexBuffer)
-
-        return vertexBuffer
+        return try renderStack.resourcePool.buffer(with: vertexBufferDescriptor)
     }
 
     internal func populateVertexBuffer() throws {
         let vertexBuffer = try self.vertexBuffer
-        let bufferSize = vertexBuffer.size
+        let compactVertexBuffer = try self.compactVertexBuffer
+        let glyphInstanceBuffer = try self.glyphInstanceBuffer
+
+        let fullSize = vertexBuffer?.size ?? 0
+        let compactSize = compactVertexBuffer?.size ?? 0
+        let glyphsSize = glyphInstanceBuffer?.size ?? 0
+
+        if fullSize + compactSize + glyphsSize == 0 {
+            return
+        }
 
-        let stagingBufferDescriptor = BufferDescriptor(stagingWithSize: bufferSize, accessQueues: [graphicsQueue, transferQueue])
+        // smumriak: both kinds of records and glyph instances go through one staging buffer and one transfer submission
+        let stagingBufferDescriptor = BufferDescriptor(stagingWithSize: fullSize + compactSize + glyphsSize, accessQueues: [graphicsQueue, transferQueue])
 
-        let stagingBuffer = try renderStack.device.memoryAllocator.create(with: stagingBufferDescriptor).result
+        let stagingBuffer = try renderStack.resourcePool.buffer(with: stagingBufferDescriptor)
 
-        try descriptors.withUnsafeBufferPointer { renderDescriptors in
-            try stagingBuffer.memoryChunk.withMappedData { data, size in
-                data.copyMemory(from: UnsafeRawPointer(renderDescriptors.baseAddress!), byteCount: Int(stagingBuffer.size))
+        try stagingBuffer.memoryChunk.withMappedData { data, size in
+            descriptors.withUnsafeBytes {
+                if let baseAddress = $0.baseAddress {
+                    data.copyMemory(from: baseAddress, byteCount: Int(fullSize))
+                }
+            }
+            compactDescriptors.withUnsafeBytes {
+                if let baseAddress = $0.baseAddress {
+                    (data + Int(fullSize)).copyMemory(from: baseAddress, byteCount: Int(compactSize))
+                }
+            }
+            glyphInstances.withUnsafeBytes {
+                if let baseAddress = $0.baseAddress {
+                    (data + Int(fullSize + compactSize)).copyMemory(from: baseAddress, byteCount: Int(glyphsSize))
+                }
             }
         }
 
         try transferQueue.oneShot(in: transferCommandPool, wait: true, semaphores: [vertexBufferCopySemaphore]) {
-            try $0.copyBuffer(from: stagingBuffer, to: vertexBuffer)
+            if let vertexBuffer = vertexBuffer {
+                try $0.copyBuffer(from: stagingBuffer, to: vertexBuffer, size: fullSize)
+            }
+            if let compactVertexBuffer = compactVertexBuffer {
+                try $0.copyBuffer(from: stagingBuffer, to: compactVertexBuffer, sourceOffset: fullSize, size: compactSize)
+            }
+            if let glyphInstanceBuffer = glyphInstanceBuffer {
+                try $0.copyBuffer(from: stagingBuffer, to: glyphInstanceBuffer, sourceOffset: fullSize + compactSize, size: glyphsSize)
+            }
         }
         vertexBufferCopyCount += 1
+
+        renderStack.resourcePool.recycle(stagingBuffer)
     }
 
     internal func contentsDescriptorSet(for texture: Texture, layerIndex: UInt) throws -> DescriptorSet {
@@ -135,9 +216,18 @@ import LayerRenderingData
         }
 
         let descriptorSet = try contentsDescriptorsSetCache.createDescriptorSet(for: textureIdentifier)
-        texture.addDeinitHook { [weak contentsDescriptorsSetCache] in
-            if let contentsDescriptorsSetCache = contentsDescriptorsSetCache {
-                contentsDescriptorsSetCache.releaseDescriptorSet(for: textureIdentifier)
+        // smumriak: cache is keyed by texture address, so the key is removed while texture is still alive and a new texture at the same address can not get stale descriptor set. only reuse of the descriptor set itself waits for GPU and happens on the thread that reclaims
+        texture.addDeinitHook { [weak contentsDescriptorsSetCache, weak retirementQueue] in
+            guard let contentsDescriptorsSetCache = contentsDescriptorsSetCache, let descriptorSet = contentsDescriptorsSetCache.removeDescriptorSet(for: textureIdentifier) else {
+                return
+            }
+
+            if let retirementQueue = retirementQueue {
+                retirementQueue.notify {
+                    contentsDescriptorsSetCache.recycle(descriptorSet)
+                }
+            } else {
+                contentsDescriptorsSetCache.recycle(descriptorSet)
             }
         }
 
@@ -218,21 +308,87 @@ import LayerRenderingData
         contentsDescriptorsSetCache = try DescriptorsSetCache(device: device, layout: descriptorSetsLayouts.contentsSampler, sizes: [(type: .combinedImageSampler, count: 500)], maxSets: 500)
 
         vertexBufferCopySemaphore = try TimelineSemaphore(device: device)
+
+        retirementQueue = try RetirementQueue(device: device, resourcePool: renderStack.resourcePool, reclaimsOnBackgroundQueue: kBackgroundReclamationEnabled)
+
+        if FrameProfiler.isEnabled {
+            gpuTimestamps = try GPUTimestampQueries(device: device, queue: renderStack.queues.graphics)
+        } else {
+            gpuTimestamps = nil
+        }
+    }
+
+    deinit {
+        do {
+            try retirementQueue.drain()
+        } catch {
+            fatalError("Got vulkan error while draining retirement queue of RenderContext: \(error)")
+        }
     }
 
     func clear() throws {
+        // smumriak: operations hold textures that recorded commands sample from, vertex buffer copy semaphore is waited on by the submission
+        retirementQueue.retire(disposalBag)
+        retirementQueue.retire(operations)
+        retirementQueue.retire(vertexBufferCopySemaphore)
+
         disposalBag = DisposalBag()
         descriptors.removeAll()
-        operations.removeAll()
+        compactDescriptors.removeAll()
+        recordLocations.removeAll()
+        glyphInstances.removeAll()
+        glyphAtlasTexture = nil
+        operations = []
         vertexBufferCopyCount = 0
         vertexBufferCopySemaphore = try TimelineSemaphore(device: renderStack.device)
         // _vertexBuffer = nil
         currentlyBoundVertexBufferIndex = nil
+        subtreeBoundaries.removeAll()
+        gpuTimestampScopes.removeAll()
+
+        try FrameProfiler.scope("Reclaim retired objects") {
+            try retirementQueue.reclaim()
+        }
+    }
+
+    /// Texture that is not used by the layer anymore goes back to resource pool once the GPU is done with it
+    internal func retire(texture: Texture?) {
+        if let texture = texture {
+            retirementQueue.recycle(texture)
+        }
+    }
+
+    internal func beginGPUTimestampScope(_ name: String) throws {
+        guard let gpuTimestamps = gpuTimestamps else {
+            return
+        }
+
+        if let index = try gpuTimestamps.beginScope(name, commandBuffer: commandBuffer) {
+            gpuTimestampScopes.append(index)
+        }
+    }
+
+    internal func endGPUTimestampScope() throws {
+        guard let gpuTimestamps = gpuTimestamps, let index = gpuTimestampScopes.popLast() else {
+            return
+        }
+
+        try gpuTimestamps.endScope(index, commandBuffer: commandBuffer)
     }
 
     func performOperations() throws {
         try populateVertexBuffer()
-        try operations.forEach { try $0.perform(in: self) }
+
+        if let parallelRecorder = parallelRecorder, parallelRecorder.threadCount > 1 {
+            try parallelRecorder.perform(operations, in: self)
+        } else {
+            try operations.forEach { try $0.perform(in: self) }
+        }
+    }
+
+    /// Operations added after this call belong to the next top level layer subtree. Parallel recorder splits draw operations only at these points
+    internal func markSubtreeBoundary() {
+        subtreeBoundaries.append(operations.count)
     }
 
     func add(_ operation: RenderOperation) {
@@ -244,78 +400,271 @@ import LayerRenderingData
     }
 }
 
+internal let kEagerPipelinesEnabled: Bool = ProcessInfo.processInfo.environment["APPKID_EAGER_PIPELINES"] != nil
+
+@_spi(AppKid) public extension Notification.Name {
+    /// Posted on main queue when pipeline compiled in background becomes available. Frames recorded before that used fallback variant or skipped text, so they have to be rendered again
+    static let renderPipelineDidCompile = Notification.Name(rawValue: "renderPipelineDidCompile")
+}
+
 extension RenderContext {
-    struct Pipelines {
+    /// Graphics pipelines for layer rendering. Rounded and straight variants share a fragment shader module and differ only by a specialization constant. A variant is compiled on a background thread the first time it is requested, and the non-antialiased variant with the same shape is used until then. Redraw is requested via `renderPipelineDidCompile` notification once the variant is ready. Background compilation failures are thrown from the next lookup of the same pipeline
+    final class Pipelines {
         struct Key: Hashable {
             let type: PipelineType
             let antiAliased: Bool
             let rounded: Bool
+            let compact: Bool
+
+            static var allKeys: [Key] {
+                PipelineType.allCases.flatMap { type in
+                    // smumriak: shadow mask is already shaped and blurred on the CPU, so its fragment shader has no rounded variant
+                    let roundedValues = type == .shadowMask ? [false] : [true, false]
+
+                    return [true, false].flatMap { antiAliased in
+                        roundedValues.flatMap { rounded in
+                            [true, false].map { compact in
+                                Key(type: type, antiAliased: antiAliased, rounded: rounded, compact: compact)
+                            }
+                        }
+                    }
+                }
+            }
         }
 
-        let store: [Key: GraphicsPipeline]
-
         enum PipelineType: CaseIterable {
             case background
             case border
             case contents
+            case shadow
+            case shadowMask
 
-            var fragmentShaderBaseName: String {
+            var fragmentShaderName: String {
                 switch self {
-                    case .background: return "Background"
-                    case .border: return "Border"
-                    case .contents: return "Contents"
+                    case .background: return "BackgroundFragmentShader"
+                    case .border: return "BorderFragmentShader"
+                    case .contents: return "ContentsFragmentShader"
+                    case .shadow: return "ShadowFragmentShader"
+                    case .shadowMask: return "ShadowMaskFragmentShader"
+                }
+            }
+        }
+
+        // smumriak: constant_id 0 of layer fragment shaders is "rounded"
+        fileprivate static let roundedSpecializationConstants = SpecializationConstants(booleans: [0: true])
+        fileprivate static let straightSpecializationConstants = SpecializationConstants(booleans: [0: false])
+
+        fileprivate static let compilationQueue = DispatchQueue(label: "RenderContext.Pipelines.compilation", qos: .userInitiated, attributes: .concurrent)
+
+        let renderPass: RenderPass
+        let subpassIndex: Int
+        let descriptorSetsLayouts: DescriptorSetsLayouts
+
+        fileprivate let vertexShader: Shader
+        fileprivate let compactVertexShader: Shader
+        fileprivate let fragmentShaders: [PipelineType: Shader]
+        fileprivate let glyphVertexShader: Shader
+        fileprivate let glyphFragmentShader: Shader
+
+        fileprivate let lock = Lock()
+        fileprivate var store: [Key: GraphicsPipeline] = [:]
+        fileprivate var pendingCompilations: [Key: DispatchGroup] = [:]
+        fileprivate var failures: [Key: Error] = [:]
+        fileprivate var glyphsPipeline: GraphicsPipeline? = nil
+        fileprivate var isGlyphsPipelinePending = false
+        fileprivate var glyphsPipelineFailure: Error? = nil
+
+        init(renderPass: RenderPass, subpassIndex: Int = 0, descriptorSetsLayouts: DescriptorSetsLayouts, shaderLibrary: ShaderLibrary) throws {
+            self.renderPass = renderPass
+            self.subpassIndex = subpassIndex
+            self.descriptorSetsLayouts = descriptorSetsLayouts
+
+            vertexShader = try shaderLibrary.shader(named: "LayerVertexShader")
+            compactVertexShader = try shaderLibrary.shader(named: "CompactLayerVertexShader")
+            fragmentShaders = try Dictionary(uniqueKeysWithValues: PipelineType.allCases.map {
+                ($0, try shaderLibrary.shader(named: $0.fragmentShaderName))
+            })
+            glyphVertexShader = try shaderLibrary.shader(named: "GlyphVertexShader")
+            glyphFragmentShader = try shaderLibrary.shader(named: "GlyphFragmentShader")
+
+            if kEagerPipelinesEnabled {
+                for key in Key.allKeys {
+                    store[key] = try createPipeline(for: key)
+                }
+                glyphsPipeline = try createGlyphsPipeline()
+            } else {
+                // smumriak: non-antialiased variants are fallbacks for all the others, so they go first
+                lock.synchronized {
+                    Key.allKeys
+                        .filter { $0.antiAliased == false }
+                        .forEach { scheduleCompilation(of: $0) }
+
+                    scheduleGlyphsPipelineCompilation()
+                }
+            }
+        }
+
+        /// Returns requested variant if it was compiled already. Otherwise schedules its compilation and returns non-antialiased variant of the same shape. Only if that one is not ready either the calling thread waits for its compilation. Throws if background compilation of either variant has failed since previous lookup, next lookup compiles it again
+        func pipeline(withType type: PipelineType, antiAliased: Bool, rounded: Bool, compact: Bool) throws -> GraphicsPipeline {
+            let key = Key(type: type, antiAliased: antiAliased, rounded: rounded, compact: compact)
+            let fallbackKey = Key(type: type, antiAliased: false, rounded: rounded, compact: compact)
+
+            while true {
+                let (existing, fallbackCompilation): (GraphicsPipeline?, DispatchGroup?) = try lock.synchronized {
+                    if let result = try takeCompiledPipeline(for: key) {
+                        return (result, nil)
+                    }
+
+                    scheduleCompilation(of: key)
+
+                    if let result = try takeCompiledPipeline(for: fallbackKey) {
+                        return (result, nil)
+                    }
+
+                    scheduleCompilation(of: fallbackKey)
+
+                    return (nil, pendingCompilations[fallbackKey])
+                }
+
+                if let existing = existing {
+                    return existing
                 }
+
+                // smumriak: fallback is already compiling in background, waiting for it is never slower than compiling a duplicate
+                fallbackCompilation?.wait()
             }
         }
 
-        func pipeline(withType type: PipelineType, antiAliased: Bool, rounded: Bool) -> GraphicsPipeline {
-            let key = Key(type: type, antiAliased: antiAliased, rounded: rounded)
+        /// Glyphs pipeline, or nil while it is still being compiled. Throws if background compilation has failed since previous access, next access compiles it again
+        var glyphs: GraphicsPipeline? {
+            get throws {
+                try lock.synchronized {
+                    if let error = glyphsPipelineFailure {
+                        glyphsPipelineFailure = nil
+                        throw error
+                    }
+
+                    if glyphsPipeline == nil {
+                        scheduleGlyphsPipelineCompilation()
+                    }
 
-            return store[key]!
+                    return glyphsPipeline
+                }
+            }
         }
 
-        init(renderPass: RenderPass, subpassIndex: Int = 0, descriptorSetsLayouts: DescriptorSetsLayouts) throws {
-            let vertexShaderName = "LayerVertexShader"
-            let fragmentShaderNameSuffix = "FragmentShader"
+        // smumriak: has to be called with the lock held
+        fileprivate func takeCompiledPipeline(for key: Key) throws -> GraphicsPipeline? {
+            if let error = failures.removeValue(forKey: key) {
+                throw error
+            }
+
+            return store[key]
+        }
 
-            #if os(Linux)
-                let bundle = Bundle.module
-            #else
-                let bundle = Bundle.main
-            #endif
+        // smumriak: has to be called with the lock held
+        fileprivate func scheduleCompilation(of key: Key) {
+            if store[key] != nil || pendingCompilations[key] != nil {
+                return
+            }
 
-            let device = renderPass.device
+            let compilation = DispatchGroup()
+            compilation.enter()
+            pendingCompilations[key] = compilation
 
-            var store: [Key: GraphicsPipeline] = [:]
+            Pipelines.compilationQueue.async { [self] in
+                let result = Result {
+                    try createPipeline(for: key)
+                }
 
-            for type in PipelineType.allCases {
-                let descriptorSetLayouts: [DescriptorSetLayout]
+                lock.synchronized {
+                    switch result {
+                        case .success(let pipeline): store[key] = pipeline
+                        case .failure(let error): failures[key] = error
+                    }
 
-                switch type {
-                    case .background: descriptorSetLayouts = [descriptorSetsLayouts.modelViewProjection]
-                    case .border: descriptorSetLayouts = [descriptorSetsLayouts.modelViewProjection]
-                    case .contents: descriptorSetLayouts = [descriptorSetsLayouts.modelViewProjection, descriptorSetsLayouts.contentsSampler]
+                    pendingCompilations.removeValue(forKey: key)
                 }
 
-                for antiAliased in [true, false] {
-                    for rounded in [true, false] {
-                        let roundedName = rounded ? "Rounded" : "Straight"
+                compilation.leave()
 
-                        let fragmentShaderName = type.fragmentShaderBaseName + roundedName + fragmentShaderNameSuffix
+                Pipelines.requestRedraw()
+            }
+        }
 
-                        let descriptor = renderPass.sharedGraphicsPipelineDescriptor(subpassIndex: subpassIndex, descriptorSetLayouts: descriptorSetLayouts, antiAliased: antiAliased)
-                        descriptor.vertexShader = try device.shader(named: vertexShaderName, in: bundle)
-                        descriptor.fragmentShader = try device.shader(named: fragmentShaderName, in: bundle)
+        // smumriak: has to be called with the lock held
+        fileprivate func scheduleGlyphsPipelineCompilation() {
+            if glyphsPipeline != nil || isGlyphsPipelinePending {
+                return
+            }
 
-                        let key = Key(type: type, antiAliased: antiAliased, rounded: rounded)
-                        let value = try GraphicsPipeline(device: device, descriptor: descriptor)
+            isGlyphsPipelinePending = true
 
-                        store[key] = value
+            Pipelines.compilationQueue.async { [self] in
+                let result = Result {
+                    try createGlyphsPipeline()
+                }
+
+                lock.synchronized {
+                    switch result {
+                        case .success(let pipeline): glyphsPipeline = pipeline
+                        case .failure(let error): glyphsPipelineFailure = error
                     }
+
+                    isGlyphsPipelinePending = false
                 }
+
+                Pipelines.requestRedraw()
+            }
+        }
+
+        // smumriak: failures are requested too, so that next frame throws them instead of silently drawing with fallback forever
+        fileprivate static func requestRedraw() {
+            DispatchQueue.main.async {
+                NotificationCenter.default.post(name: .renderPipelineDidCompile, object: nil)
+            }
+        }
+
+        fileprivate func createPipeline(for key: Key) throws -> GraphicsPipeline {
+            let descriptorSetLayouts: [DescriptorSetLayout]
+
+            switch key.type {
+                case .background: descriptorSetLayouts = [descriptorSetsLayouts.modelViewProjection]
+                case .border: descriptorSetLayouts = [descriptorSetsLayouts.modelViewProjection]
+                case .contents: descriptorSetLayouts = [descriptorSetsLayouts.modelViewProjection, descriptorSetsLayouts.contentsSampler]
+                case .shadow: descriptorSetLayouts = [descriptorSetsLayouts.modelViewProjection]
+                case .shadowMask: descriptorSetLayouts = [descriptorSetsLayouts.modelViewProjection, descriptorSetsLayouts.contentsSampler]
+            }
+
+            let descriptor = renderPass.sharedGraphicsPipelineDescriptor(subpassIndex: subpassIndex, descriptorSetLayouts: descriptorSetLayouts, antiAliased: key.antiAliased)
+
+            // smumriak: compact vertex shader expands compact record into the same outputs as full one, fragment shaders are shared
+            if key.compact {
+                descriptor.vertexShader = compactVertexShader
+                descriptor.vertexInputBindingDescriptions = [CompactLayerRenderDescriptor.inputBindingDescription()]
+                descriptor.inputAttributeDescrioptions = CompactLayerRenderDescriptor.attributesDescriptions()
+            } else {
+                descriptor.vertexShader = vertexShader
             }
 
-            self.store = store
+            descriptor.fragmentShader = fragmentShaders[key.type]
+
+            if key.type != .shadowMask {
+                descriptor.fragmentShaderSpecializationConstants = key.rounded ? Pipelines.roundedSpecializationConstants : Pipelines.straightSpecializationConstants
+            }
+
+            return try GraphicsPipeline(device: renderPass.device, descriptor: descriptor)
+        }
+
+        // smumriak: glyph instances are already in screen pixels and carry their own color, so there is one pipeline for them
+        fileprivate func createGlyphsPipeline() throws -> GraphicsPipeline {
+            let descriptor = renderPass.sharedGraphicsPipelineDescriptor(subpassIndex: subpassIndex, descriptorSetLayouts: [descriptorSetsLayouts.modelViewProjection, descriptorSetsLayouts.contentsSampler], antiAliased: false)
+            descriptor.vertexShader = glyphVertexShader
+            descriptor.vertexInputBindingDescriptions = [GlyphInstance.inputBindingDescription()]
+            descriptor.inputAttributeDescrioptions = GlyphInstance.attributesDescriptions()
+            descriptor.fragmentShader = glyphFragmentShader
+
+            return try GraphicsPipeline(device: renderPass.device, descriptor: descriptor)
         }
     }
 }
@@ -384,11 +733,57 @@ internal class RenderOperation {
     }
 
     @inlinable @inline(__always)
+    static func shadow(antiAliased: Bool, rounded: Bool) -> RenderOperation {
+        return ShadowRenderOperation(antiAliased: antiAliased, rounded: rounded)
+    }
+
+    @inlinable @inline(__always)
+    static func shadowMask(texture: Texture, layerIndex: UInt, antiAliased: Bool) -> RenderOperation {
+        return ShadowMaskRenderOperation(texture: texture, layerIndex: layerIndex, antiAliased: antiAliased)
+    }
+
+    @inlinable @inline(__always)
+    static func glyphs(firstInstance: Int, instanceCount: Int) -> RenderOperation {
+        return GlyphsRenderOperation(firstInstance: firstInstance, instanceCount: instanceCount)
+    }
+
     static func updateModelViewProjection(modelViewProjection: RenderContext.ModelViewProjection) -> RenderOperation {
         return UpdateModelViewProjectionRenderOperation(modelViewProjection: modelViewProjection)
     }
 }
 
+internal struct RecordingState {
+    let vertexBuffer: Buffer?
+    let compactVertexBuffer: Buffer?
+    let glyphInstanceBuffer: Buffer?
+    var boundVertexBufferIndex: UInt? = nil
+    var isCompactRecordBound: Bool = false
+
+    init(context: RenderContext, boundVertexBufferIndex: UInt? = nil) throws {
+        self.vertexBuffer = try context.vertexBuffer
+        self.compactVertexBuffer = try context.compactVertexBuffer
+        self.glyphInstanceBuffer = try context.glyphInstanceBuffer
+        self.boundVertexBufferIndex = boundVertexBufferIndex
+        if let boundVertexBufferIndex = boundVertexBufferIndex {
+            self.isCompactRecordBound = context.recordLocations[Int(boundVertexBufferIndex)].compact
+        }
+    }
+}
+
+/// Operations that only record draw commands into a command buffer that is already inside of render pass. They do not mutate render context, so they can be recorded into secondary command buffers from any thread
+internal class DrawRenderOperation: RenderOperation {
+    override final func perform(in context: RenderContext) throws {
+        var state = try RecordingState(context: context, boundVertexBufferIndex: context.currentlyBoundVertexBufferIndex)
+        try record(into: context.commandBuffer, state: &state, context: context)
+        context.currentlyBoundVertexBufferIndex = state.boundVertexBufferIndex
+    }
+
+    /// Called on rendering thread before parallel recording. Anything that needs synchronization with render context has to be resolved here
+    func prepare(in context: RenderContext) throws {}
+
+    func record(into commandBuffer: CommandBuffer, state: inout RecordingState, context: RenderContext) throws {}
+}
+
 internal class BegineSceneRenderOperation: RenderOperation {
     override func perform(in context: RenderContext) throws {
         guard let commandBuffer = context.mainCommandBuffer else {
@@ -402,19 +797,27 @@ internal class BegineSceneRenderOperation: RenderOperation {
         context.commandBuffersStack.prepend(commandBuffer)
         try commandBuffer.begin()
 
+        if let gpuTimestamps = context.gpuTimestamps {
+            try gpuTimestamps.begin(commandBuffer: commandBuffer, frameIndex: FrameProfiler.shared.currentFrameIndex)
+            try context.beginGPUTimestampScope("Scene")
+        }
+
         context.renderTargetsStack.prepend(renderTarget)
         
         var clearValues: [VkClearValue] = []
         if let clearColor = renderTarget.clearColor {
             clearValues.append(clearColor)
         }
-        try commandBuffer.begin(renderPass: renderTarget.renderPass, framebuffer: renderTarget.framebuffer, renderArea: renderTarget.renderArea, clearValues: clearValues)
+        try commandBuffer.begin(renderPass: renderTarget.renderPass, framebuffer: renderTarget.framebuffer, renderArea: renderTarget.renderArea, clearValues: clearValues, subpassContents: context.subpassContents)
 
-        let viewports = [renderTarget.viewport]
-        let scissors = [renderTarget.renderArea]
-        
-        try commandBuffer.setViewports(viewports)
-        try commandBuffer.setScissors(scissors)
+        // smumriak: subpass that executes secondary command buffers can not contain any other commands, secondary command buffers set their own dynamic state
+        if context.subpassContents == .inline {
+            let viewports = [renderTarget.viewport]
+            let scissors = [renderTarget.renderArea]
+
+            try commandBuffer.setViewports(viewports)
+            try commandBuffer.setScissors(scissors)
+        }
     }
 }
 
@@ -424,6 +827,8 @@ internal class EndSceneRenderOperation: RenderOperation {
 
         try commandBuffer.endRenderPass()
 
+        try context.endGPUTimestampScope()
+
         context.renderTargetsStack.removeFirst()
 
         try commandBuffer.end()
@@ -432,9 +837,8 @@ internal class EndSceneRenderOperation: RenderOperation {
     }
 }
 
-internal class BindVertexBufferRenderOperation: RenderOperation {
+internal class BindVertexBufferRenderOperation: DrawRenderOperation {
     fileprivate let index: UInt
-    fileprivate lazy var offset = VkDeviceSize(index * UInt(MemoryLayout<LayerRenderDescriptor>.stride))
     fileprivate let firstBinding: CUnsignedInt
 
     init(index: UInt, firstBinding: UInt) {
@@ -444,14 +848,23 @@ internal class BindVertexBufferRenderOperation: RenderOperation {
         super.init()
     }
 
-    override func perform(in context: RenderContext) throws {
-        if let currentlyBoundVertexBufferIndex = context.currentlyBoundVertexBufferIndex, currentlyBoundVertexBufferIndex == index {
+    override func record(into commandBuffer: CommandBuffer, state: inout RecordingState, context: RenderContext) throws {
+        if let boundVertexBufferIndex = state.boundVertexBufferIndex, boundVertexBufferIndex == index {
             return
         }
 
-        let vertexBuffer = try context.vertexBuffer
-        try context.commandBuffer.bind(vertexBuffer: vertexBuffer, offset: offset, firstBinding: firstBinding)
-        context.currentlyBoundVertexBufferIndex = index
+        let location = context.recordLocations[Int(index)]
+
+        if location.compact {
+            let offset = VkDeviceSize(location.index * UInt(MemoryLayout<CompactLayerRenderDescriptor>.stride))
+            try commandBuffer.bind(vertexBuffer: state.compactVertexBuffer!, offset: offset, firstBinding: firstBinding)
+        } else {
+            let offset = VkDeviceSize(location.index * UInt(MemoryLayout<LayerRenderDescriptor>.stride))
+            try commandBuffer.bind(vertexBuffer: state.vertexBuffer!, offset: offset, firstBinding: firstBinding)
+        }
+
+        state.boundVertexBufferIndex = index
+        state.isCompactRecordBound = location.compact
     }
 }
 
@@ -505,7 +918,7 @@ internal class ResetFenceRenderOperation: RenderOperation {
     }
 }
 
-internal class BackgroundRenderOperation: RenderOperation {
+internal class BackgroundRenderOperation: DrawRenderOperation {
     internal let antiAliased: Bool
     internal let rounded: Bool
 
@@ -514,9 +927,8 @@ internal class BackgroundRenderOperation: RenderOperation {
         self.rounded = rounded
     }
     
-    override func perform(in context: RenderContext) throws {
-        let commandBuffer = context.commandBuffer
-        let backgroundPipeline = context.pipelines.pipeline(withType: .background, antiAliased: antiAliased, rounded: rounded)
+    override func record(into commandBuffer: CommandBuffer, state: inout RecordingState, context: RenderContext) throws {
+        let backgroundPipeline = try context.pipelines.pipeline(withType: .background, antiAliased: antiAliased, rounded: rounded, compact: state.isCompactRecordBound)
         try commandBuffer.bind(pipeline: backgroundPipeline)
 
         try commandBuffer.bind(descriptorSets: [context.modelViewProjectionDescriptorSet], for: backgroundPipeline)
@@ -525,7 +937,7 @@ internal class BackgroundRenderOperation: RenderOperation {
     }
 }
 
-internal class BorderRenderOperation: RenderOperation {
+internal class BorderRenderOperation: DrawRenderOperation {
     internal let antiAliased: Bool
     internal let rounded: Bool
 
@@ -534,9 +946,8 @@ internal class BorderRenderOperation: RenderOperation {
         self.rounded = rounded
     }
 
-    override func perform(in context: RenderContext) throws {
-        let commandBuffer = context.commandBuffer
-        let borderPipeline = context.pipelines.pipeline(withType: .border, antiAliased: antiAliased, rounded: rounded)
+    override func record(into commandBuffer: CommandBuffer, state: inout RecordingState, context: RenderContext) throws {
+        let borderPipeline = try context.pipelines.pipeline(withType: .border, antiAliased: antiAliased, rounded: rounded, compact: state.isCompactRecordBound)
         try commandBuffer.bind(pipeline: borderPipeline)
 
         try commandBuffer.bind(descriptorSets: [context.modelViewProjectionDescriptorSet], for: borderPipeline)
@@ -561,19 +972,23 @@ internal class PushRenderTargetRenderOperation: RenderOperation {
             try commandBuffer.endRenderPass()
         }
 
+        try context.beginGPUTimestampScope("Offscreen")
+
         context.renderTargetsStack.prepend(renderTarget)
         
         var clearValues: [VkClearValue] = []
         if let clearColor = renderTarget.clearColor {
             clearValues.append(clearColor)
         }
-        try commandBuffer.begin(renderPass: renderTarget.renderPass, framebuffer: renderTarget.framebuffer, renderArea: renderTarget.renderArea, clearValues: clearValues)
+        try commandBuffer.begin(renderPass: renderTarget.renderPass, framebuffer: renderTarget.framebuffer, renderArea: renderTarget.renderArea, clearValues: clearValues, subpassContents: context.subpassContents)
 
-        let viewports = [renderTarget.viewport]
-        let scissors = [renderTarget.renderArea]
-        
-        try commandBuffer.setViewports(viewports)
-        try commandBuffer.setScissors(scissors)
+        if context.subpassContents == .inline {
+            let viewports = [renderTarget.viewport]
+            let scissors = [renderTarget.renderArea]
+
+            try commandBuffer.setViewports(viewports)
+            try commandBuffer.setScissors(scissors)
+        }
     }
 }
 
@@ -591,6 +1006,8 @@ internal class PopRenderTargetRenderOperation: RenderOperation {
 
         try commandBuffer.endRenderPass()
 
+        try context.endGPUTimestampScope()
+
         context.renderTargetsStack.removeFirst()
 
         if rebind {
@@ -600,22 +1017,25 @@ internal class PopRenderTargetRenderOperation: RenderOperation {
             if let clearColor = renderTarget.clearColor {
                 clearValues.append(clearColor)
             }
-            try commandBuffer.begin(renderPass: renderTarget.renderPass, framebuffer: renderTarget.framebuffer, renderArea: renderTarget.renderArea, clearValues: clearValues)
+            try commandBuffer.begin(renderPass: renderTarget.renderPass, framebuffer: renderTarget.framebuffer, renderArea: renderTarget.renderArea, clearValues: clearValues, subpassContents: context.subpassContents)
 
-            let viewports = [renderTarget.viewport]
-            let scissors = [renderTarget.renderArea]
-        
-            try commandBuffer.setViewports(viewports)
-            try commandBuffer.setScissors(scissors)
+            if context.subpassContents == .inline {
+                let viewports = [renderTarget.viewport]
+                let scissors = [renderTarget.renderArea]
+
+                try commandBuffer.setViewports(viewports)
+                try commandBuffer.setScissors(scissors)
+            }
         }
     }
 }
 
-internal class ContentsRenderOperation: RenderOperation {
+internal class ContentsRenderOperation: DrawRenderOperation {
     internal let texture: Texture
     internal let layerIndex: UInt
     internal let antiAliased: Bool
     internal let rounded: Bool
+    internal var descriptorSet: DescriptorSet? = nil
 
     init(texture: Texture, layerIndex: UInt, antiAliased: Bool, rounded: Bool) {
         self.texture = texture
@@ -624,12 +1044,16 @@ internal class ContentsRenderOperation: RenderOperation {
         self.rounded = rounded
     }
 
-    override func perform(in context: RenderContext) throws {
-        let commandBuffer = context.commandBuffer
-        let contentsPipeline = context.pipelines.pipeline(withType: .contents, antiAliased: antiAliased, rounded: rounded)
+    // smumriak: descriptor set cache and descriptor updates are not safe to touch from recording threads
+    override func prepare(in context: RenderContext) throws {
+        descriptorSet = try context.contentsDescriptorSet(for: texture, layerIndex: layerIndex)
+    }
+
+    override func record(into commandBuffer: CommandBuffer, state: inout RecordingState, context: RenderContext) throws {
+        let contentsPipeline = try context.pipelines.pipeline(withType: .contents, antiAliased: antiAliased, rounded: rounded, compact: state.isCompactRecordBound)
         try commandBuffer.bind(pipeline: contentsPipeline)
 
-        let contentsDescriptorSet = try context.contentsDescriptorSet(for: texture, layerIndex: layerIndex)
+        let contentsDescriptorSet = try descriptorSet ?? context.contentsDescriptorSet(for: texture, layerIndex: layerIndex)
 
         try commandBuffer.bind(descriptorSets: [context.modelViewProjectionDescriptorSet, contentsDescriptorSet], for: contentsPipeline)
 
@@ -637,6 +1061,96 @@ internal class ContentsRenderOperation: RenderOperation {
     }
 }
 
+internal class ShadowRenderOperation: DrawRenderOperation {
+    internal let antiAliased: Bool
+    internal let rounded: Bool
+
+    init(antiAliased: Bool = false, rounded: Bool) {
+        self.antiAliased = antiAliased
+        self.rounded = rounded
+    }
+
+    override func record(into commandBuffer: CommandBuffer, state: inout RecordingState, context: RenderContext) throws {
+        let shadowPipeline = try context.pipelines.pipeline(withType: .shadow, antiAliased: antiAliased, rounded: rounded, compact: state.isCompactRecordBound)
+        try commandBuffer.bind(pipeline: shadowPipeline)
+
+        try commandBuffer.bind(descriptorSets: [context.modelViewProjectionDescriptorSet], for: shadowPipeline)
+
+        try commandBuffer.draw(vertexCount: 6)
+    }
+}
+
+internal class ShadowMaskRenderOperation: DrawRenderOperation {
+    internal let texture: Texture
+    internal let layerIndex: UInt
+    internal let antiAliased: Bool
+    internal var descriptorSet: DescriptorSet? = nil
+
+    init(texture: Texture, layerIndex: UInt, antiAliased: Bool) {
+        self.texture = texture
+        self.layerIndex = layerIndex
+        self.antiAliased = antiAliased
+    }
+
+    override func prepare(in context: RenderContext) throws {
+        descriptorSet = try context.contentsDescriptorSet(for: texture, layerIndex: layerIndex)
+    }
+
+    override func record(into commandBuffer: CommandBuffer, state: inout RecordingState, context: RenderContext) throws {
+        let shadowMaskPipeline = try context.pipelines.pipeline(withType: .shadowMask, antiAliased: antiAliased, rounded: false, compact: state.isCompactRecordBound)
+        try commandBuffer.bind(pipeline: shadowMaskPipeline)
+
+        let shadowMaskDescriptorSet = try descriptorSet ?? context.contentsDescriptorSet(for: texture, layerIndex: layerIndex)
+
+        try commandBuffer.bind(descriptorSets: [context.modelViewProjectionDescriptorSet, shadowMaskDescriptorSet], for: shadowMaskPipeline)
+
+        try commandBuffer.draw(vertexCount: 6)
+    }
+}
+
+internal class GlyphsRenderOperation: DrawRenderOperation {
+    internal let firstInstance: Int
+    internal let instanceCount: Int
+    internal var descriptorSet: DescriptorSet? = nil
+
+    init(firstInstance: Int, instanceCount: Int) {
+        self.firstInstance = firstInstance
+        self.instanceCount = instanceCount
+    }
+
+    override func prepare(in context: RenderContext) throws {
+        if let texture = context.glyphAtlasTexture {
+            descriptorSet = try context.contentsDescriptorSet(for: texture, layerIndex: 0)
+        }
+    }
+
+    override func record(into commandBuffer: CommandBuffer, state: inout RecordingState, context: RenderContext) throws {
+        guard let glyphInstanceBuffer = state.glyphInstanceBuffer, let texture = context.glyphAtlasTexture else {
+            return
+        }
+
+        // smumriak: text is skipped until glyphs pipeline finishes compiling in background, redraw is requested when it does
+        guard let glyphsPipeline = try context.pipelines.glyphs else {
+            return
+        }
+
+        try commandBuffer.bind(pipeline: glyphsPipeline)
+
+        let offset = VkDeviceSize(firstInstance * MemoryLayout<GlyphInstance>.stride)
+        try commandBuffer.bind(vertexBuffer: glyphInstanceBuffer, offset: offset)
+
+        // smumriak: glyph instances took the binding of layer records, next layer operation has to bind its record again
+        state.boundVertexBufferIndex = nil
+        state.isCompactRecordBound = false
+
+        let glyphsDescriptorSet = try descriptorSet ?? context.contentsDescriptorSet(for: texture, layerIndex: 0)
+
+        try commandBuffer.bind(descriptorSets: [context.modelViewProjectionDescriptorSet, glyphsDescriptorSet], for: glyphsPipeline)
+
+        try commandBuffer.draw(vertexCount: 6, instanceCount: instanceCount)
+    }
+}
+
 internal class UpdateModelViewProjectionRenderOperation: RenderOperation {
     internal let modelViewProjection: RenderContext.ModelViewProjection
 
@@ -0,0 +1,67 @@
+//
+//  ShaderLibrary.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+@_spi(AppKid) import Volcano
+import TinyFoundation
+
+/// Shader modules of layer rendering. Every module is loaded once per render stack and shared by pipelines of all renderers
+@_spi(AppKid) public final class ShaderLibrary {
+    public static let layerShaderNames: [String] = [
+        "LayerVertexShader",
+        "CompactLayerVertexShader",
+        "GlyphVertexShader",
+        "BackgroundFragmentShader",
+        "BorderFragmentShader",
+        "ContentsFragmentShader",
+        "ShadowFragmentShader",
+        "ShadowMaskFragmentShader",
+        "GlyphFragmentShader",
+    ]
+
+    public let device: Device
+    internal let bundle: Bundle
+
+    fileprivate let lock = Lock()
+    fileprivate var shaders: [String: Shader] = [:]
+
+    public init(device: Device) {
+        self.device = device
+
+        #if os(Linux)
+            bundle = Bundle.module
+        #else
+            bundle = Bundle.main
+        #endif
+    }
+
+    public func shader(named name: String) throws -> Shader {
+        if let shader = lock.synchronized({ shaders[name] }) {
+            return shader
+        }
+
+        let shader = try device.shader(named: name, in: bundle)
+
+        return lock.synchronized {
+            // smumriak: another thread could have loaded the same module first
+            if let existing = shaders[name] {
+                return existing
+            }
+
+            shaders[name] = shader
+
+            return shader
+        }
+    }
+
+    /// Loads every layer shader module. Safe to call from background thread while renderers are being created
+    public func preload() throws {
+        try Self.layerShaderNames.forEach {
+            _ = try shader(named: $0)
+        }
+    }
+}
@@ -0,0 +1,260 @@
+//
+//  ShadowCache.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+@_spi(AppKid) import CairoGraphics
+@_spi(AppKid) import Volcano
+
+/// Blurred coverage textures of shadows that are not plain rounded rectangles, i.e. shadows with `shadowPath` or shaped by layer contents. Textures are kept across frames and keyed by shape, radius and size, so static shadows are blurred once. Shadows shaped by contents are keyed by the layer and blurred again only when its contents version changes
+internal final class ShadowCache {
+    internal struct Key: Hashable {
+        internal enum Shape: Hashable {
+            case path(CGPath)
+            case contents(layer: ObjectIdentifier)
+        }
+
+        let shape: Shape
+        let radius: CGFloat
+        let width: Int
+        let height: Int
+    }
+
+    internal struct Entry {
+        let texture: Texture
+        /// Area covered by the texture in layer coordinates, before shadow offset is applied
+        let rect: CGRect
+        /// Contents version of the layer the texture was blurred from, zero for path shadows
+        let contentsVersion: UInt64
+        var lastUsedFrame: UInt64
+    }
+
+    /// Entries not used for this many frames go back to resource pool
+    internal let maximumUnusedFrames: UInt64 = 120
+
+    private var entries: [Key: Entry] = [:]
+    private var frame: UInt64 = 0
+
+    internal var count: Int { entries.count }
+
+    internal func beginFrame(retireUnusedWith renderContext: RenderContext) {
+        frame += 1
+
+        entries = entries.filter { _, entry in
+            if frame - entry.lastUsedFrame > maximumUnusedFrames {
+                renderContext.retire(texture: entry.texture)
+                return false
+            }
+
+            return true
+        }
+    }
+
+    // smumriak: blur radius of core animation is roughly two standard deviations of gaussian, same as css
+    internal static func sigma(forShadowRadius radius: CGFloat) -> CGFloat {
+        max(radius * 0.5, 0.5)
+    }
+
+    /// Blur is done on downsampled mask, bigger blur hides lower resolution better
+    internal static func downsampleFactor(forSigma sigma: CGFloat, contentsScale: CGFloat) -> CGFloat {
+        min(max(sigma * contentsScale / 2.0, 1.0), 4.0)
+    }
+
+    internal func entry(for layer: CALayer, renderContext: RenderContext, commandPool: CommandPool) throws -> Entry? {
+        let contentsScale = layer.contentsScale
+        let sigma = ShadowCache.sigma(forShadowRadius: layer.shadowRadius)
+        let scale = contentsScale / ShadowCache.downsampleFactor(forSigma: sigma, contentsScale: contentsScale)
+        let padding = (sigma * 3.0).rounded(.up)
+
+        let shape: Key.Shape
+        let shapeRect: CGRect
+
+        if let shadowPath = layer.shadowPath {
+            let boundingBox = shadowPath.boundingBox
+            if boundingBox.isNull || boundingBox.isEmpty {
+                return nil
+            }
+
+            shape = .path(shadowPath)
+            shapeRect = boundingBox
+        } else if let drawable = layer.contents as? TextureDrawable, layer.contentsVersion != 0 {
+            if drawable.width == 0 || drawable.height == 0 {
+                return nil
+            }
+
+            shape = .contents(layer: ObjectIdentifier(layer))
+            shapeRect = CGRect(origin: .zero, size: layer.bounds.size)
+        } else {
+            return nil
+        }
+
+        let rect = shapeRect.insetBy(dx: -padding, dy: -padding)
+        let width = Int((rect.width * scale).rounded(.up))
+        let height = Int((rect.height * scale).rounded(.up))
+
+        if width <= 0 || height <= 0 {
+            return nil
+        }
+
+        let key = Key(shape: shape, radius: layer.shadowRadius, width: width, height: height)
+        let contentsVersion: UInt64
+
+        if case .contents = shape {
+            contentsVersion = layer.contentsVersion
+        } else {
+            contentsVersion = 0
+        }
+
+        if var entry = entries[key] {
+            if entry.contentsVersion == contentsVersion {
+                entry.lastUsedFrame = frame
+                entries[key] = entry
+                return entry
+            }
+
+            // smumriak: contents were redrawn, blurred old ones are never going to be used again. versions are unique across layers, so this also catches new layer that reused address of deallocated one
+            entries.removeValue(forKey: key)
+            renderContext.retire(texture: entry.texture)
+        }
+
+        let mask = CGContext(width: width, height: height, bitsPerComponent: 8, bytesPerRow: width * 4, colorSpace: CGColorSpace(), bitmapInfo: [])!
+
+        switch shape {
+            case .path(let path):
+                mask.scaleBy(x: scale, y: scale)
+                mask.translateBy(x: -rect.minX, y: -rect.minY)
+                mask.fillColor = .black
+                mask.addPath(path)
+                mask.fillPath()
+                mask.flush()
+
+            case .contents:
+                let drawable = layer.contents as! TextureDrawable
+                let interior = CGRect(x: padding * scale, y: padding * scale, width: shapeRect.width * scale, height: shapeRect.height * scale)
+                ShadowCache.downsampleAlpha(of: drawable, into: mask, rect: interior)
+        }
+
+        ShadowCache.blurAlpha(of: mask, sigma: sigma * scale)
+
+        let texture = try mask.createTexture(renderStack: renderContext.renderStack, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool)
+        try mask.drawIn(texture: texture, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool, resourcePool: renderContext.renderStack.resourcePool)
+
+        let entry = Entry(texture: texture, rect: rect, contentsVersion: contentsVersion, lastUsedFrame: frame)
+        entries[key] = entry
+
+        return entry
+    }
+
+    /// Box filters alpha channel of contents into the given pixel rect of the mask
+    internal static func downsampleAlpha(of drawable: TextureDrawable, into mask: CGContext, rect: CGRect) {
+        guard let maskData = mask.data else {
+            return
+        }
+
+        let source = drawable.pixelData.assumingMemoryBound(to: UInt8.self)
+        let destination = maskData.assumingMemoryBound(to: UInt8.self)
+
+        let minX = max(Int(rect.minX), 0)
+        let minY = max(Int(rect.minY), 0)
+        let maxX = min(Int(rect.maxX.rounded(.up)), mask.width)
+        let maxY = min(Int(rect.maxY.rounded(.up)), mask.height)
+
+        if minX >= maxX || minY >= maxY {
+            return
+        }
+
+        let stepX = Double(drawable.width) / Double(rect.width)
+        let stepY = Double(drawable.height) / Double(rect.height)
+
+        for y in minY..<maxY {
+            let sourceMinY = min(Int(Double(CGFloat(y) - rect.minY) * stepY), drawable.height - 1)
+            let sourceMaxY = min(max(Int(Double(CGFloat(y + 1) - rect.minY) * stepY), sourceMinY + 1), drawable.height)
+
+            for x in minX..<maxX {
+                let sourceMinX = min(Int(Double(CGFloat(x) - rect.minX) * stepX), drawable.width - 1)
+                let sourceMaxX = min(max(Int(Double(CGFloat(x + 1) - rect.minX) * stepX), sourceMinX + 1), drawable.width)
+
+                var sum = 0
+                for sourceY in sourceMinY..<sourceMaxY {
+                    let row = source + sourceY * drawable.bytesPerRow
+                    for sourceX in sourceMinX..<sourceMaxX {
+                        // smumriak: cairo stores pixels as native endian ARGB32, alpha is the last byte on little endian
+                        sum += Int(row[sourceX * 4 + 3])
+                    }
+                }
+
+                let alpha = UInt8(sum / ((sourceMaxY - sourceMinY) * (sourceMaxX - sourceMinX)))
+                let pixel = destination + y * mask.bytesPerRow + x * 4
+                pixel[0] = alpha
+                pixel[1] = alpha
+                pixel[2] = alpha
+                pixel[3] = alpha
+            }
+        }
+    }
+
+    /// Separable gaussian blur of alpha channel, result is written as premultiplied black
+    internal static func blurAlpha(of mask: CGContext, sigma: CGFloat) {
+        guard let maskData = mask.data else {
+            return
+        }
+
+        let width = mask.width
+        let height = mask.height
+        let bytesPerRow = mask.bytesPerRow
+        let pixels = maskData.assumingMemoryBound(to: UInt8.self)
+
+        let radius = Int((sigma * 3.0).rounded(.up))
+        let kernel: [Float] = {
+            let values = (-radius...radius).map { offset -> Float in
+                Float(exp(-Double(offset * offset) / (2.0 * Double(sigma * sigma))))
+            }
+            let sum = values.reduce(0, +)
+            return values.map { $0 / sum }
+        }()
+
+        var alpha = [Float](repeating: 0, count: width * height)
+        var temporary = [Float](repeating: 0, count: width * height)
+
+        for y in 0..<height {
+            for x in 0..<width {
+                alpha[y * width + x] = Float(pixels[y * bytesPerRow + x * 4 + 3])
+            }
+        }
+
+        for y in 0..<height {
+            for x in 0..<width {
+                var value: Float = 0
+                for (kernelIndex, weight) in kernel.enumerated() {
+                    let sampleX = x + kernelIndex - radius
+                    if sampleX >= 0 && sampleX < width {
+                        value += alpha[y * width + sampleX] * weight
+                    }
+                }
+                temporary[y * width + x] = value
+            }
+        }
+
+        for y in 0..<height {
+            for x in 0..<width {
+                var value: Float = 0
+                for (kernelIndex, weight) in kernel.enumerated() {
+                    let sampleY = y + kernelIndex - radius
+                    if sampleY >= 0 && sampleY < height {
+                        value += temporary[sampleY * width + x] * weight
+                    }
+                }
+
+                let result = UInt8(min(max(value.rounded(), 0), 255))
+                let pixel = pixels + y * bytesPerRow + x * 4
+                pixel[0] = 0
+                pixel[1] = 0
+                pixel[2] = 0
+                pixel[3] = result
+            }
+        }
+    }
+}
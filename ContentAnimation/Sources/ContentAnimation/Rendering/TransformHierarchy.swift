@@ -0,0 +1,120 @@
+//
+//  TransformHierarchy.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import CairoGraphics
+import SimpleGLM
+
+/// Transforms of layer tree stored in flat arrays in depth first order. Every layer's parent has smaller index and every subtree occupies contiguous range, so when layer geometry changes only the range of its subtree is recomputed, in one batched pass
+internal final class TransformHierarchy {
+    internal private(set) var root: CALayer? = nil
+    internal private(set) var layers: [CALayer] = []
+    internal private(set) var parentIndices: [Int32] = []
+    /// Index past the last layer of the subtree that starts at given index
+    internal private(set) var subtreeEnds: [Int] = []
+    internal private(set) var localTransforms: [mat4s] = []
+    internal private(set) var worldTransforms: [mat4s] = []
+
+    private var versions: [UInt64] = []
+    private var generation: UInt64 = 0
+
+    internal var count: Int { layers.count }
+
+    /// Brings world transforms up to date with the layer tree. Returns number of layers whose world transform was recomputed
+    @discardableResult
+    internal func update(root: CALayer) -> Int {
+        if root !== self.root || generation != root.subtreeGeneration {
+            rebuild(root: root)
+            return count
+        }
+
+        var recomputedCount = 0
+        var index = 0
+
+        while index < count {
+            if layers[index].transformVersion == versions[index] {
+                index += 1
+                continue
+            }
+
+            let subtreeEnd = subtreeEnds[index]
+
+            for subtreeIndex in index..<subtreeEnd where layers[subtreeIndex].transformVersion != versions[subtreeIndex] {
+                let layer = layers[subtreeIndex]
+                localTransforms[subtreeIndex] = layer.localTransform
+                versions[subtreeIndex] = layer.transformVersion
+            }
+
+            compose(range: index..<subtreeEnd)
+
+            recomputedCount += subtreeEnd - index
+            index = subtreeEnd
+        }
+
+        return recomputedCount
+    }
+
+    internal func rebuild(root: CALayer) {
+        self.root = root
+        generation = root.subtreeGeneration
+
+        layers.removeAll(keepingCapacity: true)
+        parentIndices.removeAll(keepingCapacity: true)
+        subtreeEnds.removeAll(keepingCapacity: true)
+        localTransforms.removeAll(keepingCapacity: true)
+        versions.removeAll(keepingCapacity: true)
+
+        append(root, parentIndex: -1)
+
+        worldTransforms = [mat4s](repeating: .identity, count: count)
+        compose(range: 0..<count)
+    }
+
+    private func append(_ layer: CALayer, parentIndex: Int32) {
+        let index = layers.count
+
+        layers.append(layer)
+        parentIndices.append(parentIndex)
+        subtreeEnds.append(index + 1)
+        localTransforms.append(layer.localTransform)
+        versions.append(layer.transformVersion)
+
+        layer.sublayers?.forEach {
+            append($0, parentIndex: Int32(index))
+        }
+
+        subtreeEnds[index] = layers.count
+    }
+
+    private func compose(range: Range<Int>) {
+        localTransforms.withUnsafeBufferPointer { localTransforms in
+            parentIndices.withUnsafeBufferPointer { parentIndices in
+                worldTransforms.withUnsafeMutableBufferPointer { worldTransforms in
+                    mat4s.composeHierarchy(locals: localTransforms, parentIndices: parentIndices, range: range, into: worldTransforms)
+                }
+            }
+        }
+    }
+}
+
+internal extension CALayer {
+    /// Transform from layer's pixel space to superlayer's pixel space
+    var localTransform: mat4s {
+        let bounds = self.bounds
+        let position = self.position
+        let anchorPoint = self.anchorPoint
+        let contentsScale = self.contentsScale
+
+        let anchorPointX = anchorPoint.x * bounds.width * contentsScale
+        let anchorPointY = anchorPoint.y * bounds.height * contentsScale
+
+        // smumriak: position and anchor point translations are folded into one, and inversed anchor point translation is applied as translation by negative offset, so there is no matrix inversion and two multiplications less
+        let translation = mat4s(translationVector: vec3s(x: (position.x - bounds.midX) * contentsScale + anchorPointX, y: (position.y - bounds.midY) * contentsScale + anchorPointY, z: 0.0))
+
+        return (translation * transform.mat4).translated(by: vec3s(x: -anchorPointX, y: -anchorPointY, z: 0.0))
+    }
+}
@@ -27,6 +27,11 @@ import TinyFoundation
     public fileprivate(set) var device: Device
     public fileprivate(set) var queues: Queues
     public let semaphoreWatcher: SemaphoreWatcher
+    public let resourcePool: ResourcePool
+    public let shaderLibrary: ShaderLibrary
+    #if os(Linux)
+        public let fenceCompletionPort: FenceCompletionPort
+    #endif
 
     public static var global: VolcanoRenderStack! = nil
     
@@ -40,6 +45,10 @@ import TinyFoundation
 
     public func cleanup() throws {
         try semaphoreWatcher.runLoop.stop()
+        resourcePool.purge()
+        #if os(Linux)
+            fenceCompletionPort.invalidate()
+        #endif
     }
 
     internal init() throws {
@@ -64,7 +73,12 @@ import TinyFoundation
 
         let queueRequests = [graphicsQueueRequest, transferQueueRequest]
 
-        let vulkanExtensions: Set<DeviceExtension> = [.swapchainKhr]
+        var vulkanExtensions: Set<DeviceExtension> = [.swapchainKhr]
+
+        // smumriak: sync file export lets fence completions be polled from the run loop instead of blocking a watcher thread
+        if physicalDevice.supportedExtensionsVersions[.externalFenceFdKhr] != nil {
+            vulkanExtensions.insert(.externalFenceFdKhr)
+        }
 
         let device = try Device(physicalDevice: physicalDevice, queueRequests: queueRequests, extensions: vulkanExtensions, memoryAllocatorClass: VulkanMemoryAllocator.self)
 
@@ -78,6 +92,14 @@ import TinyFoundation
         
         self.device = device
         self.queues = Queues(graphics: graphicsQueue, transfer: transferQueue)
-        semaphoreWatcher = try SemaphoreWatcher(device: device)
+        #if os(Linux)
+            let fenceCompletionPort = try FenceCompletionPort(device: device)
+            self.fenceCompletionPort = fenceCompletionPort
+            semaphoreWatcher = try SemaphoreWatcher(device: device, completionPort: fenceCompletionPort)
+        #else
+            semaphoreWatcher = try SemaphoreWatcher(device: device)
+        #endif
+        resourcePool = ResourcePool(device: device)
+        shaderLibrary = ShaderLibrary(device: device)
     }
 }
@@ -6,6 +6,7 @@
 //
 
 internal let kMultisamplingEnabled: Bool = ProcessInfo.processInfo.environment["APPKID_MULTISAMPLED_RENDERING"] != nil
+internal let kBackgroundReclamationEnabled: Bool = ProcessInfo.processInfo.environment["APPKID_BACKGROUND_RECLAMATION"] != nil
 
 import Foundation
 import CoreFoundation
@@ -32,7 +33,7 @@ public func measure(_ label: String, _ block: () throws -> Void) rethrows {
         }
     }
 
-    try block()
+    try FrameProfiler.scope(label, block)
 }
 
 internal class DescriptorSetContainer {
@@ -64,8 +65,20 @@ internal class DescriptorSetContainer {
 }
 
 @_spi(AppKid) public class RenderTargetsCache {
-    let lock = RecursiveLock()
-    var renderTargets: [AnyHashable: RenderTarget] = [:]
+    // smumriak: one multisampled attachment can be shared by render targets of all swapchain images, so resolve attachment is part of the key
+    internal struct Key: Hashable {
+        let target: ObjectIdentifier
+        let resolve: ObjectIdentifier?
+
+        init(target: Texture, resolve: Texture?) {
+            self.target = ObjectIdentifier(target)
+            self.resolve = resolve.map { ObjectIdentifier($0) }
+        }
+    }
+
+    // smumriak: render targets are looked up every frame and created only when swapchain changes
+    let lock = ReadWriteLock()
+    var renderTargets: [Key: RenderTarget] = [:]
 
     let renderPass: RenderPass
     let clearColor: VkClearValue
@@ -76,29 +89,31 @@ internal class DescriptorSetContainer {
     }
 
     public func clear() {
-        lock.synchronized {
+        lock.writing {
             renderTargets.removeAll()
         }
     }
 
-    public func existingRenderTarget(for texture: Texture) -> RenderTarget? {
-        lock.synchronized {
-            let textureIdentifier = ObjectIdentifier(texture)
-        
-            return renderTargets[textureIdentifier]
+    public func existingRenderTarget(for texture: Texture, resolve: Texture? = nil) -> RenderTarget? {
+        lock.reading {
+            return renderTargets[Key(target: texture, resolve: resolve)]
         }
     }
 
     public func createRenderTarget(forTarget target: Texture, resolve: Texture?) throws -> RenderTarget {
-        try lock.synchronized {
-            let textureIdentifier = ObjectIdentifier(target)
+        let key = Key(target: target, resolve: resolve)
 
-            if let result = renderTargets[textureIdentifier] {
+        if let result = lock.reading({ renderTargets[key] }) {
+            return result
+        }
+
+        return try lock.writing {
+            if let result = renderTargets[key] {
                 return result
             } else {
                 let result = try RenderTarget(renderPass: renderPass, colorAttachment: target, resolveAttachment: resolve, clearColor: clearColor)
 
-                renderTargets[textureIdentifier] = result
+                renderTargets[key] = result
 
                 return result
             }
@@ -140,8 +155,41 @@ internal class DescriptorSetContainer {
 
     internal var isRendering: Bool = false
 
+    /// Set by the window while it is being resized interactively. Layer textures are over-allocated in size buckets and reused while contents fit into them
+    public var isInLiveResize: Bool = false
+
     open var layer: CALayer? = nil
 
+    internal let transformHierarchy = TransformHierarchy()
+
+    internal let shadowCache = ShadowCache()
+
+    /// Created when first layer with text contents is rendered
+    internal var glyphAtlas: GlyphAtlas? = nil
+
+    internal var parallelRecorder: ParallelRecorder? = nil {
+        didSet {
+            renderContext.parallelRecorder = parallelRecorder
+        }
+    }
+
+    /// Number of threads that record draw operations of top level layer subtrees into secondary command buffers. One means everything is recorded inline into primary command buffer
+    public var recordingThreadsCount: Int {
+        parallelRecorder?.threadCount ?? 1
+    }
+
+    public func setRecordingThreadsCount(_ count: Int) throws {
+        guard count != recordingThreadsCount else {
+            return
+        }
+
+        if count > 1 {
+            parallelRecorder = try ParallelRecorder(queue: queues.graphics, threadCount: count)
+        } else {
+            parallelRecorder = nil
+        }
+    }
+
     public init(pixelFormat: VkFormat, commandPool: CommandPool) throws {
         self.renderStack = VolcanoRenderStack.global
         let device = renderStack.device
@@ -154,10 +202,12 @@ internal class DescriptorSetContainer {
         renderTargetsCache = RenderTargetsCache(renderPass: renderPass)
         let descriptorSetsLayouts = try DescriptorSetsLayouts(device: device)
 
-        let pipelines = try RenderContext.Pipelines(renderPass: renderPass, descriptorSetsLayouts: descriptorSetsLayouts)
+        let pipelines = try RenderContext.Pipelines(renderPass: renderPass, descriptorSetsLayouts: descriptorSetsLayouts, shaderLibrary: renderStack.shaderLibrary)
 
         renderContext = try RenderContext(renderStack: renderStack, pipelines: pipelines, descriptorSetsLayouts: descriptorSetsLayouts)
         self.commandPool = commandPool
+
+        try setRecordingThreadsCount(kRecordingThreadsCount)
     }
 
     // MARK: - Public interface
@@ -178,7 +228,7 @@ internal class DescriptorSetContainer {
     }
 
     public func setDestination(target: Texture, resolve: Texture? = nil) throws {
-        guard renderTarget?.colorAttachment !== target else {
+        guard renderTarget?.colorAttachment !== target || renderTarget?.resolveAttachment !== resolve else {
             return
         }
 
@@ -186,9 +236,10 @@ internal class DescriptorSetContainer {
             renderPass = try device.createMainRenderPass(pixelFormat: target.pixelFormat)
             let descriptorSetsLayouts = renderContext.descriptorSetsLayouts
 
-            let pipelines = try RenderContext.Pipelines(renderPass: renderPass, descriptorSetsLayouts: descriptorSetsLayouts)
+            let pipelines = try RenderContext.Pipelines(renderPass: renderPass, descriptorSetsLayouts: descriptorSetsLayouts, shaderLibrary: renderStack.shaderLibrary)
 
             renderContext = try RenderContext(renderStack: renderStack, pipelines: pipelines, descriptorSetsLayouts: descriptorSetsLayouts)
+            renderContext.parallelRecorder = parallelRecorder
         }
 
         renderTarget = try renderTargetsCache.createRenderTarget(forTarget: target, resolve: resolve)
@@ -214,19 +265,43 @@ internal class DescriptorSetContainer {
 
         renderContext.add(.begineScene())
 
+        shadowCache.beginFrame(retireUnusedWith: renderContext)
+        glyphAtlas?.beginFrame()
+
         var index: UInt = 0
 
-        try traverseLayerTree(for: layer, parentTransform: .identity, index: &index, renderContext: renderContext)
+        try FrameProfiler.scope("Layer tree traversal", category: .traversal) {
+            transformHierarchy.update(root: layer)
+
+            try traverseLayerTree(for: layer, hierarchyIndex: 0, index: &index, renderContext: renderContext)
+        }
         // try traverseLayerTree(for: layer, renderContext: renderContext)
 
+        if let glyphAtlas = glyphAtlas, renderContext.glyphInstances.isEmpty == false {
+            renderContext.glyphAtlasTexture = try glyphAtlas.uploadIfNeeded(renderContext: renderContext, commandPool: commandPool)
+        }
+
         renderContext.add(.endScene())
     }
 
     @_spi(AppKid) public func performRenderOperations() throws {
-        try renderContext.performOperations()
+        try FrameProfiler.scope("Command recording", category: .recording) {
+            try renderContext.performOperations()
+        }
     }
 
     @_spi(AppKid) public func submitCommandBuffer(waitSemaphores: [Volcano.Semaphore] = [], signalSemaphores: [Volcano.Semaphore] = [], signalTimelineSemaphores: [TimelineSemaphore] = [], fence: Fence? = nil) throws {
+        let descriptor = try makeSubmitDescriptor(waitSemaphores: waitSemaphores, signalSemaphores: signalSemaphores, signalTimelineSemaphores: signalTimelineSemaphores, fence: fence)
+
+        try FrameProfiler.scope("Submit", category: .submit) {
+            try renderContext.graphicsQueue.submit(with: descriptor)
+        }
+
+        didSubmitCommandBuffer()
+    }
+
+    /// Describes submission of recorded command buffer without submitting it, so that multiple renderers can go through one queue submission. Has to be followed by `didSubmitCommandBuffer()` once the submission went through
+    @_spi(AppKid) public func makeSubmitDescriptor(waitSemaphores: [Volcano.Semaphore] = [], signalSemaphores: [Volcano.Semaphore] = [], signalTimelineSemaphores: [TimelineSemaphore] = [], fence: Fence? = nil) throws -> SubmitDescriptor {
         let descriptor = try SubmitDescriptor(commandBuffers: [commandBuffer], fence: fence)
         try waitSemaphores.forEach {
             try descriptor.add(.wait($0, stages: .colorAttachmentOutput))
@@ -244,7 +319,23 @@ internal class DescriptorSetContainer {
             try descriptor.add(.wait(renderContext.vertexBufferCopySemaphore, value: renderContext.vertexBufferCopyCount, stages: .vertexInput))
         }
 
-        try renderContext.graphicsQueue.submit(with: descriptor)
+        let retirementQueue = renderContext.retirementQueue
+        let retirementValue = retirementQueue.nextValue
+        try descriptor.add(.signal(retirementQueue.semaphore, value: retirementValue))
+
+        return descriptor
+    }
+
+    @_spi(AppKid) public func didSubmitCommandBuffer() {
+        let retirementQueue = renderContext.retirementQueue
+        retirementQueue.didSubmit(value: retirementQueue.nextValue)
+
+        renderContext.gpuTimestamps?.markSubmitted()
+    }
+
+    /// Reads back GPU timestamps of last submitted frame into frame profiler. Call only after the fence passed to `submitCommandBuffer` has been signaled
+    @_spi(AppKid) public func resolveGPUTimestamps() throws {
+        try renderContext.gpuTimestamps?.resolve(into: FrameProfiler.shared)
     }
 
     public func render(waitSemaphores: [Volcano.Semaphore] = [], signalSemaphores: [Volcano.Semaphore] = [], fence: Fence? = nil) throws {
@@ -286,6 +377,27 @@ internal class DescriptorSetContainer {
                     current.display()
                 }
 
+                let drawableContents: TextureDrawable?
+
+                // smumriak: contents are uploaded before the descriptor is built because descriptor carries the region of the texture that contents were copied into
+                if needsDisplay {
+                    switch layer.contents {
+                        case let .some(image as CGImage):
+                            drawableContents = image
+
+                        case let .some(backingStore as CABackingStore):
+                            backingStore.frontContext.flush()
+                            drawableContents = backingStore
+
+                        default:
+                            drawableContents = nil
+                    }
+
+                    if let drawableContents = drawableContents {
+                        try upload(drawableContents, for: layer)
+                    }
+                }
+
                 let toScreenScaleTransform = mat4s(scaleVector: vec3s(x: bounds.width * contentsScale, y: bounds.height * contentsScale, z: 1.0))
                 // let anchorPointTransform = mat4s(translationVector: vec3s(x: anchorPoint.x * bounds.width * contentsScale, y: anchorPoint.y * bounds.height * contentsScale, z: 0.0))
 
@@ -307,7 +419,7 @@ internal class DescriptorSetContainer {
                                                        position: position.vec2,
                                                        anchorPoint: current.anchorPoint.vec2,
                                                        bounds: bounds.vec4,
-                                                       textureRect: .zero,
+                                                       textureRect: layer.contentsTextureRect,
                                                        backgroundColor: current.backgroundColor?.vec4 ?? .zero,
                                                        borderColor: current.borderColor?.vec4 ?? .zero,
                                                        borderWidth: Float(current.borderWidth),
@@ -319,37 +431,12 @@ internal class DescriptorSetContainer {
                                                        shadowOpacity: Float(current.shadowOpacity),
                                                        padding0: .zero)
 
-                renderContext.descriptors.append(descriptor)
+                renderContext.append(descriptor)
 
                 if let backgroundColor = layer.backgroundColor, backgroundColor.alpha != 0 {
                     renderContext.add(.bindVertexBuffer(index: currentLayerIndex))
                     renderContext.add(.background(antiAliased: true, rounded: layer.cornerRadius > 0.0))
                 }
-        
-                let drawableContents: TextureDrawable?
-
-                if needsDisplay {
-                    switch layer.contents {
-                        case let .some(image as CGImage):
-                            drawableContents = image
-
-                        case let .some(backingStore as CABackingStore):
-                            backingStore.frontContext.flush()
-                            drawableContents = backingStore
-
-                        default:
-                            drawableContents = nil
-                    }
-
-                    if let drawableContents = drawableContents {
-                        if layer.texture == nil || layer.flags.contains(.needsNewTexture) {
-                            layer.texture = try drawableContents.createTexture(renderStack: renderStack, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool)
-                            layer.flags.remove(.needsNewTexture)
-                        }
-
-                        try drawableContents.drawIn(texture: layer.texture!, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool)
-                    }
-                }
 
                 if let layerTexture = layer.texture {
                     renderContext.add(.bindVertexBuffer(index: currentLayerIndex))
@@ -386,44 +473,77 @@ internal class DescriptorSetContainer {
         }
     }
 
-    fileprivate func traverseLayerTree(for layer: CALayer, parentTransform: mat4s, index: inout UInt, renderContext: RenderContext) throws {
+    fileprivate func traverseLayerTree(for layer: CALayer, hierarchyIndex: Int, index: inout UInt, renderContext: RenderContext) throws {
         if layer.isHidden || layer.opacity <= 0.01 {
             return
         }
 
-        let currentLayerIndex = index
         let bounds = layer.bounds
         let position = layer.position
-        let anchorPoint = layer.anchorPoint
         let contentsScale = layer.contentsScale
 
         // let needsOffscreenRendering = layer.needsOffscreenRendering
         let needsDisplay = layer.needsDisplay
 
         if needsDisplay {
-            layer.display()
+            FrameProfiler.scope("Display", category: .display) {
+                layer.display()
+            }
+
+            layer.contentsDidChange()
         }
 
-        let toScreenScaleTransform = mat4s(scaleVector: vec3s(x: bounds.width * contentsScale, y: bounds.height * contentsScale, z: 1.0))
-        let anchorPointTransform = mat4s(translationVector: vec3s(x: anchorPoint.x * bounds.width * contentsScale, y: anchorPoint.y * bounds.height * contentsScale, z: 0.0))
+        let layerLocalTransform = transformHierarchy.worldTransforms[hierarchyIndex]
+
+        // smumriak: shadow gets its own descriptor right before the layer's one, so it is drawn below layer's background and contents
+        if try addShadow(for: layer, layerTransform: layerLocalTransform, index: index, renderContext: renderContext) {
+            index += 1
+        }
+
+        let currentLayerIndex = index
+
+        let drawableContents: TextureDrawable?
+
+        // smumriak: contents are uploaded before the descriptor is built because descriptor carries the region of the texture that contents were copied into
+        if needsDisplay {
+            let uploadScope = FrameProfiler.isEnabled ? FrameProfiler.shared.beginScope("Upload", category: .upload) : nil
+            defer {
+                if let uploadScope = uploadScope {
+                    FrameProfiler.shared.endScope(uploadScope)
+                }
+            }
+
+            switch layer.contents {
+                case let .some(image as CGImage):
+                    drawableContents = image
 
-        let positionTransform = mat4s(translationVector: vec3s(x: (position.x - bounds.midX) * contentsScale, y: (position.y - bounds.midY) * contentsScale, z: 0.0))
+                case let .some(backingStore as CABackingStore):
+                    backingStore.frontContext.flush()
+                    drawableContents = backingStore
 
-        let layerLocalTransform =
-            parentTransform
-                * positionTransform
-                * anchorPointTransform
-                * layer.transform.mat4
-                * anchorPointTransform.inversed
+                case let .some(dataProvider as CGDataProvider):
+                    // smumriak: decoding happens on background queue, previous texture stays on screen until decoded pixels are uploaded
+                    let replacedTexture = try layer.updateTexture(from: dataProvider, pixelSize: bounds.size * contentsScale, renderStack: renderStack, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool)
+                    renderContext.retire(texture: replacedTexture)
+                    drawableContents = nil
 
-        let layerScreenTransform = layerLocalTransform * toScreenScaleTransform
+                default:
+                    drawableContents = nil
+            }
+
+            if let drawableContents = drawableContents {
+                try upload(drawableContents, for: layer)
+            }
+        }
+
+        let layerScreenTransform = layerLocalTransform.scaled(by: vec3s(x: bounds.width * contentsScale, y: bounds.height * contentsScale, z: 1.0))
 
         let descriptor = LayerRenderDescriptor(transform: layerScreenTransform,
                                                contentsTransform: layerScreenTransform,
                                                position: position.vec2,
                                                anchorPoint: layer.anchorPoint.vec2,
                                                bounds: bounds.vec4,
-                                               textureRect: .zero,
+                                               textureRect: layer.contentsTextureRect,
                                                backgroundColor: layer.backgroundColor?.vec4 ?? .zero,
                                                borderColor: layer.borderColor?.vec4 ?? .zero,
                                                borderWidth: Float(layer.borderWidth),
@@ -435,46 +555,36 @@ internal class DescriptorSetContainer {
                                                shadowOpacity: Float(layer.shadowOpacity),
                                                padding0: .zero)
 
-        renderContext.descriptors.append(descriptor)
+        renderContext.append(descriptor)
 
         if let backgroundColor = layer.backgroundColor, backgroundColor.alpha != 0 {
             renderContext.add(.bindVertexBuffer(index: currentLayerIndex))
             renderContext.add(.background(antiAliased: true, rounded: layer.cornerRadius > 0.0))
         }
-        
-        let drawableContents: TextureDrawable?
-
-        if needsDisplay {
-            switch layer.contents {
-                case let .some(image as CGImage):
-                    drawableContents = image
-
-                case let .some(backingStore as CABackingStore):
-                    backingStore.frontContext.flush()
-                    drawableContents = backingStore
-
-                default:
-                    drawableContents = nil
-            }
-
-            if let drawableContents = drawableContents {
-                if layer.texture == nil || layer.flags.contains(.needsNewTexture) {
-                    layer.texture = try drawableContents.createTexture(renderStack: renderStack, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool)
-                    layer.flags.remove(.needsNewTexture)
-                }
-
-                try drawableContents.drawIn(texture: layer.texture!, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool)
-            }
-        }
 
         if let layerTexture = layer.texture {
             renderContext.add(.bindVertexBuffer(index: currentLayerIndex))
             renderContext.add(.contents(texture: layerTexture, layerIndex: currentLayerIndex, antiAliased: false, rounded: layer.cornerRadius > 0.0))
         }
 
+        if let textContents = layer.textContents {
+            addText(textContents, for: layer, layerTransform: layerLocalTransform, renderContext: renderContext)
+        }
+
+        let isRootLayer = layer === self.layer
+
+        var sublayerHierarchyIndex = hierarchyIndex + 1
+
         try layer.sublayers?.forEach {
             index += 1
-            try traverseLayerTree(for: $0, parentTransform: layerLocalTransform, index: &index, renderContext: renderContext)
+
+            if isRootLayer {
+                renderContext.markSubtreeBoundary()
+            }
+
+            try traverseLayerTree(for: $0, hierarchyIndex: sublayerHierarchyIndex, index: &index, renderContext: renderContext)
+
+            sublayerHierarchyIndex = transformHierarchy.subtreeEnds[sublayerHierarchyIndex]
         }
 
         if layer.borderWidth > 0, let borderColor = layer.borderColor, borderColor.alpha != 0 {
@@ -482,6 +592,152 @@ internal class DescriptorSetContainer {
             renderContext.add(.border(antiAliased: true, rounded: layer.cornerRadius > 0.0))
         }
     }
+
+    fileprivate func upload(_ drawableContents: TextureDrawable, for layer: CALayer) throws {
+        let texture: Texture
+
+        // smumriak: texture that was over-allocated during live resize is kept after it ends until contents change size again
+        let allowsLargerTexture = isInLiveResize || layer.flags.contains(.needsNewTexture) == false
+
+        if let existing = layer.texture, drawableContents.fits(in: existing, allowsLargerTexture: allowsLargerTexture) {
+            texture = existing
+        } else {
+            renderContext.retire(texture: layer.texture)
+            texture = try drawableContents.createTexture(renderStack: renderStack, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool, bucketed: isInLiveResize)
+            layer.texture = texture
+        }
+
+        layer.flags.remove(.needsNewTexture)
+        layer.contentsTextureRect = drawableContents.textureRect(in: texture)
+
+        try drawableContents.drawIn(texture: texture, graphicsQueue: renderContext.graphicsQueue, commandPool: commandPool, resourcePool: renderStack.resourcePool)
+    }
+
+    /// Appends glyph instances of layer's text and draw operation for them. Glyph origins are snapped in screen pixels, quads follow 2D part of layer transform
+    fileprivate func addText(_ textContents: CATextContents, for layer: CALayer, layerTransform: mat4s, renderContext: RenderContext) {
+        let glyphs = textContents.shapedText.glyphs
+
+        if glyphs.isEmpty {
+            return
+        }
+
+        let glyphAtlas: GlyphAtlas = {
+            if let glyphAtlas = self.glyphAtlas {
+                return glyphAtlas
+            }
+
+            let result = GlyphAtlas()
+            self.glyphAtlas = result
+            return result
+        }()
+
+        let bounds = layer.bounds
+        let contentsScale = layer.contentsScale
+        let color = textContents.color.vec4
+        let textOriginX = Float((textContents.origin.x - bounds.minX) * contentsScale)
+        let textOriginY = Float((textContents.origin.y - bounds.minY) * contentsScale)
+
+        let firstInstance = renderContext.glyphInstances.count
+
+        for glyph in glyphs {
+            let x = textOriginX + Float(glyph.position.x)
+            let y = textOriginY + Float(glyph.position.y)
+
+            let screenX = layerTransform.m00 * x + layerTransform.m10 * y + layerTransform.m30
+            let screenY = layerTransform.m01 * x + layerTransform.m11 * y + layerTransform.m31
+
+            let snapped = GlyphAtlas.snap(screenX)
+
+            guard let entry = glyphAtlas.entry(for: glyph.glyph, font: glyph.font, subpixelPosition: snapped.subpixelPosition) else {
+                continue
+            }
+
+            let minX = Float(entry.rect.minX)
+            let minY = Float(entry.rect.minY)
+            let width = Float(entry.rect.width)
+            let height = Float(entry.rect.height)
+
+            let origin = vec2s(snapped.pixel + layerTransform.m00 * minX + layerTransform.m10 * minY,
+                               screenY.rounded() + layerTransform.m01 * minX + layerTransform.m11 * minY)
+
+            renderContext.glyphInstances.append(GlyphInstance(origin: origin,
+                                                              xAxis: vec2s(layerTransform.m00 * width, layerTransform.m01 * width),
+                                                              yAxis: vec2s(layerTransform.m10 * height, layerTransform.m11 * height),
+                                                              padding0: .zero,
+                                                              textureRect: entry.textureRect,
+                                                              color: color))
+        }
+
+        let instanceCount = renderContext.glyphInstances.count - firstInstance
+
+        if instanceCount > 0 {
+            renderContext.add(.glyphs(firstInstance: firstInstance, instanceCount: instanceCount))
+        }
+    }
+
+    /// Appends descriptor and draw operation of layer's shadow. Layers with visible background and no shadow path get analytic rounded rectangle shadow evaluated in fragment shader, shadow path and contents get blurred mask from shadow cache. Returns false if layer casts no shadow
+    fileprivate func addShadow(for layer: CALayer, layerTransform: mat4s, index: UInt, renderContext: RenderContext) throws -> Bool {
+        guard layer.shadowOpacity > 0.0, let shadowColor = layer.shadowColor, shadowColor.alpha != 0 else {
+            return false
+        }
+
+        let bounds = layer.bounds
+        let contentsScale = layer.contentsScale
+        let shadowOffset = layer.shadowOffset
+        let sigma = ShadowCache.sigma(forShadowRadius: layer.shadowRadius)
+
+        let quadRect: CGRect
+        let casterRect: CGRect
+        let operation: RenderOperation
+
+        if layer.shadowPath == nil, let backgroundColor = layer.backgroundColor, backgroundColor.alpha != 0 {
+            let padding = (sigma * 3.0).rounded(.up)
+
+            quadRect = CGRect(origin: .zero, size: bounds.size).offsetBy(dx: shadowOffset.width, dy: shadowOffset.height).insetBy(dx: -padding, dy: -padding)
+            casterRect = CGRect(x: padding, y: padding, width: bounds.width, height: bounds.height)
+            operation = .shadow(antiAliased: true, rounded: layer.cornerRadius > 0.0)
+        } else {
+            let entry = try FrameProfiler.scope("Shadow mask", category: .upload) {
+                try shadowCache.entry(for: layer, renderContext: renderContext, commandPool: commandPool)
+            }
+
+            guard let entry = entry else {
+                return false
+            }
+
+            quadRect = entry.rect.offsetBy(dx: shadowOffset.width, dy: shadowOffset.height)
+            casterRect = CGRect(origin: .zero, size: quadRect.size)
+            operation = .shadowMask(texture: entry.texture, layerIndex: index, antiAliased: false)
+        }
+
+        let shadowTransform = layerTransform
+            .translated(by: vec3s(x: quadRect.minX * contentsScale, y: quadRect.minY * contentsScale, z: 0.0))
+            .scaled(by: vec3s(x: quadRect.width * contentsScale, y: quadRect.height * contentsScale, z: 1.0))
+
+        let descriptor = LayerRenderDescriptor(transform: shadowTransform,
+                                               contentsTransform: shadowTransform,
+                                               position: layer.position.vec2,
+                                               anchorPoint: layer.anchorPoint.vec2,
+                                               bounds: CGRect(origin: .zero, size: quadRect.size).vec4,
+                                               textureRect: casterRect.vec4,
+                                               backgroundColor: .zero,
+                                               borderColor: .zero,
+                                               borderWidth: 0.0,
+                                               cornerRadius: Float(layer.cornerRadius),
+                                               masksToBounds: 0,
+                                               shadowOffset: shadowOffset.vec2,
+                                               shadowColor: shadowColor.vec4,
+                                               shadowRadius: Float(sigma),
+                                               shadowOpacity: Float(layer.shadowOpacity),
+                                               padding0: .zero)
+
+        renderContext.append(descriptor)
+
+        renderContext.add(.bindVertexBuffer(index: index))
+        renderContext.add(operation)
+
+        return true
+    }
 }
 
 public extension VolcanoRenderer {
@@ -638,7 +894,8 @@ internal extension Device {
             let colorAttachment = Attachment(description: colorAttachmentDescription, imageLayout: .colorAttachmentOptimal)
             let resolveAttachment = Attachment(description: resolveAttachmentDescription, imageLayout: .colorAttachmentOptimal)
             subpass1 = Subpass(bindPoint: .graphics, colorAttachments: [colorAttachment], resolveAttachments: [resolveAttachment])
-            dependency1 = Subpass.Dependency(destination: subpass1, sourceStage: .colorAttachmentOutput, destinationStage: .colorAttachmentOutput, destinationAccess: .colorAttachmentWrite)
+            // smumriak: multisampled attachment is shared between frames, so writes of previous frame to it have to complete before the next frame clears it
+            dependency1 = Subpass.Dependency(destination: subpass1, sourceStage: .colorAttachmentOutput, destinationStage: .colorAttachmentOutput, sourceAccess: .colorAttachmentWrite, destinationAccess: .colorAttachmentWrite)
 
         } else {
             var colorAttachmentDescription = VkAttachmentDescription()
@@ -665,36 +922,66 @@ internal protocol TextureDrawable {
     var height: Int { get }
     var bytesPerRow: Int { get }
     var pixelData: UnsafeRawPointer { get }
+
+    func contentsDidUpload()
 }
 
+internal let kTextureBucketSize: Int = 256
+
 extension TextureDrawable {
-    func createTexture(renderStack: VolcanoRenderStack, graphicsQueue: Queue, commandPool: CommandPool, semaphores: [TimelineSemaphore] = []) throws -> Texture {
-        let device = renderStack.device
+    func contentsDidUpload() {}
+
+    /// Texture that has exactly the size of contents is always reused. Larger texture is reused only when `allowsLargerTexture` is true, i.e. during live resize
+    func fits(in texture: Texture, allowsLargerTexture: Bool) -> Bool {
+        if allowsLargerTexture {
+            return texture.width >= width && texture.height >= height
+        } else {
+            return texture.width == width && texture.height == height
+        }
+    }
+
+    /// Normalized region of the texture that is covered by contents, contents are always copied into top left corner
+    func textureRect(in texture: Texture) -> vec4s {
+        vec4s(0.0, 0.0, Float(width) / Float(texture.width), Float(height) / Float(texture.height))
+    }
+
+    /// Bucketed textures are rounded up to multiples of `kTextureBucketSize` so layer that is resized continuously keeps the same texture for many frames
+    func createTexture(renderStack: VolcanoRenderStack, graphicsQueue: Queue, commandPool: CommandPool, semaphores: [TimelineSemaphore] = [], bucketed: Bool = false) throws -> Texture {
+        let width = bucketed ? (self.width + kTextureBucketSize - 1) / kTextureBucketSize * kTextureBucketSize : self.width
+        let height = bucketed ? (self.height + kTextureBucketSize - 1) / kTextureBucketSize * kTextureBucketSize : self.height
 
         let textureDescriptor = TextureDescriptor.texture2DDescriptor(pixelFormat: .rgba8UNorm, width: width, height: height, mipmapped: false)
         textureDescriptor.usage = [.renderTarget, .shaderRead]
         textureDescriptor.tiling = .optimal
         textureDescriptor.requiredMemoryProperties = .deviceLocal
 
-        return try device.createTexture(with: textureDescriptor)
+        return try renderStack.resourcePool.texture(with: textureDescriptor)
     }
 
-    func drawIn(texture: Texture, graphicsQueue: Queue, commandPool: CommandPool, semaphores: [TimelineSemaphore] = []) throws {
+    func drawIn(texture: Texture, graphicsQueue: Queue, commandPool: CommandPool, semaphores: [TimelineSemaphore] = [], resourcePool: ResourcePool? = nil) throws {
         let device = texture.device
 
         let stagingBufferDescriptor = BufferDescriptor(stagingWithSize: VkDeviceSize(bytesPerRow * height), accessQueues: [graphicsQueue])
 
-        let stagingBuffer = try device.memoryAllocator.create(with: stagingBufferDescriptor).result
+        let stagingBuffer = try resourcePool?.buffer(with: stagingBufferDescriptor) ?? device.memoryAllocator.create(with: stagingBufferDescriptor).result
 
         try stagingBuffer.memoryChunk.withMappedData { data, size in
             data.copyMemory(from: UnsafeRawPointer(pixelData), byteCount: Int(stagingBuffer.size))
         }
 
+        contentsDidUpload()
+
+        // smumriak: texture can be larger than contents during live resize, the rest of it is never sampled
+        let textureRect = VkRect3D(offset: .zero, extent: VkExtent3D(width: CUnsignedInt(width), height: CUnsignedInt(height), depth: 1))
+
         try graphicsQueue.oneShot(in: commandPool, wait: true, semaphores: semaphores) {
             try $0.performPredefinedLayoutTransition(for: texture, newLayout: .transferDestinationOptimal)
-            try $0.copyBuffer(from: stagingBuffer, to: texture, texelsPerRow: CUnsignedInt(width), height: CUnsignedInt(height))
+            try $0.copyBuffer(from: stagingBuffer, to: texture, texelsPerRow: CUnsignedInt(width), height: CUnsignedInt(height), textureRect: textureRect)
             try $0.performPredefinedLayoutTransition(for: texture, newLayout: .shaderReadOnlyOptimal)
         }
+
+        // smumriak: one shot submission above has already been waited on
+        resourcePool?.recycle(stagingBuffer)
     }
 }
 
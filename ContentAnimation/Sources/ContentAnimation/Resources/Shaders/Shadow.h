@@ -0,0 +1,71 @@
+//
+//  Shadow.h
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+// smumriak: closed form of rectangle convolved with gaussian is a product of two erf differences. rounded corners are approximated by integrating over y with a few samples. based on "Fast Rounded Rectangle Shadows" by Evan Wallace
+
+vec4 erf4(vec4 x)
+{
+    vec4 s = sign(x);
+    vec4 a = abs(x);
+    x = 1.0 + (0.278393 + (0.230389 + 0.078108 * (a * a)) * a) * a;
+    x *= x;
+    return s - s / (x * x);
+}
+
+vec2 erf2(vec2 x)
+{
+    vec2 s = sign(x);
+    vec2 a = abs(x);
+    x = 1.0 + (0.278393 + (0.230389 + 0.078108 * (a * a)) * a) * a;
+    x *= x;
+    return s - s / (x * x);
+}
+
+float gaussian(float x, float sigma)
+{
+    const float pi = 3.141592653589793;
+    return exp(-(x * x) / (2.0 * sigma * sigma)) / (sqrt(2.0 * pi) * sigma);
+}
+
+// rect is origin and size, like layer bounds
+float rectShadow(vec2 measuredPoint, vec4 rect, float sigma)
+{
+    vec4 query = vec4(measuredPoint - rect.xy, measuredPoint - (rect.xy + rect.zw));
+    vec4 integral = 0.5 + 0.5 * erf4(query * (sqrt(0.5) / sigma));
+    return (integral.z - integral.x) * (integral.w - integral.y);
+}
+
+float roundedRectShadowX(float x, float y, float sigma, float cornerRadius, vec2 halfSize)
+{
+    float delta = min(halfSize.y - cornerRadius - abs(y), 0.0);
+    float curved = halfSize.x - cornerRadius + sqrt(max(0.0, cornerRadius * cornerRadius - delta * delta));
+    vec2 integral = 0.5 + 0.5 * erf2((x + vec2(-curved, curved)) * (sqrt(0.5) / sigma));
+    return integral.y - integral.x;
+}
+
+float roundedRectShadow(vec2 measuredPoint, vec4 rect, float cornerRadius, float sigma)
+{
+    vec2 halfSize = rect.zw * 0.5;
+    vec2 point = measuredPoint - (rect.xy + halfSize);
+    cornerRadius = min(cornerRadius, min(halfSize.x, halfSize.y));
+
+    float low = point.y - halfSize.y;
+    float high = point.y + halfSize.y;
+    float start = clamp(-3.0 * sigma, low, high);
+    float end = clamp(3.0 * sigma, low, high);
+
+    float step = (end - start) / 4.0;
+    float y = start + step * 0.5;
+    float value = 0.0;
+
+    for (int i = 0; i < 4; i++) {
+        value += roundedRectShadowX(point.x, point.y - y, sigma, cornerRadius, halfSize) * gaussian(y, sigma) * step;
+        y += step;
+    }
+
+    return value;
+}
@@ -0,0 +1,27 @@
+//
+//  CompactLayerRenderDescriptor.h
+//  AppKid
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+#ifndef __VOLCANO_SL__
+#include <cglm/struct.h>
+#endif
+
+// layers with 2D affine transform. vec4s fields are at offsets aligned by 16
+struct CompactLayerRenderDescriptor {
+  vec4s affine;                              // +16 bytes, m00 m01 m10 m11 of transform
+  vec2s translation;                         // +8 bytes, m30 m31 of transform
+  vec2s boundsOrigin;                        // +8 bytes
+  vec2s boundsSize;                          // +8 bytes
+  unsigned int backgroundColor;              // +4 bytes, unorm8 rgba
+  unsigned int borderColor;                  // +4 bytes, unorm8 rgba
+  vec4s textureRect;                         // +16 bytes
+  unsigned int shadowColor;                  // +4 bytes, unorm8 rgba
+  unsigned int borderWidthAndCornerRadius;   // +4 bytes, two half floats
+  unsigned int shadowRadiusAndOpacity;       // +4 bytes, two half floats
+  unsigned int flags;                        // +4 bytes
+
+  // Total: 80 bytes
+};
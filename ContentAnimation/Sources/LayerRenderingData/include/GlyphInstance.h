@@ -0,0 +1,22 @@
+//
+//  GlyphInstance.h
+//  AppKid
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+#ifndef __VOLCANO_SL__
+#include <cglm/struct.h>
+#endif
+
+// one quad of glyph atlas, already transformed to screen pixels. vec4s fields are at offsets aligned by 16
+struct GlyphInstance {
+  vec2s origin;       // +8 bytes, top left corner of the quad
+  vec2s xAxis;        // +8 bytes, top edge of the quad
+  vec2s yAxis;        // +8 bytes, left edge of the quad
+  vec2s padding0;     // +8 bytes
+  vec4s textureRect;  // +16 bytes, min and max corners in atlas
+  vec4s color;        // +16 bytes
+
+  // Total: 64 bytes
+};
@@ -0,0 +1,103 @@
+//
+//  CABackingStorePoolTests.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import ContentAnimation
+import CairoGraphics
+
+final class CABackingStorePoolTests: XCTestCase {
+    func testBucketCapacity() {
+        XCTAssertEqual(CABackingStorePool.bucketCapacity(for: 1), 4096)
+        XCTAssertEqual(CABackingStorePool.bucketCapacity(for: 4096), 4096)
+
+        // smumriak: quarter steps of the lower power of two
+        XCTAssertEqual(CABackingStorePool.bucketCapacity(for: 4097), 5120)
+        XCTAssertEqual(CABackingStorePool.bucketCapacity(for: 8192), 8192)
+        XCTAssertEqual(CABackingStorePool.bucketCapacity(for: 9000), 10240)
+        XCTAssertEqual(CABackingStorePool.bucketCapacity(for: 10240), 10240)
+        XCTAssertEqual(CABackingStorePool.bucketCapacity(for: 10241), 12288)
+    }
+
+    func testReturnedBufferIsReusedForSameBucket() {
+        let pool = CABackingStorePool(memoryBudget: 1024 * 1024)
+
+        let buffer = pool.dequeueBuffer(byteCount: 10000)
+        XCTAssertEqual(buffer.capacity, 10240)
+        XCTAssertEqual(pool.usedBytes, 10240)
+        XCTAssertEqual(pool.cachedBytes, 0)
+
+        pool.enqueueBuffer(buffer)
+        XCTAssertEqual(pool.usedBytes, 0)
+        XCTAssertEqual(pool.cachedBytes, 10240)
+
+        XCTAssertTrue(pool.dequeueBuffer(byteCount: 9000) === buffer)
+        XCTAssertEqual(pool.usedBytes, 10240)
+        XCTAssertEqual(pool.cachedBytes, 0)
+
+        // smumriak: different bucket never gets the cached buffer
+        pool.enqueueBuffer(buffer)
+        XCTAssertFalse(pool.dequeueBuffer(byteCount: 4096) === buffer)
+        XCTAssertEqual(pool.residentBytes, 4096 + 10240)
+    }
+
+    func testTrimmingEvictsLeastRecentlyReturnedBuffers() {
+        let pool = CABackingStorePool(memoryBudget: 3 * 4096)
+
+        let first = pool.dequeueBuffer(byteCount: 4096)
+        let second = pool.dequeueBuffer(byteCount: 4096)
+        let third = pool.dequeueBuffer(byteCount: 4096)
+
+        pool.enqueueBuffer(first)
+        pool.enqueueBuffer(second)
+        pool.enqueueBuffer(third)
+
+        XCTAssertEqual(pool.cachedBytes, 3 * 4096)
+
+        // smumriak: buffers in use are never evicted, so resident memory is back within budget only after two cached buffers are gone
+        let large = pool.dequeueBuffer(byteCount: 8192)
+
+        XCTAssertEqual(pool.usedBytes, 8192)
+        XCTAssertEqual(pool.cachedBytes, 4096)
+        XCTAssertEqual(pool.residentBytes, 3 * 4096)
+        XCTAssertTrue(pool.dequeueBuffer(byteCount: 4096) === third)
+
+        pool.enqueueBuffer(large)
+        pool.purge()
+        XCTAssertEqual(pool.cachedBytes, 0)
+        XCTAssertEqual(pool.usedBytes, 4096)
+    }
+
+    func testBackingStoreBecomesSingleBufferedAfterUpload() throws {
+        let pool = CABackingStorePool(memoryBudget: 1024 * 1024)
+
+        var backingStore: CABackingStore? = try CABackingStore(size: CGSize(width: 16, height: 16), scale: 1.0, pool: pool)
+
+        XCTAssertEqual(backingStore?.isSingleBuffered, false)
+        XCTAssertEqual(backingStore?.residentBytes, 2 * 4096)
+        XCTAssertEqual(pool.usedBytes, 2 * 4096)
+
+        backingStore?.contentsDidUpload()
+
+        XCTAssertEqual(backingStore?.isSingleBuffered, true)
+        XCTAssertEqual(backingStore?.residentBytes, 4096)
+        XCTAssertEqual(pool.usedBytes, 4096)
+        XCTAssertEqual(pool.cachedBytes, 4096)
+
+        // smumriak: single buffered store draws straight into front buffer
+        let frontContext = backingStore?.frontContext
+        backingStore?.update { context in
+            XCTAssertTrue(context === frontContext)
+        }
+        XCTAssertEqual(backingStore?.isSingleBuffered, true)
+
+        backingStore = nil
+
+        XCTAssertEqual(pool.usedBytes, 0)
+        XCTAssertEqual(pool.cachedBytes, 2 * 4096)
+    }
+}
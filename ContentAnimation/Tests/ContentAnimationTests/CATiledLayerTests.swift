@@ -0,0 +1,51 @@
+//
+//  CATiledLayerTests.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import ContentAnimation
+import CairoGraphics
+
+final class CATiledLayerTests: XCTestCase {
+    func testOnlyTilesAroundVisibleRectAreKept() {
+        let layer = makeLayer()
+
+        layer.setVisibleRect(CGRect(x: 0, y: 0, width: 256, height: 512))
+        XCTAssertEqual(Set(layer.tiles.keys), indices(rows: 0..<2))
+
+        // smumriak: moving down prefetches one more visible rect below
+        layer.setVisibleRect(CGRect(x: 0, y: 128, width: 256, height: 512))
+        XCTAssertEqual(Set(layer.tiles.keys), indices(rows: 0..<5))
+
+        let tile = layer.tiles[CATiledLayer.TileIndex(column: 0, row: 3)]!
+        XCTAssertEqual(tile.layer.position, CGPoint(x: 0, y: 768))
+        XCTAssertEqual(tile.layer.bounds.size, CGSize(width: 256, height: 256))
+    }
+
+    func testTileCountIsBounded() {
+        let layer = makeLayer()
+        layer.maximumTileCount = 8
+
+        for offset in stride(from: 0, to: 8192 - 512, by: 64) {
+            layer.setVisibleRect(CGRect(x: 0, y: CGFloat(offset), width: 256, height: 512))
+            XCTAssertLessThanOrEqual(layer.tilesCount, 8)
+        }
+
+        let visibleRows = Set(layer.tiles.keys.map { $0.row })
+        XCTAssertTrue(visibleRows.isSuperset(of: [29, 30, 31]))
+    }
+
+    func makeLayer() -> CATiledLayer {
+        let result = CATiledLayer()
+        result.bounds = CGRect(x: 0, y: 0, width: 256, height: 8192)
+        return result
+    }
+
+    func indices(rows: Range<Int>) -> Set<CATiledLayer.TileIndex> {
+        Set(rows.map { CATiledLayer.TileIndex(column: 0, row: $0) })
+    }
+}
@@ -0,0 +1,57 @@
+//
+//  CompactLayerRecordTests.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import ContentAnimation
+import SimpleGLM
+import LayerRenderingData
+
+final class CompactLayerRecordTests: XCTestCase {
+    func testHalfFloatPacking() {
+        XCTAssertEqual(halfFloatBits(0.0), 0x0000)
+        XCTAssertEqual(halfFloatBits(1.0), 0x3C00)
+        XCTAssertEqual(halfFloatBits(-2.0), 0xC000)
+        XCTAssertEqual(halfFloatBits(0.5), 0x3800)
+        XCTAssertEqual(halfFloatBits(65504.0), 0x7BFF)
+        XCTAssertEqual(halfFloatBits(100_000.0), 0x7C00)
+        XCTAssertEqual(packHalf2x16(1.0, 0.5), 0x3800_3C00)
+        XCTAssertEqual(vec4s(1.0, 0.0, 0.5, 1.0).packedUnorm8, 0xFF80_00FF)
+    }
+
+    func testOnlyAffineLayersAreCompact() {
+        var transform = mat4s.identity
+        transform.m00 = 200.0
+        transform.m11 = 100.0
+        transform.m30 = 20.0
+        transform.m31 = 10.0
+
+        XCTAssertNotNil(CompactLayerRenderDescriptor(descriptor(transform: transform)))
+
+        transform.m03 = 0.001
+        XCTAssertNil(CompactLayerRenderDescriptor(descriptor(transform: transform)))
+    }
+
+    func descriptor(transform: mat4s) -> LayerRenderDescriptor {
+        LayerRenderDescriptor(transform: transform,
+                              contentsTransform: transform,
+                              position: .zero,
+                              anchorPoint: .zero,
+                              bounds: vec4s(0.0, 0.0, 200.0, 100.0),
+                              textureRect: .zero,
+                              backgroundColor: vec4s(1.0, 1.0, 1.0, 1.0),
+                              borderColor: .zero,
+                              borderWidth: 1.0,
+                              cornerRadius: 4.0,
+                              masksToBounds: 1,
+                              shadowOffset: .zero,
+                              shadowColor: .zero,
+                              shadowRadius: 0.0,
+                              shadowOpacity: 0.0,
+                              padding0: .zero)
+    }
+}
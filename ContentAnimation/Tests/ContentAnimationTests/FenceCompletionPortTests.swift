@@ -0,0 +1,50 @@
+//
+//  FenceCompletionPortTests.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import ContentAnimation
+import Volcano
+
+#if os(Linux)
+    final class FenceCompletionPortTests: XCTestCase {
+        func testCallbackIsCalledOnRunLoop() throws {
+            try XCTSkipUnless(isBenchmarkEnabled, "Set APPKID_RENDERING_BENCHMARKS to run rendering tests, i.e. with lavapipe selected via VK_ICD_FILENAMES")
+
+            let renderStack = try self.renderStack
+            let port = try FenceCompletionPort(device: renderStack.device)
+            defer {
+                port.invalidate()
+            }
+
+            port.schedule(in: .current, forMode: .default)
+
+            let fence = try port.createFence()
+            try renderStack.queues.graphics.submit(with: SubmitDescriptor(commandBuffers: [], fence: fence))
+
+            var result: Result<Void, Swift.Error>? = nil
+            var callbackThread: Thread? = nil
+
+            try port.notify(when: fence) {
+                result = $0
+                callbackThread = Thread.current
+            }
+
+            // smumriak: callbacks are never called synchronously, even if fence has already been signaled
+            XCTAssertNil(result)
+
+            let deadline = Date(timeIntervalSinceNow: 5)
+            while result == nil && Date() < deadline {
+                RunLoop.current.run(mode: .default, before: Date(timeIntervalSinceNow: 0.1))
+            }
+
+            XCTAssertNoThrow(try XCTUnwrap(result).get())
+            XCTAssertTrue(callbackThread === Thread.current)
+            XCTAssertFalse(try fence.isSignaled)
+        }
+    }
+#endif
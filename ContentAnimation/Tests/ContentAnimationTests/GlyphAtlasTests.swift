@@ -0,0 +1,84 @@
+//
+//  GlyphAtlasTests.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import ContentAnimation
+@_spi(AppKid) import CairoGraphics
+
+final class GlyphAtlasTests: XCTestCase {
+    func testSnapSplitsQuarterPixels() {
+        XCTAssertEqual(GlyphAtlas.snap(10.0).pixel, 10.0)
+        XCTAssertEqual(GlyphAtlas.snap(10.0).subpixelPosition, 0)
+        XCTAssertEqual(GlyphAtlas.snap(10.3).subpixelPosition, 1)
+        XCTAssertEqual(GlyphAtlas.snap(10.5).subpixelPosition, 2)
+        XCTAssertEqual(GlyphAtlas.snap(10.9).pixel, 11.0)
+        XCTAssertEqual(GlyphAtlas.snap(10.9).subpixelPosition, 0)
+    }
+
+    func testRepeatedGlyphsAreRasterizedOnce() {
+        let key = TextLayoutCache.Key(text: "aaaa", font: .systemFont(ofSize: 17), width: -1, scale: 2.0)
+        let shapedText = TextLayoutCache().shapedText(for: key)
+        let glyphs = shapedText.glyphs
+
+        XCTAssertEqual(glyphs.count, 4)
+
+        let atlas = GlyphAtlas(width: 256, height: 256)
+
+        let entries = glyphs.map {
+            atlas.entry(for: $0.glyph, font: $0.font, subpixelPosition: 0)
+        }
+
+        XCTAssertNotNil(entries[0])
+        XCTAssertEqual(atlas.count, 1)
+        XCTAssertTrue(entries.allSatisfy { $0 == entries[0] })
+
+        _ = atlas.entry(for: glyphs[0].glyph, font: glyphs[0].font, subpixelPosition: 2)
+
+        XCTAssertEqual(atlas.count, 2)
+    }
+
+    func testFullAtlasEvictsRowsNotUsedInCurrentFrame() throws {
+        let key = TextLayoutCache.Key(text: "acemnorsuvwxz", font: .systemFont(ofSize: 17), width: -1, scale: 2.0)
+        let glyphs = TextLayoutCache().shapedText(for: key).glyphs
+
+        let atlas = GlyphAtlas(width: 64, height: 48)
+
+        atlas.beginFrame()
+
+        var firstFrameEntries: [GlyphAtlas.Entry] = []
+        var overflowingGlyph: PositionedGlyph? = nil
+
+        for glyph in glyphs {
+            if let entry = atlas.entry(for: glyph.glyph, font: glyph.font, subpixelPosition: 0) {
+                firstFrameEntries.append(entry)
+            } else {
+                overflowingGlyph = glyph
+                break
+            }
+        }
+
+        // smumriak: glyphs of one frame that do not fit are skipped instead of wiping the atlas
+        let firstGlyph = glyphs[0]
+        let firstEntry = try XCTUnwrap(firstFrameEntries.first)
+        let overflowing = try XCTUnwrap(overflowingGlyph)
+        XCTAssertNil(atlas.entry(for: overflowing.glyph, font: overflowing.font, subpixelPosition: 0))
+        XCTAssertEqual(atlas.entry(for: firstGlyph.glyph, font: firstGlyph.font, subpixelPosition: 0), firstEntry)
+
+        atlas.beginFrame()
+
+        XCTAssertEqual(atlas.entry(for: firstGlyph.glyph, font: firstGlyph.font, subpixelPosition: 0), firstEntry)
+
+        let evictingEntry = atlas.entry(for: overflowing.glyph, font: overflowing.font, subpixelPosition: 0)
+        XCTAssertNotNil(evictingEntry)
+        XCTAssertNotEqual(evictingEntry?.row, firstEntry.row)
+
+        // smumriak: row used in current frame survived eviction
+        XCTAssertEqual(atlas.entry(for: firstGlyph.glyph, font: firstGlyph.font, subpixelPosition: 0), firstEntry)
+        XCTAssertLessThanOrEqual(atlas.count, firstFrameEntries.count)
+    }
+}
@@ -0,0 +1,55 @@
+//
+//  OffscreenRenderingBenchmarkTests.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import ContentAnimation
+import Volcano
+import TinyFoundation
+
+final class OffscreenRenderingBenchmarkTests: XCTestCase {
+    func testPNGSignature() throws {
+        try XCTSkipUnless(isBenchmarkEnabled, "Set APPKID_RENDERING_BENCHMARKS to run rendering tests, i.e. with lavapipe selected via VK_ICD_FILENAMES")
+
+        let service = try OffscreenRenderingService(renderStack: renderStack)
+        let layer = makeLayerTree(width: 64, height: 64, panes: 2, layersPerPane: 4)
+
+        let raw = try service.render(.init(layer: layer, width: 64, height: 64, format: .raw))
+        XCTAssertEqual(raw.data.count, 64 * 64 * 4)
+
+        let png = try service.render(.init(layer: layer, width: 64, height: 64, format: .png))
+        XCTAssertEqual(Array(png.data.prefix(8)), [0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A])
+    }
+
+    // smumriak: renders the same batch of thumbnails with growing pipeline depth and prints throughput. depth 1 is fully serial: render, wait, read back, encode
+    func testThroughput() throws {
+        try XCTSkipUnless(isBenchmarkEnabled, "Set APPKID_RENDERING_BENCHMARKS to run rendering benchmarks, i.e. with lavapipe selected via VK_ICD_FILENAMES")
+
+        let width = 512
+        let height = 384
+        let jobsCount = 64
+
+        let jobs = (0..<jobsCount).map { index in
+            OffscreenRenderingService.Job(layer: makeLayerTree(width: width, height: height, panes: 4, layersPerPane: 50 + index % 8 * 10), width: width, height: height, format: .png)
+        }
+
+        for pipelineDepth in [1, 2, 3] {
+            let service = try OffscreenRenderingService(renderStack: renderStack, pipelineDepth: pipelineDepth)
+
+            // smumriak: warm up pools and pipelines
+            _ = try service.render(Array(jobs.prefix(pipelineDepth)))
+
+            let start: UInt64 = .absoluteTime
+            let images = try service.render(jobs)
+            let elapsed = Double(UInt64.absoluteTime - start) / 1_000_000_000
+
+            XCTAssertEqual(images.count, jobsCount)
+
+            print("Offscreen rendering: pipeline depth \(pipelineDepth), \(width)x\(height) png, \(String(format: "%.1f", Double(jobsCount) / elapsed)) images per second")
+        }
+    }
+}
@@ -0,0 +1,101 @@
+//
+//  ParallelRecordingBenchmarkTests.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import ContentAnimation
+import CairoGraphics
+import Volcano
+import TinyFoundation
+
+final class ParallelRecordingBenchmarkTests: XCTestCase {
+    func testChunksRespectSubtreeBoundaries() {
+        let root = makeLayerTree(width: 640, height: 480, panes: 8, layersPerPane: 12)
+
+        // smumriak: one operation per layer. root layer goes first, then every pane followed by its cells, boundary is marked before every pane
+        var boundaries: [Int] = []
+        var operationsCount = 1
+        root.sublayers?.forEach { pane in
+            boundaries.append(operationsCount)
+            operationsCount += 1 + (pane.sublayers?.count ?? 0)
+        }
+
+        let chunks = ParallelRecorder.chunks(of: 0..<operationsCount, boundaries: boundaries, threadCount: 4, minimumOperationsPerChunk: 1)
+
+        XCTAssertGreaterThan(chunks.count, 1)
+        XCTAssertLessThanOrEqual(chunks.count, 4)
+        XCTAssertEqual(chunks.first?.lowerBound, 0)
+        XCTAssertEqual(chunks.last?.upperBound, operationsCount)
+        for (chunk, nextChunk) in zip(chunks, chunks.dropFirst()) {
+            XCTAssertEqual(chunk.upperBound, nextChunk.lowerBound)
+            XCTAssertTrue(boundaries.contains(nextChunk.lowerBound))
+        }
+
+        let unsplitChunks = ParallelRecorder.chunks(of: 0..<operationsCount, boundaries: boundaries, threadCount: 4, minimumOperationsPerChunk: operationsCount)
+        XCTAssertEqual(unsplitChunks, [0..<operationsCount])
+    }
+
+    // smumriak: records the same multi pane layer tree with growing number of threads and prints median recording time. meant to be run on lavapipe where recording cost dominates
+    func testRecordingScalesWithThreads() throws {
+        try XCTSkipUnless(isBenchmarkEnabled, "Set APPKID_RENDERING_BENCHMARKS to run rendering benchmarks, i.e. with lavapipe selected via VK_ICD_FILENAMES")
+
+        let renderStack = try self.renderStack
+        let device = renderStack.device
+        let commandPool = try renderStack.queues.graphics.createCommandPool()
+        let renderer = try VolcanoRenderer(pixelFormat: .rgba8UNorm, commandPool: commandPool)
+
+        let width = 1920
+        let height = 1080
+
+        let textureDescriptor = TextureDescriptor.texture2DDescriptor(pixelFormat: .rgba8UNorm, width: width, height: height, mipmapped: false)
+        textureDescriptor.usage = [.renderTarget, .shaderRead]
+        textureDescriptor.requiredMemoryProperties = .deviceLocal
+        let target = try device.createTexture(with: textureDescriptor)
+
+        try renderer.setDestination(target: target)
+        renderer.layer = makeLayerTree(width: width, height: height, panes: 8, layersPerPane: 1000)
+
+        let fence = try Fence(device: device)
+        let framesCount = 30
+
+        var threadsCounts = [1]
+        while threadsCounts.last! * 2 <= ProcessInfo.processInfo.activeProcessorCount {
+            threadsCounts.append(threadsCounts.last! * 2)
+        }
+
+        var baseline: UInt64 = 0
+
+        for threadsCount in threadsCounts {
+            try renderer.setRecordingThreadsCount(threadsCount)
+
+            var samples: [UInt64] = []
+
+            for _ in 0..<framesCount {
+                try renderer.beginFrame(atTime: 0)
+                try renderer.buildRenderOperations()
+
+                let start: UInt64 = .absoluteTime
+                try renderer.performRenderOperations()
+                samples.append(.absoluteTime - start)
+
+                try fence.reset()
+                try renderer.submitCommandBuffer(fence: fence)
+                try fence.wait()
+
+                try renderer.endFrame()
+            }
+
+            let median = samples.sorted()[samples.count / 2]
+            if threadsCount == 1 {
+                baseline = median
+            }
+
+            let speedup = Double(baseline) / Double(max(median, 1))
+            print("Parallel recording: \(threadsCount) threads, \(renderer.renderContext.layerCount) layers, median \(median / 1000) us, speedup \(String(format: "%.2f", speedup))x")
+        }
+    }
+}
@@ -0,0 +1,63 @@
+//
+//  RenderingTestSupport.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import ContentAnimation
+import CairoGraphics
+
+extension XCTestCase {
+    var isBenchmarkEnabled: Bool {
+        ProcessInfo.processInfo.environment["APPKID_RENDERING_BENCHMARKS"] != nil
+    }
+
+    var renderStack: VolcanoRenderStack {
+        get throws {
+            if VolcanoRenderStack.global == nil {
+                try VolcanoRenderStack.setupGlobalStack()
+            }
+
+            return VolcanoRenderStack.global
+        }
+    }
+
+    func makeLayerTree(width: Int, height: Int, panes: Int, layersPerPane: Int) -> CALayer {
+        let root = CALayer()
+        root.bounds = CGRect(x: 0, y: 0, width: width, height: height)
+        root.position = CGPoint(x: width / 2, y: height / 2)
+        root.backgroundColor = .white
+
+        let paneWidth = CGFloat(width) / CGFloat(panes)
+        let columns = 20
+        let rows = (layersPerPane + columns - 1) / columns
+        let cellWidth = paneWidth / CGFloat(columns)
+        let cellHeight = CGFloat(height) / CGFloat(rows)
+
+        for paneIndex in 0..<panes {
+            let pane = CALayer()
+            pane.bounds = CGRect(x: 0, y: 0, width: paneWidth, height: CGFloat(height))
+            pane.position = CGPoint(x: paneWidth * (CGFloat(paneIndex) + 0.5), y: CGFloat(height) / 2)
+            pane.backgroundColor = .lightGray
+            pane.borderColor = .black
+            pane.borderWidth = 1
+
+            for cellIndex in 0..<layersPerPane {
+                let cell = CALayer()
+                cell.bounds = CGRect(x: 0, y: 0, width: cellWidth - 2, height: cellHeight - 2)
+                cell.position = CGPoint(x: cellWidth * (CGFloat(cellIndex % columns) + 0.5), y: cellHeight * (CGFloat(cellIndex / columns) + 0.5))
+                cell.backgroundColor = CGColor(red: CGFloat(cellIndex % 7) / 7, green: CGFloat(paneIndex) / CGFloat(panes), blue: 0.5)
+                cell.cornerRadius = cellIndex % 2 == 0 ? 2 : 0
+
+                pane.addSublayer(cell)
+            }
+
+            root.addSublayer(pane)
+        }
+
+        return root
+    }
+}
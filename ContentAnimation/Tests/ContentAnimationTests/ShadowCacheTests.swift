@@ -0,0 +1,74 @@
+//
+//  ShadowCacheTests.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import ContentAnimation
+import CairoGraphics
+
+final class ShadowCacheTests: XCTestCase {
+    func testBlurSpreadsCoverageAndKeepsItsAmount() {
+        let size = 32
+        let mask = CGContext(width: size, height: size, bitsPerComponent: 8, bytesPerRow: size * 4, colorSpace: CGColorSpace(), bitmapInfo: [])!
+        mask.fillColor = .black
+        mask.fill(CGRect(x: 12, y: 12, width: 8, height: 8))
+        mask.flush()
+
+        let before = alphaValues(of: mask)
+
+        ShadowCache.blurAlpha(of: mask, sigma: 2.0)
+
+        let after = alphaValues(of: mask)
+
+        XCTAssertEqual(before[16 * size + 8], 0)
+        XCTAssertGreaterThan(after[16 * size + 8], 0)
+        XCTAssertLessThan(after[16 * size + 16], 255)
+
+        let beforeSum = before.reduce(0) { $0 + Int($1) }
+        let afterSum = after.reduce(0) { $0 + Int($1) }
+        XCTAssertEqual(Double(afterSum), Double(beforeSum), accuracy: Double(beforeSum) * 0.02)
+    }
+
+    func testRedisplayedContentsReplaceShadowEntry() throws {
+        try XCTSkipUnless(isBenchmarkEnabled, "Set APPKID_RENDERING_BENCHMARKS to run rendering tests, i.e. with lavapipe selected via VK_ICD_FILENAMES")
+
+        let service = try OffscreenRenderingService(renderStack: renderStack, pipelineDepth: 1)
+
+        let root = CALayer()
+        root.bounds = CGRect(x: 0, y: 0, width: 64, height: 64)
+        root.position = CGPoint(x: 32, y: 32)
+
+        // smumriak: no background color, so shadow is shaped by contents of backing store
+        let layer = CALayer()
+        layer.bounds = CGRect(x: 0, y: 0, width: 32, height: 32)
+        layer.position = CGPoint(x: 32, y: 32)
+        layer.shadowColor = .black
+        layer.shadowOpacity = 0.5
+        layer.shadowRadius = 4
+        layer.setNeedsDisplay()
+        root.addSublayer(layer)
+
+        let shadowCache = service.slots[0].renderer.shadowCache
+
+        _ = try service.render(.init(layer: root, width: 64, height: 64, format: .raw))
+        XCTAssertEqual(shadowCache.count, 1)
+
+        layer.setNeedsDisplay()
+        _ = try service.render(.init(layer: root, width: 64, height: 64, format: .raw))
+        XCTAssertEqual(shadowCache.count, 1)
+    }
+
+    func alphaValues(of context: CGContext) -> [UInt8] {
+        let pixels = context.data!.assumingMemoryBound(to: UInt8.self)
+
+        return (0..<context.height).flatMap { y in
+            (0..<context.width).map { x in
+                pixels[y * context.bytesPerRow + x * 4 + 3]
+            }
+        }
+    }
+}
@@ -0,0 +1,155 @@
+//
+//  TransformHierarchyTests.swift
+//  ContentAnimation
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import XCTest
+import Foundation
+@_spi(AppKid) @testable import ContentAnimation
+import CairoGraphics
+import SimpleGLM
+import TinyFoundation
+
+final class TransformHierarchyTests: XCTestCase {
+    func testIncrementalUpdateMatchesFullEvaluation() {
+        let root = makeTree(count: 500, fanout: 4)
+        let hierarchy = TransformHierarchy()
+
+        XCTAssertEqual(hierarchy.update(root: root), 500)
+        assertMatchesReference(hierarchy, root: root)
+
+        XCTAssertEqual(hierarchy.update(root: root), 0)
+
+        let changed = hierarchy.layers[5]
+        changed.position.x += 10
+        changed.transform = scaleTransform(1.5)
+
+        XCTAssertEqual(hierarchy.update(root: root), hierarchy.subtreeEnds[5] - 5)
+        assertMatchesReference(hierarchy, root: root)
+
+        hierarchy.layers[42].addSublayer(CALayer())
+        XCTAssertEqual(hierarchy.update(root: root), 501)
+        assertMatchesReference(hierarchy, root: root)
+
+        // smumriak: changes in other layer trees do not invalidate this one
+        let unrelatedRoot = CALayer()
+        unrelatedRoot.addSublayer(CALayer())
+        XCTAssertEqual(hierarchy.update(root: root), 0)
+    }
+
+    // smumriak: compares incremental update against full evaluation that renderer used to do for every layer on every frame
+    func testHundredThousandNodes() throws {
+        try XCTSkipUnless(isBenchmarkEnabled, "Set APPKID_RENDERING_BENCHMARKS to run rendering benchmarks")
+
+        let count = 100_000
+        let root = makeTree(count: count, fanout: 8)
+        let hierarchy = TransformHierarchy()
+
+        var start: UInt64 = .absoluteTime
+        hierarchy.update(root: root)
+        let rebuild = UInt64.absoluteTime - start
+
+        start = .absoluteTime
+        _ = referenceWorldTransforms(root: root)
+        let reference = UInt64.absoluteTime - start
+
+        var generator = SystemRandomNumberGenerator()
+        var recomputed = 0
+
+        start = .absoluteTime
+        for _ in 0..<100 {
+            hierarchy.layers[Int.random(in: 0..<count, using: &generator)].position.x += 1
+            recomputed += hierarchy.update(root: root)
+        }
+        let incremental = (UInt64.absoluteTime - start) / 100
+
+        func milliseconds(_ value: UInt64) -> String { String(format: "%.3f", Double(value) / 1_000_000) }
+
+        print("Transform hierarchy, \(count) layers: full evaluation \(milliseconds(reference)) ms, rebuild \(milliseconds(rebuild)) ms, one layer changed \(milliseconds(incremental)) ms with \(recomputed / 100) layers recomputed on average")
+    }
+
+    func makeTree(count: Int, fanout: Int) -> CALayer {
+        let root = CALayer()
+        root.bounds = CGRect(x: 0, y: 0, width: 1920, height: 1080)
+        root.position = CGPoint(x: 960, y: 540)
+
+        var layers = [root]
+        var parentIndex = 0
+
+        while layers.count < count {
+            let parent = layers[parentIndex]
+
+            for childIndex in 0..<fanout where layers.count < count {
+                let layer = CALayer()
+                layer.bounds = CGRect(x: 0, y: 0, width: parent.bounds.width / 2, height: parent.bounds.height / 2)
+                layer.position = CGPoint(x: CGFloat(childIndex) * 3, y: CGFloat(childIndex) * 2)
+
+                if childIndex % 3 == 0 {
+                    layer.anchorPoint = CGPoint(x: 0.25, y: 0.75)
+                }
+
+                if childIndex % 5 == 0 {
+                    layer.transform = scaleTransform(0.9)
+                }
+
+                parent.addSublayer(layer)
+                layers.append(layer)
+            }
+
+            parentIndex += 1
+        }
+
+        return root
+    }
+
+    func scaleTransform(_ scale: CGFloat) -> CATransform3D {
+        var result = CATransform3D.identity
+        result.m11 = scale
+        result.m22 = scale
+        return result
+    }
+
+    func referenceWorldTransforms(root: CALayer) -> [mat4s] {
+        var result: [mat4s] = []
+
+        func visit(_ layer: CALayer, parentTransform: mat4s) {
+            let bounds = layer.bounds
+            let position = layer.position
+            let anchorPoint = layer.anchorPoint
+            let contentsScale = layer.contentsScale
+
+            let anchorPointTransform = mat4s(translationVector: vec3s(x: anchorPoint.x * bounds.width * contentsScale, y: anchorPoint.y * bounds.height * contentsScale, z: 0.0))
+            let positionTransform = mat4s(translationVector: vec3s(x: (position.x - bounds.midX) * contentsScale, y: (position.y - bounds.midY) * contentsScale, z: 0.0))
+
+            let transform = parentTransform * positionTransform * anchorPointTransform * layer.transform.mat4 * anchorPointTransform.inversed
+            result.append(transform)
+
+            layer.sublayers?.forEach {
+                visit($0, parentTransform: transform)
+            }
+        }
+
+        visit(root, parentTransform: .identity)
+
+        return result
+    }
+
+    func assertMatchesReference(_ hierarchy: TransformHierarchy, root: CALayer, file: StaticString = #filePath, line: UInt = #line) {
+        let reference = referenceWorldTransforms(root: root)
+
+        XCTAssertEqual(hierarchy.worldTransforms.count, reference.count, file: file, line: line)
+
+        for (cached, expected) in zip(hierarchy.worldTransforms, reference) {
+            let difference = [cached.m00 - expected.m00, cached.m11 - expected.m11, cached.m30 - expected.m30, cached.m31 - expected.m31]
+                .map { abs($0) }
+                .max() ?? 0
+
+            if difference > 1e-2 {
+                XCTFail("World transform differs from reference by \(difference)", file: file, line: line)
+                return
+            }
+        }
+    }
+}
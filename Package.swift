@@ -85,6 +85,7 @@ let package = Package(
     ],
     products: [
         .executable(name: "AppKidDemo", targets: ["AppKidDemo"]),
+        .executable(name: "RenderingBenchmarks", targets: ["RenderingBenchmarks"]),
         
         .library(.appKid, type: .dynamic),
 
@@ -153,8 +154,20 @@ let package = Package(
             name: "AppKidDemoTests",
             dependencies: ["AppKidDemo"]
         ),
+        .executableTarget(
+            name: "RenderingBenchmarks",
+            dependencies: [
+                .appKid,
+                .cairoGraphics,
+                .contentAnimation,
+                .tinyFoundation,
+                .volcano,
+                .product(name: "ArgumentParser", package: "swift-argument-parser"),
+            ]
+        ),
 
         .appKid,
+        .appKidTests,
 
         .cCairo,
         .cPango,
@@ -331,6 +344,11 @@ extension Target {
         path: "AppKid/Sources/AppKid",
         swiftSettings: .emitModule
     )
+    static let appKidTests: Target = testTarget(
+        name: "AppKidTests",
+        dependencies: [.appKid],
+        path: "AppKid/Tests/AppKidTests"
+    )
 }
 
 extension Target {
@@ -394,6 +412,7 @@ extension Target {
             .volcano,
             .simpleGLM,
             .layerRenderingData,
+            .stbImageWrite,
             .product(name: "DequeModule", package: "swift-collections"),
             .product(name: "OrderedCollections", package: "swift-collections"),
         ],
@@ -479,6 +498,7 @@ extension Target {
         name: "SwiftyGLib",
         dependencies: [
             .tinyFoundation,
+            .linuxSys,
             .cGLib,
         ],
         path: "SwiftyGLib/Sources/SwiftyGLib",
@@ -0,0 +1,46 @@
+//
+//  MatrixBatch.swift
+//  SimpleGLM
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+
+// smumriak: kernels work on contiguous buffers so there is no retain/release or bounds checks per matrix. the multiplication itself is cglm's, which picks SSE/AVX/NEON implementation at compile time
+public extension mat4s {
+    /// Multiplies matrices pairwise: `result[i] = lhs[i] * rhs[i]`
+    @inlinable
+    static func multiply(_ lhs: UnsafeBufferPointer<mat4s>, _ rhs: UnsafeBufferPointer<mat4s>, into result: UnsafeMutableBufferPointer<mat4s>) {
+        precondition(lhs.count == rhs.count && lhs.count == result.count, "Batch sizes do not match")
+
+        guard let lhs = lhs.baseAddress, let rhs = rhs.baseAddress, let result = result.baseAddress else {
+            return
+        }
+
+        for index in 0..<result.count {
+            result[index] = glms_mat4_mul(lhs[index], rhs[index])
+        }
+    }
+
+    /// Evaluates world transforms of a hierarchy stored in depth first order: `worlds[i] = worlds[parentIndices[i]] * locals[i]`, negative parent index means `root` is the parent. Parent of every element in `range` has to either precede it in the same range or have valid world transform already
+    @inlinable
+    static func composeHierarchy(locals: UnsafeBufferPointer<mat4s>, parentIndices: UnsafeBufferPointer<Int32>, range: Range<Int>, root: mat4s = .identity, into worlds: UnsafeMutableBufferPointer<mat4s>) {
+        precondition(locals.count == parentIndices.count && locals.count == worlds.count, "Batch sizes do not match")
+        precondition(range.lowerBound >= 0 && range.upperBound <= worlds.count, "Range is out of bounds")
+
+        guard let locals = locals.baseAddress, let parentIndices = parentIndices.baseAddress, let worlds = worlds.baseAddress else {
+            return
+        }
+
+        for index in range {
+            let parentIndex = Int(parentIndices[index])
+
+            if parentIndex < 0 {
+                worlds[index] = glms_mat4_mul(root, locals[index])
+            } else {
+                worlds[index] = glms_mat4_mul(worlds[parentIndex], locals[index])
+            }
+        }
+    }
+}
@@ -2,4 +2,30 @@ import XCTest
 @testable import SimpleGLM
 
 final class SimpleGLMTests: XCTestCase {
+    func testComposeHierarchyMatchesSequentialMultiplication() {
+        let locals: [mat4s] = [
+            mat4s(translationVector: vec3s(x: 10, y: 20, z: 0)),
+            mat4s(scaleVector: vec3s(x: 2, y: 2, z: 1)),
+            mat4s(rotationAngle: 0.5, axis: vec3s(x: 0, y: 0, z: 1)),
+            mat4s(translationVector: vec3s(x: -3, y: 4, z: 0)),
+        ]
+        // smumriak: root -> 1 -> 2, and 3 is second child of root
+        let parentIndices: [Int32] = [-1, 0, 1, 0]
+        let root = mat4s(translationVector: vec3s(x: 1, y: 1, z: 0))
+
+        var worlds = [mat4s](repeating: .identity, count: locals.count)
+
+        locals.withUnsafeBufferPointer { locals in
+            parentIndices.withUnsafeBufferPointer { parentIndices in
+                worlds.withUnsafeMutableBufferPointer { worlds in
+                    mat4s.composeHierarchy(locals: locals, parentIndices: parentIndices, range: 0..<locals.count, root: root, into: worlds)
+                }
+            }
+        }
+
+        XCTAssertEqual(worlds[0], root * locals[0])
+        XCTAssertEqual(worlds[1], root * locals[0] * locals[1])
+        XCTAssertEqual(worlds[2], root * locals[0] * locals[1] * locals[2])
+        XCTAssertEqual(worlds[3], root * locals[0] * locals[3])
+    }
 }
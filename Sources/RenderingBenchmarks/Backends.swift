@@ -0,0 +1,127 @@
+//
+//  Backends.swift
+//  RenderingBenchmarks
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import TinyFoundation
+@_spi(AppKid) import ContentAnimation
+@_spi(AppKid) import AppKid
+import CairoGraphics
+import Volcano
+
+protocol BenchmarkBackend {
+    var name: String { get }
+    func renderFrame(_ tree: SyntheticLayerTree) throws -> FrameSample
+    var gpuAllocations: UInt64? { get }
+}
+
+final class VolcanoBackend: BenchmarkBackend {
+    let name = "volcano"
+    let renderStack: VolcanoRenderStack
+    let renderer: VolcanoRenderer
+    let fence: Fence
+    let target: Texture
+
+    var gpuAllocations: UInt64? {
+        renderStack.resourcePool.statistics.misses
+    }
+
+    init(width: Int, height: Int) throws {
+        if VolcanoRenderStack.global == nil {
+            try VolcanoRenderStack.setupGlobalStack()
+        }
+
+        // smumriak: timings come from frame profiler scopes, including GPU timestamps. has to be enabled before renderer creates its render context
+        FrameProfiler.isEnabled = true
+
+        renderStack = VolcanoRenderStack.global
+        let device = renderStack.device
+
+        let commandPool = try renderStack.queues.graphics.createCommandPool()
+        renderer = try VolcanoRenderer(pixelFormat: .rgba8UNorm, commandPool: commandPool)
+
+        let textureDescriptor = TextureDescriptor.texture2DDescriptor(pixelFormat: .rgba8UNorm, width: width, height: height, mipmapped: false)
+        textureDescriptor.usage = [.renderTarget, .shaderRead]
+        textureDescriptor.requiredMemoryProperties = .deviceLocal
+        target = try device.createTexture(with: textureDescriptor)
+
+        try renderer.setDestination(target: target)
+
+        fence = try Fence(device: device)
+        try fence.reset()
+    }
+
+    func renderFrame(_ tree: SyntheticLayerTree) throws -> FrameSample {
+        renderer.layer = tree.root
+
+        let profiler = FrameProfiler.shared
+        let heapBefore = HeapUsage.currentBytes
+
+        let start: UInt64 = .absoluteTime
+        profiler.beginFrame()
+
+        try renderer.beginFrame(atTime: 0)
+        try renderer.buildRenderOperations()
+        try renderer.performRenderOperations()
+        try renderer.submitCommandBuffer(fence: fence)
+
+        try fence.wait()
+        try fence.reset()
+
+        try renderer.resolveGPUTimestamps()
+        try renderer.endFrame()
+
+        profiler.endFrame()
+        let end: UInt64 = .absoluteTime
+
+        var sample = FrameSample()
+        sample.frame = end - start
+        sample.allocatedBytes = HeapUsage.currentBytes - heapBefore
+
+        if let record = profiler.latestFrame {
+            sample.display = record.totalDuration(of: .display)
+            sample.upload = record.totalDuration(of: .upload)
+            // smumriak: display and upload happen inside traversal scope
+            let traversal = record.totalDuration(of: .traversal)
+            sample.traversal = traversal - min(traversal, sample.display + sample.upload)
+            sample.recording = record.totalDuration(of: .recording)
+            // smumriak: GPU scopes are nested, the longest one covers the whole command buffer
+            sample.gpu = record.events.filter { $0.category == .gpu }.map { $0.duration }.max() ?? 0
+        }
+
+        return sample
+    }
+}
+
+final class SoftwareBackend: BenchmarkBackend {
+    let name = "software"
+    let context: CGContext
+    let renderer: SoftwareRenderer
+
+    var gpuAllocations: UInt64? { nil }
+
+    init(width: Int, height: Int) {
+        context = CGContext(width: width, height: height, bitsPerComponent: 8, bytesPerRow: width * 4, colorSpace: CGColorSpace(), bitmapInfo: [])!
+        renderer = SoftwareRenderer(context: context)
+    }
+
+    func renderFrame(_ tree: SyntheticLayerTree) throws -> FrameSample {
+        let heapBefore = HeapUsage.currentBytes
+        let start: UInt64 = .absoluteTime
+
+        renderer.render(layer: tree.root)
+        context.flush()
+
+        let end: UInt64 = .absoluteTime
+
+        var sample = FrameSample()
+        sample.frame = end - start
+        sample.traversal = sample.frame
+        sample.allocatedBytes = HeapUsage.currentBytes - heapBefore
+
+        return sample
+    }
+}
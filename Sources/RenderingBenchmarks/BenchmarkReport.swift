@@ -0,0 +1,100 @@
+//
+//  BenchmarkReport.swift
+//  RenderingBenchmarks
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+
+#if os(Linux)
+    import Glibc
+#endif
+
+/// Timings of a single frame in nanoseconds
+struct FrameSample {
+    var frame: UInt64 = 0
+    var traversal: UInt64 = 0
+    var display: UInt64 = 0
+    var upload: UInt64 = 0
+    var recording: UInt64 = 0
+    var gpu: UInt64 = 0
+    var allocatedBytes: Int64 = 0
+}
+
+struct Distribution: Codable {
+    let mean: Double
+    let p50: Double
+    let p99: Double
+    let max: Double
+
+    /// Values are converted from nanoseconds to milliseconds
+    init(nanoseconds values: [UInt64]) {
+        self.init(values.map { Double($0) / 1_000_000 })
+    }
+
+    init(_ values: [Double]) {
+        let sorted = values.sorted()
+
+        func percentile(_ value: Double) -> Double {
+            if sorted.isEmpty {
+                return 0
+            }
+
+            let index = Int((Double(sorted.count - 1) * value).rounded())
+            return sorted[index]
+        }
+
+        mean = sorted.isEmpty ? 0 : sorted.reduce(0, +) / Double(sorted.count)
+        p50 = percentile(0.5)
+        p99 = percentile(0.99)
+        max = sorted.last ?? 0
+    }
+}
+
+struct BackendReport: Codable {
+    let backend: String
+    let frames: Int
+    let layers: Int
+    let frameTimeMilliseconds: Distribution
+    let traversalMilliseconds: Distribution
+    let displayMilliseconds: Distribution
+    let uploadMilliseconds: Distribution
+    let recordingMilliseconds: Distribution
+    let gpuMilliseconds: Distribution
+    let allocatedBytesPerFrame: Distribution
+    let gpuAllocations: UInt64?
+
+    init(backend: String, layers: Int, samples: [FrameSample], gpuAllocations: UInt64? = nil) {
+        self.backend = backend
+        self.frames = samples.count
+        self.layers = layers
+        frameTimeMilliseconds = Distribution(nanoseconds: samples.map { $0.frame })
+        traversalMilliseconds = Distribution(nanoseconds: samples.map { $0.traversal })
+        displayMilliseconds = Distribution(nanoseconds: samples.map { $0.display })
+        uploadMilliseconds = Distribution(nanoseconds: samples.map { $0.upload })
+        recordingMilliseconds = Distribution(nanoseconds: samples.map { $0.recording })
+        gpuMilliseconds = Distribution(nanoseconds: samples.map { $0.gpu })
+        allocatedBytesPerFrame = Distribution(samples.map { Double($0.allocatedBytes) })
+        self.gpuAllocations = gpuAllocations
+    }
+}
+
+struct BenchmarkReport: Codable {
+    let commit: String?
+    let date: Date
+    let parameters: SyntheticLayerTreeParameters
+    let warmupFrames: Int
+    let results: [BackendReport]
+}
+
+// smumriak: glibc does not count allocations, but heap usage delta around a frame is good enough to catch regressions in per frame garbage
+enum HeapUsage {
+    static var currentBytes: Int64 {
+        #if os(Linux)
+            return Int64(mallinfo2().uordblks)
+        #else
+            return 0
+        #endif
+    }
+}
@@ -0,0 +1,166 @@
+//
+//  SyntheticLayerTree.swift
+//  RenderingBenchmarks
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import ContentAnimation
+import CairoGraphics
+
+struct SyntheticLayerTreeParameters: Codable {
+    var layersCount: Int = 2000
+    var depth: Int = 4
+    var contentsRatio: Double = 0.2
+    var roundedCornersRatio: Double = 0.3
+    var bordersRatio: Double = 0.2
+    var masksRatio: Double = 0.1
+    /// Fraction of layers that change every frame
+    var mutationRate: Double = 0.05
+    var width: Int = 1920
+    var height: Int = 1080
+    var seed: UInt64 = 0x5EED
+}
+
+// smumriak: deterministic generator, so that the same parameters produce the same tree on every commit
+struct SplitMix64: RandomNumberGenerator {
+    var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E3779B97F4A7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+        z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+        return z ^ (z >> 31)
+    }
+}
+
+final class SyntheticContentsDelegate: CALayerDelegate {
+    var phase: CGFloat = 0
+
+    func draw(_ layer: CALayer, in context: CGContext) {
+        let bounds = layer.bounds
+        let stripes = 6
+
+        for index in 0..<stripes {
+            let value = (CGFloat(index) / CGFloat(stripes) + phase).truncatingRemainder(dividingBy: 1.0)
+            context.fillColor = CGColor(red: value, green: 1.0 - value, blue: 0.5)
+            context.fill(CGRect(x: bounds.minX, y: bounds.minY + bounds.height * CGFloat(index) / CGFloat(stripes), width: bounds.width, height: bounds.height / CGFloat(stripes)))
+        }
+    }
+}
+
+final class SyntheticLayerTree {
+    let parameters: SyntheticLayerTreeParameters
+    let root: CALayer
+    private(set) var layers: [CALayer] = []
+    private(set) var contentsLayers: [CALayer] = []
+    private var generator: SplitMix64
+    private let contentsDelegate = SyntheticContentsDelegate()
+
+    init(parameters: SyntheticLayerTreeParameters) {
+        self.parameters = parameters
+        generator = SplitMix64(seed: parameters.seed)
+
+        root = CALayer()
+        root.bounds = CGRect(x: 0, y: 0, width: parameters.width, height: parameters.height)
+        root.position = CGPoint(x: parameters.width / 2, y: parameters.height / 2)
+        root.backgroundColor = .white
+
+        build()
+    }
+
+    /// Distributes layers evenly across levels, every level splits its parent into a grid of children
+    private func build() {
+        let depth = max(parameters.depth, 1)
+        let perLevel = max(parameters.layersCount / depth, 1)
+
+        var parents: [CALayer] = [root]
+
+        for _ in 0..<depth {
+            var level: [CALayer] = []
+            level.reserveCapacity(perLevel)
+
+            let childrenPerParent = max((perLevel + parents.count - 1) / parents.count, 1)
+            let columns = max(Int(Double(childrenPerParent).squareRoot().rounded(.up)), 1)
+            let rows = max((childrenPerParent + columns - 1) / columns, 1)
+
+            for parent in parents {
+                let parentBounds = parent.bounds
+                let cellWidth = parentBounds.width / CGFloat(columns)
+                let cellHeight = parentBounds.height / CGFloat(rows)
+
+                for childIndex in 0..<childrenPerParent where level.count < perLevel {
+                    let layer = makeLayer(size: CGSize(width: max(cellWidth - 2, 1), height: max(cellHeight - 2, 1)))
+                    layer.position = CGPoint(x: cellWidth * (CGFloat(childIndex % columns) + 0.5), y: cellHeight * (CGFloat(childIndex / columns) + 0.5))
+
+                    parent.addSublayer(layer)
+                    level.append(layer)
+                }
+            }
+
+            layers.append(contentsOf: level)
+            parents = level
+        }
+    }
+
+    private func makeLayer(size: CGSize) -> CALayer {
+        let layer = CALayer()
+        layer.bounds = CGRect(origin: .zero, size: size)
+        layer.backgroundColor = randomColor()
+
+        if chance(parameters.roundedCornersRatio) {
+            layer.cornerRadius = min(size.width, size.height) * 0.2
+        }
+
+        if chance(parameters.bordersRatio) {
+            layer.borderWidth = 1
+            layer.borderColor = .black
+        }
+
+        if chance(parameters.masksRatio) {
+            layer.masksToBounds = true
+        }
+
+        if chance(parameters.contentsRatio) {
+            layer.delegate = contentsDelegate
+            layer.setNeedsDisplay()
+            contentsLayers.append(layer)
+        }
+
+        return layer
+    }
+
+    /// Changes colors and positions of `mutationRate` fraction of layers and redraws contents of the same fraction of contents layers
+    func mutate() {
+        let count = Int(Double(layers.count) * parameters.mutationRate)
+
+        for _ in 0..<count {
+            let layer = layers[Int.random(in: 0..<layers.count, using: &generator)]
+            layer.backgroundColor = randomColor()
+            layer.position.x += CGFloat.random(in: -1...1, using: &generator)
+        }
+
+        let contentsCount = Int(Double(contentsLayers.count) * parameters.mutationRate)
+        if contentsCount > 0 {
+            contentsDelegate.phase += 0.05
+
+            for _ in 0..<contentsCount {
+                contentsLayers[Int.random(in: 0..<contentsLayers.count, using: &generator)].setNeedsDisplay()
+            }
+        }
+    }
+
+    private func chance(_ ratio: Double) -> Bool {
+        Double.random(in: 0..<1, using: &generator) < ratio
+    }
+
+    private func randomColor() -> CGColor {
+        CGColor(red: CGFloat.random(in: 0...1, using: &generator), green: CGFloat.random(in: 0...1, using: &generator), blue: CGFloat.random(in: 0...1, using: &generator))
+    }
+}
@@ -0,0 +1,114 @@
+//
+//  main.swift
+//  RenderingBenchmarks
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import ArgumentParser
+
+struct RenderingBenchmarks: ParsableCommand {
+    enum Backend: String, ExpressibleByArgument, CaseIterable {
+        case volcano
+        case software
+    }
+
+    static var configuration = CommandConfiguration(
+        commandName: "renderingbenchmarks",
+        abstract: "Renders synthetic layer trees offscreen and reports frame timings as JSON. Use lavapipe via VK_ICD_FILENAMES for numbers comparable across machines"
+    )
+
+    @Option(help: "Total number of layers in the tree")
+    var layers: Int = 2000
+
+    @Option(help: "Number of levels in the tree")
+    var depth: Int = 4
+
+    @Option(help: "Fraction of layers with drawn contents")
+    var contents: Double = 0.2
+
+    @Option(help: "Fraction of layers with rounded corners")
+    var rounded: Double = 0.3
+
+    @Option(help: "Fraction of layers with borders")
+    var borders: Double = 0.2
+
+    @Option(help: "Fraction of layers that mask to bounds")
+    var masks: Double = 0.1
+
+    @Option(help: "Fraction of layers mutated every frame")
+    var mutationRate: Double = 0.05
+
+    @Option(help: "Width of the offscreen target in pixels")
+    var width: Int = 1920
+
+    @Option(help: "Height of the offscreen target in pixels")
+    var height: Int = 1080
+
+    @Option(help: "Seed of the tree generator")
+    var seed: UInt64 = 0x5EED
+
+    @Option(help: "Number of measured frames")
+    var frames: Int = 300
+
+    @Option(help: "Number of frames rendered before measurement")
+    var warmup: Int = 30
+
+    @Option(parsing: .upToNextOption, help: "Backends to run")
+    var backends: [Backend] = Backend.allCases
+
+    @Option(help: "Commit identifier stored in the report")
+    var commit: String? = nil
+
+    @Option(help: "Write report to file instead of standard output")
+    var output: String? = nil
+
+    func run() throws {
+        let parameters = SyntheticLayerTreeParameters(layersCount: layers, depth: depth, contentsRatio: contents, roundedCornersRatio: rounded, bordersRatio: borders, masksRatio: masks, mutationRate: mutationRate, width: width, height: height, seed: seed)
+
+        var results: [BackendReport] = []
+
+        for backend in backends {
+            let renderer: BenchmarkBackend
+            switch backend {
+                case .volcano: renderer = try VolcanoBackend(width: width, height: height)
+                case .software: renderer = SoftwareBackend(width: width, height: height)
+            }
+
+            // smumriak: every backend gets its own tree generated from the same seed, so both see identical trees and mutations
+            let tree = SyntheticLayerTree(parameters: parameters)
+
+            for _ in 0..<warmup {
+                tree.mutate()
+                _ = try renderer.renderFrame(tree)
+            }
+
+            var samples: [FrameSample] = []
+            samples.reserveCapacity(frames)
+
+            for _ in 0..<frames {
+                tree.mutate()
+                samples.append(try renderer.renderFrame(tree))
+            }
+
+            results.append(BackendReport(backend: renderer.name, layers: tree.layers.count, samples: samples, gpuAllocations: renderer.gpuAllocations))
+        }
+
+        let report = BenchmarkReport(commit: commit ?? ProcessInfo.processInfo.environment["APPKID_BENCHMARK_COMMIT"], date: Date(), parameters: parameters, warmupFrames: warmup, results: results)
+
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+        encoder.dateEncodingStrategy = .iso8601
+        let data = try encoder.encode(report)
+
+        if let output = output {
+            try data.write(to: URL(fileURLWithPath: output))
+        } else {
+            FileHandle.standardOutput.write(data)
+            FileHandle.standardOutput.write("\n".data(using: .utf8)!)
+        }
+    }
+}
+
+RenderingBenchmarks.main()
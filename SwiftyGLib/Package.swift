@@ -15,12 +15,14 @@ let package = Package(
     ],
     dependencies: [
         .package(path: "../TinyFoundation"),
+        .package(path: "../Sys"),
     ],
     targets: [
         .target(
             name: "SwiftyGLib",
             dependencies: [
                 .product(name: "TinyFoundation", package: "TinyFoundation"),
+                .product(name: "LinuxSys", package: "Sys", condition: .when(platforms: [.linux])),
                 "CGLib",
             ],
             swiftSettings: [
@@ -85,42 +85,66 @@ public class SwiftGMainContext: SharedPointerStorage<_GMainContext> {
         return try body()
     }
 
+    /// Highest priority of sources that are ready, as reported by the last `prepare()`. Query and check only look at sources of this priority or higher
+    internal private(set) var maximumPriority: gint = .max
+
     func prepare() -> Bool {
         return withAcquiredOwnership {
-            return g_main_context_prepare(handle, nil) != 0
+            return g_main_context_prepare(handle, &maximumPriority) != 0
         }
     }
 
-    internal private(set) var fileDescriptorsToObserve: [GPollFD] = []
+    // smumriak: buffer is kept between iterations and only grows, so steady state query does not allocate and does not have to ask glib for the count first
+    internal private(set) var pollFileDescriptors: [GPollFD] = Array(repeating: GPollFD(), count: 16)
+    internal private(set) var pollFileDescriptorsCount: Int = 0
 
-    internal func updateFileDescriptorsToObserve() -> [GPollFD] {
-        return withAcquiredOwnership {
-            var timeout: gint = 0
-            let count = g_main_context_query(handle, .max, nil, nil, 0)
+    /// Milliseconds until the earliest glib timeout as returned by the last query, -1 means there is no timeout
+    internal private(set) var timeout: gint = -1
 
-            if count > 0 {
-                fileDescriptorsToObserve = Array(repeating: GPollFD(), count: Int(count))
+    /// Fills `pollFileDescriptors` with file descriptors glib wants to poll and updates `timeout`. Has to be called after `prepare()`
+    internal func queryPollFileDescriptors() {
+        withAcquiredOwnership {
+            var count = Int(query())
 
-                fileDescriptorsToObserve.withUnsafeMutableBufferPointer {
-                    _ = g_main_context_query(handle, .max, &timeout, $0.baseAddress!, gint($0.count))
+            if count > pollFileDescriptors.count {
+                var capacity = pollFileDescriptors.count
+                while capacity < count {
+                    capacity *= 2
                 }
-            } else {
-                fileDescriptorsToObserve = []
+
+                pollFileDescriptors = Array(repeating: GPollFD(), count: capacity)
+                count = Int(query())
             }
 
-            return fileDescriptorsToObserve
+            pollFileDescriptorsCount = min(count, pollFileDescriptors.count)
         }
     }
 
-    internal var needsToDispatchEvents: Bool {
-        if fileDescriptorsToObserve.isEmpty {
-            return false
+    private func query() -> gint {
+        var timeout: gint = -1
+
+        let result = pollFileDescriptors.withUnsafeMutableBufferPointer {
+            g_main_context_query(handle, maximumPriority, &timeout, $0.baseAddress, gint($0.count))
+        }
+
+        self.timeout = timeout
+
+        return result
+    }
+
+    /// Gives access to file descriptors of the last query, i.e. to fill their `revents` before `needsToDispatchEvents` is checked
+    internal func withPollFileDescriptors<R>(_ body: (UnsafeMutableBufferPointer<GPollFD>) throws -> R) rethrows -> R {
+        let count = pollFileDescriptorsCount
+
+        return try pollFileDescriptors.withUnsafeMutableBufferPointer {
+            try body(UnsafeMutableBufferPointer(rebasing: $0[0..<count]))
         }
+    }
 
+    internal var needsToDispatchEvents: Bool {
         return withAcquiredOwnership {
-            return fileDescriptorsToObserve.withUnsafeMutableBufferPointer {
-                let result = g_main_context_check(handle, .max, $0.baseAddress, gint($0.count))
-                return result == 1
+            return withPollFileDescriptors {
+                return g_main_context_check(handle, maximumPriority, $0.baseAddress, gint($0.count)) != 0
             }
         }
     }
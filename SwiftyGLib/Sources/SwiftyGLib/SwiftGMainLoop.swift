@@ -9,6 +9,10 @@ import Foundation
 import CGlib
 import TinyFoundation
 
+#if os(Linux)
+    import LinuxSys
+#endif
+
 // public class SwiftGMainLoop {
 //     public let context: SwiftGMainContext
 
@@ -40,7 +44,19 @@ import TinyFoundation
 internal class SwiftGMainLoopRunLoopSource {
     private let context: SwiftGMainContext
     private let epollFileDescriptorPort: FileDescriptorPort
-    private var observedGlibFileDescriptors: [GPollFD] = []
+    /// Armed with glib's timeout, so timeouts and idle sources wake the run loop up even if no file descriptor becomes ready
+    private let timerFileDescriptor: CInt
+    private var timerIsArmed = false
+
+    /// Epoll events currently registered for every glib file descriptor
+    private var registeredEvents: [CInt: UInt32] = [:]
+    private var requestedEvents: [CInt: UInt32] = [:]
+    private var readyEvents: [epoll_event] = Array(repeating: epoll_event(), count: 64)
+
+    /// Number of epoll, timerfd and read syscalls issued by this source
+    internal private(set) var syscallCount: Int = 0
+    /// Number of times glib sources were dispatched by this source
+    internal private(set) var dispatchCount: Int = 0
 
     internal init(context: SwiftGMainContext) {
         let epollFd = epoll_create1(Int32(EPOLL_CLOEXEC))
@@ -50,20 +66,30 @@ internal class SwiftGMainLoopRunLoopSource {
             fatalError("Can not create new epoll file descriptor, system is broken and further execution is not possible")
         }
 
+        let timerFileDescriptor = timerfd_create(CLOCK_MONOTONIC, CInt(TFD_CLOEXEC | TFD_NONBLOCK))
+
+        if timerFileDescriptor == -1 {
+            fatalError("Can not create new timer file descriptor, system is broken and further execution is not possible")
+        }
+
         self.context = context
+        self.timerFileDescriptor = timerFileDescriptor
 
         self.epollFileDescriptorPort = epollFileDescriptorPort
         epollFileDescriptorPort.enableNotificationType([.read])
 
         epollFileDescriptorPort.setDelegate(self)
 
-        _ = context.prepare()
-        observedGlibFileDescriptors = context.updateFileDescriptorsToObserve()
+        var timerEpollEvent = epoll_event()
+        timerEpollEvent.data.fd = timerFileDescriptor
+        timerEpollEvent.events = EPOLL_EVENTS.EPOLLIN.rawValue
+        _ = epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFileDescriptor, &timerEpollEvent)
 
-        observedGlibFileDescriptors.forEach {
-            var addEpollEvent = $0.epollEvent
-            _ = epoll_ctl(epollFileDescriptorPort.fileDescriptor, EPOLL_CTL_ADD, $0.fd, &addEpollEvent)
-        }
+        prepareNextIteration()
+    }
+
+    deinit {
+        close(timerFileDescriptor)
     }
 
     internal func schedule(in runLoop: RunLoop, forMode mode: RunLoop.Mode) {
@@ -78,25 +104,135 @@ internal class SwiftGMainLoopRunLoopSource {
         epollFileDescriptorPort.invalidate()
     }
 
-    internal func stopObservingKnownDescriptors() {
-        var deleteEpollEvent = epoll_event()
-        observedGlibFileDescriptors.forEach {
-            deleteEpollEvent.data.fd = $0.fd
-            _ = epoll_ctl(epollFileDescriptorPort.fileDescriptor, EPOLL_CTL_DEL, $0.fd, &deleteEpollEvent)
+    /// Collects readiness of glib file descriptors from epoll without blocking and stores it as `revents` of the last query. Returns true if timer file descriptor has fired
+    internal func collectReadyEvents() -> Bool {
+        var timerHasFired = false
+
+        context.withPollFileDescriptors { pollFileDescriptors in
+            for index in pollFileDescriptors.indices {
+                pollFileDescriptors[index].revents = 0
+            }
+
+            let count = readyEvents.withUnsafeMutableBufferPointer {
+                epoll_wait(epollFileDescriptorPort.fileDescriptor, $0.baseAddress, CInt($0.count), 0)
+            }
+            syscallCount += 1
+
+            if count <= 0 {
+                return
+            }
+
+            for readyEvent in readyEvents[0..<Int(count)] {
+                let fileDescriptor = readyEvent.data.fd
+
+                if fileDescriptor == timerFileDescriptor {
+                    timerHasFired = true
+                    continue
+                }
+
+                let condition = GIOCondition(epollEvents: readyEvent.events)
+
+                for index in pollFileDescriptors.indices where pollFileDescriptors[index].fd == fileDescriptor {
+                    let requested = UInt32(pollFileDescriptors[index].events) | G_IO_ERR.rawValue | G_IO_HUP.rawValue | G_IO_NVAL.rawValue
+                    pollFileDescriptors[index].revents = gushort(truncatingIfNeeded: condition.rawValue & requested)
+                }
+            }
         }
+
+        if timerHasFired {
+            var expirations: UInt64 = 0
+            _ = read(timerFileDescriptor, &expirations, MemoryLayout<UInt64>.size)
+            syscallCount += 1
+            timerIsArmed = false
+        }
+
+        return timerHasFired
     }
 
-    internal func refreshKnownDescriptors() {
+    /// Prepares glib for the next poll and brings epoll registrations and timer in sync with what glib asked for
+    internal func prepareNextIteration() {
         _ = context.prepare()
+        context.queryPollFileDescriptors()
 
-        observedGlibFileDescriptors = context.updateFileDescriptorsToObserve()
+        synchronizeRegistrations()
+        armTimer(timeout: context.timeout)
     }
 
-    internal func startObservingKnownDescriptors() {
-        observedGlibFileDescriptors.forEach {
-            var addEpollEvent = $0.epollEvent
-            _ = epoll_ctl(epollFileDescriptorPort.fileDescriptor, EPOLL_CTL_ADD, $0.fd, &addEpollEvent)
+    // smumriak: glib mostly asks for the same set of file descriptors every iteration, so only the difference goes to epoll. descriptors are level triggered, same as in glib's own poll, so nothing has to be rearmed after it fired
+    internal func synchronizeRegistrations() {
+        requestedEvents.removeAll(keepingCapacity: true)
+
+        context.withPollFileDescriptors { pollFileDescriptors in
+            for pollFileDescriptor in pollFileDescriptors where pollFileDescriptor.fd >= 0 {
+                requestedEvents[pollFileDescriptor.fd, default: 0] |= pollFileDescriptor.epollEvents
+            }
+        }
+
+        for (fileDescriptor, events) in requestedEvents {
+            if let registered = registeredEvents[fileDescriptor] {
+                if registered != events {
+                    control(EPOLL_CTL_MOD, fileDescriptor: fileDescriptor, events: events)
+                }
+            } else {
+                control(EPOLL_CTL_ADD, fileDescriptor: fileDescriptor, events: events)
+            }
+        }
+
+        for fileDescriptor in registeredEvents.keys where requestedEvents[fileDescriptor] == nil {
+            control(EPOLL_CTL_DEL, fileDescriptor: fileDescriptor, events: 0)
         }
+
+        swap(&registeredEvents, &requestedEvents)
+    }
+
+    private func control(_ operation: CInt, fileDescriptor: CInt, events: UInt32) {
+        var epollEvent = epoll_event()
+        epollEvent.data.fd = fileDescriptor
+        epollEvent.events = events
+
+        let epollFileDescriptor = epollFileDescriptorPort.fileDescriptor
+
+        syscallCount += 1
+        if epoll_ctl(epollFileDescriptor, operation, fileDescriptor, &epollEvent) == 0 {
+            return
+        }
+
+        // smumriak: glib could have closed descriptor and opened another one with the same number in between iterations, epoll drops closed descriptors on its own
+        switch (operation, errno) {
+            case (EPOLL_CTL_MOD, ENOENT):
+                syscallCount += 1
+                _ = epoll_ctl(epollFileDescriptor, EPOLL_CTL_ADD, fileDescriptor, &epollEvent)
+
+            case (EPOLL_CTL_ADD, EEXIST):
+                syscallCount += 1
+                _ = epoll_ctl(epollFileDescriptor, EPOLL_CTL_MOD, fileDescriptor, &epollEvent)
+
+            default:
+                break
+        }
+    }
+
+    private func armTimer(timeout: gint) {
+        var timespec = itimerspec()
+
+        if timeout < 0 {
+            if timerIsArmed == false {
+                return
+            }
+
+            timerIsArmed = false
+        } else {
+            // smumriak: zero value disarms timerfd, so zero timeout is clamped to one nanosecond
+            let delta = max(Int(timeout) * 1_000_000, 1)
+
+            timespec.it_value.tv_sec = delta / 1_000_000_000
+            timespec.it_value.tv_nsec = delta % 1_000_000_000
+
+            timerIsArmed = true
+        }
+
+        syscallCount += 1
+        _ = timerfd_settime(timerFileDescriptor, 0, &timespec, nil)
     }
 }
 
@@ -104,35 +240,26 @@ extension SwiftGMainLoopRunLoopSource: FileDescriptorPortDelegate {
     func handle(_ message: PortMessage) {}
 
     func handle(awokenFileDescriptorPort: FileDescriptorPort) {
-        // 2. perform g_main_context_check with known file descriptors
-        if context.needsToDispatchEvents {
-            // 1. remove all previously known file descriptors from epoll file descriptor via epoll_ctl + EPOLL_CTL_DEL
-            stopObservingKnownDescriptors()
+        // 1. collect readiness of known file descriptors from epoll, without blocking
+        _ = collectReadyEvents()
 
-            // 3. if check returned true perform g_main_context_dispatch
+        // 2. perform g_main_context_check with known file descriptors and dispatch if check returned true
+        if context.needsToDispatchEvents {
             context.dispatchEvents()
+            dispatchCount += 1
+        }
 
-            // 4. prepare glib poll shit via g_main_context_prepare
-            // 5. query new set of file descriptors to poll
-            refreshKnownDescriptors()
-
-            // 6. add this set of file descriptors to epoll file descriptor via epoll_ctl + EPOLL_CTL_ADD
-            startObservingKnownDescriptors()
+        // 3. prepare, query and apply the difference in file descriptors and timeout to epoll and timer
+        prepareNextIteration()
 
-            // 7. enable read notification on awoken file descriptor
-            awokenFileDescriptorPort.enableNotificationType([.read])
-        }
+        // 4. enable read notification on awoken file descriptor
+        awokenFileDescriptorPort.enableNotificationType([.read])
     }
 }
 
 internal extension GPollFD {
-    var epollEvent: epoll_event {
-        var result = epoll_event()
-
-        result.data.fd = fd
-        result.events = GIOCondition(rawValue: UInt32(events)).epollEvents.rawValue
-
-        return result
+    var epollEvents: UInt32 {
+        GIOCondition(rawValue: UInt32(events)).epollEvents.rawValue
     }
 }
 
@@ -160,8 +287,32 @@ internal extension GIOCondition {
             result.formUnion(.EPOLLHUP)
         }
 
-        result.formUnion([.EPOLLONESHOT, .EPOLLET])
-
         return result
     }
+
+    init(epollEvents: UInt32) {
+        var result: UInt32 = 0
+
+        if (epollEvents & EPOLL_EVENTS.EPOLLIN.rawValue) != 0 {
+            result |= G_IO_IN.rawValue
+        }
+
+        if (epollEvents & EPOLL_EVENTS.EPOLLOUT.rawValue) != 0 {
+            result |= G_IO_OUT.rawValue
+        }
+
+        if (epollEvents & EPOLL_EVENTS.EPOLLPRI.rawValue) != 0 {
+            result |= G_IO_PRI.rawValue
+        }
+
+        if (epollEvents & EPOLL_EVENTS.EPOLLERR.rawValue) != 0 {
+            result |= G_IO_ERR.rawValue
+        }
+
+        if (epollEvents & EPOLL_EVENTS.EPOLLHUP.rawValue) != 0 {
+            result |= G_IO_HUP.rawValue
+        }
+
+        self.init(rawValue: result)
+    }
 }
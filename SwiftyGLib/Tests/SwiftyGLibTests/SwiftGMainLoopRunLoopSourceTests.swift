@@ -38,4 +38,43 @@ final class SwiftGMainLoopRunLoopSourceTests: XCTestCase {
 
         XCTAssertEqual(timerTickCount, 5)
     }
+
+    // smumriak: every iteration used to requery glib twice and re-add every file descriptor to epoll. now steady state is epoll_wait, timerfd read and rearm, with epoll_ctl only when glib's set of file descriptors changes
+    func testSyscallsPerDispatchedEvent() throws {
+        let mainContext = SwiftGMainContext(handle: RetainablePointer(with: g_main_context_default()))
+        let source = try XCTUnwrap(SwiftGMainLoopRunLoopSource(context: mainContext))
+        defer {
+            source.invalidate()
+        }
+
+        let tickCount = 1000
+        timerTickCount = 0
+
+        _ = g_timeout_add(0, { userData in
+            guard let userData = userData else {
+                return 0
+            }
+
+            let `self` = Unmanaged<SwiftGMainLoopRunLoopSourceTests>.fromOpaque(userData).takeUnretainedValue()
+
+            self.timerTickCount += 1
+
+            return self.timerTickCount < 1000 ? 1 : 0
+        }, Unmanaged<SwiftGMainLoopRunLoopSourceTests>.passUnretained(self).toOpaque())
+
+        source.prepareNextIteration()
+        source.schedule(in: .current, forMode: .common)
+
+        let deadline = Date(timeIntervalSinceNow: 10)
+        while timerTickCount < tickCount && Date() < deadline {
+            RunLoop.current.run(until: Date(timeIntervalSinceNow: 0.1))
+        }
+
+        XCTAssertEqual(timerTickCount, tickCount)
+
+        let syscallsPerDispatch = Double(source.syscallCount) / Double(max(source.dispatchCount, 1))
+        print("GLib run loop source: \(source.dispatchCount) dispatches, \(source.syscallCount) syscalls, \(String(format: "%.2f", syscallsPerDispatch)) syscalls per dispatch")
+
+        XCTAssertLessThan(syscallsPerDispatch, 6.0)
+    }
 }
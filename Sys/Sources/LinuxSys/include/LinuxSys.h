@@ -36,6 +36,7 @@ AK_EXISTING_OPTIONS(EPOLL_EVENTS);
 #include <unistd.h>
 
 #include "wait_macros.h"
+#include "futex_macros.h"
 
 extern __pid_t gettid (void) __THROW;
 extern int ppoll (struct pollfd *__fds, nfds_t __nfds,
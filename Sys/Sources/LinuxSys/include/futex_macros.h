@@ -0,0 +1,30 @@
+//
+//  futex_macros.h
+//  LinuxSys
+//  
+//  Created by Serhii Mumriak on 19.10.2026
+//
+
+#include <errno.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+// smumriak: syscall is variadic, so it is not imported into swift. these wrappers return 0 on success and errno otherwise
+static inline int futexWait(uint32_t *address, uint32_t expected, const struct timespec *timeout) {
+    return syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, timeout, NULL, 0) == 0 ? 0 : errno;
+}
+
+static inline int futexWake(uint32_t *address, int count) {
+    return syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0) >= 0 ? 0 : errno;
+}
+
+static inline void cpuRelax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
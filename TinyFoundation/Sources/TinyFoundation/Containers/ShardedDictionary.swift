@@ -0,0 +1,78 @@
+//
+//  ShardedDictionary.swift
+//  TinyFoundation
+//
+//  Created by Serhii Mumriak on 19.10.2026
+//
+
+/// Thread safe dictionary split into shards by hash of the key. Every shard has its own lock, so threads that work with different keys rarely wait for each other
+public final class ShardedDictionary<Key: Hashable, Value> {
+    internal final class Shard {
+        let lock = FutexLock()
+        var storage: [Key: Value] = [:]
+    }
+
+    internal let shards: [Shard]
+    internal let mask: Int
+
+    /// Shard count is rounded up to power of two
+    public init(shardCount: Int = 16) {
+        var count = 1
+        while count < shardCount {
+            count <<= 1
+        }
+
+        shards = (0..<count).map { _ in Shard() }
+        mask = count - 1
+    }
+
+    @_transparent
+    internal func shardContaining(_ key: Key) -> Shard {
+        shards[key.hashValue & mask]
+    }
+
+    public subscript(key: Key) -> Value? {
+        get {
+            let shard = shardContaining(key)
+            return shard.lock.synchronized { shard.storage[key] }
+        }
+        set {
+            let shard = shardContaining(key)
+            shard.lock.synchronized { shard.storage[key] = newValue }
+        }
+    }
+
+    @discardableResult
+    public func removeValue(forKey key: Key) -> Value? {
+        let shard = shardContaining(key)
+        return shard.lock.synchronized { shard.storage.removeValue(forKey: key) }
+    }
+
+    /// Runs the body with storage of the shard that holds the key while that shard is locked. Lets callers check and insert atomically
+    public func withShard<T>(for key: Key, _ body: (inout [Key: Value]) throws -> T) rethrows -> T {
+        let shard = shardContaining(key)
+        return try shard.lock.synchronized { try body(&shard.storage) }
+    }
+
+    public func removeAll() {
+        shards.forEach { shard in
+            shard.lock.synchronized { shard.storage.removeAll() }
+        }
+    }
+
+    public var count: Int {
+        shards.reduce(0) { result, shard in
+            result + shard.lock.synchronized { shard.storage.count }
+        }
+    }
+
+    /// Sum of contention counters of all shard locks
+    public var lockStatistics: LockStatistics {
+        shards.reduce(into: LockStatistics()) { result, shard in
+            let statistics = shard.lock.statistics
+            result.acquisitions += statistics.acquisitions
+            result.contendedAcquisitions += statistics.contendedAcquisitions
+            result.waitTime += statistics.waitTime
+        }
+    }
+}
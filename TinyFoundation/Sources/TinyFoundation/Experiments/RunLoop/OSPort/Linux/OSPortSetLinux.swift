@@ -12,12 +12,15 @@
     public extension OSPortSet {
         struct Context {
             public var timeout: Duration? = nil
+            // smumriak: upper bound of ready ports reported by single epoll_wait. the rest is reported by the next one
+            public var maximumEvents: Int = 64
             public init() {}
         }
 
         enum WakeUpResult {
             case timeout
             case awokenPort(any OSPortProtocol)
+            case awokenPorts([any OSPortProtocol])
         }
 
         mutating func addPort(_ port: some OSPortProtocol) throws {
@@ -72,22 +75,29 @@
 
         // throws POSIXErrorCode with possible values from [.EBADF, .EFAULT, .EINVAL]
         func wait(context: Context = Context()) throws -> WakeUpResult {
-            var event = epoll_event()
-            let result = try syscall {
-                epoll_wait(handle /* epfd */,
-                           &event /* events */,
-                           1, /* maxevents */
-                           CInt(context.timeout?.milliseconds ?? -1) /* timeout */ )
-            }
-            switch result {
-                case 0:
-                    return .timeout
+            try withUnsafeTemporaryAllocation(of: epoll_event.self, capacity: max(context.maximumEvents, 1)) { events in
+                let result = try syscall {
+                    epoll_wait(handle /* epfd */,
+                               events.baseAddress! /* events */,
+                               CInt(events.count), /* maxevents */
+                               CInt(context.timeout?.milliseconds ?? -1) /* timeout */ )
+                }
 
-                case 1:
-                    return .awokenPort(ports[event.data.fd]!)
+                switch result {
+                    case 0:
+                        return .timeout
 
-                default:
-                    fatalError("epoll_wait returned more than one signaled file descriptor. This should not happen and indicates and error in kernel")
+                    case 1:
+                        // smumriak: port might have been removed from the set by other thread while this one was waiting
+                        if let port = ports[events[0].data.fd] {
+                            return .awokenPort(port)
+                        } else {
+                            return .awokenPorts([])
+                        }
+
+                    default:
+                        return .awokenPorts(events.prefix(Int(result)).compactMap { ports[$0.data.fd] })
+                }
             }
         }
     }
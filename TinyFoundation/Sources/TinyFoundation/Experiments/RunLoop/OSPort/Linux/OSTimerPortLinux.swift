@@ -23,7 +23,7 @@
         
         init() throws {
             try handle = syscall {
-                timerfd_create(0, CInt(EFD_CLOEXEC | EFD_NONBLOCK))
+                timerfd_create(CLOCK_MONOTONIC, CInt(TFD_CLOEXEC | TFD_NONBLOCK))
             }
             shouldFree = true
         }
@@ -35,17 +35,21 @@
             }
         }
 
-        func schedule(deadline: Int64) throws {
+        // smumriak: deadline is in UInt64.absoluteTime domain, which is CLOCK_MONOTONIC_RAW. timerfd does not support that clock, so timer is armed relative to now. zero value disarms timerfd, so deadlines in the past are clamped to one nanosecond
+        func schedule(deadline: UInt64) throws {
+            let now: UInt64 = .absoluteTime
+            let delta = deadline > now ? deadline - now : 1
+
             var timespec = itimerspec()
             timespec.it_interval.tv_sec = 0
             timespec.it_interval.tv_nsec = 0
 
-            timespec.it_value.tv_sec = Int(deadline / 1_000_000_000)
-            timespec.it_value.tv_nsec = Int(deadline % 1_000_000_000)
+            timespec.it_value.tv_sec = Int(delta / 1_000_000_000)
+            timespec.it_value.tv_nsec = Int(delta % 1_000_000_000)
 
             try syscall {
                 timerfd_settime(handle /* ufd */,
-                                CInt(TFD_TIMER_ABSTIME) /* flags */,
+                                0 /* flags */,
                                 &timespec /* itimerspec */,
                                 nil /* otmr */ )
             }
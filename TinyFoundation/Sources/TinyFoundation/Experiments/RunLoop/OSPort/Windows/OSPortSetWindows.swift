@@ -15,6 +15,7 @@
         enum WakeUpResult {
             case timeout
             case awokenPort(any OSPortProtocol)
+            case awokenPorts([any OSPortProtocol])
             case windowsEvent
             case abandonedMutex(any OSPortProtocol)
             case inputOutputCompletion // whatever WAIT_IO_COMPLETION is used for
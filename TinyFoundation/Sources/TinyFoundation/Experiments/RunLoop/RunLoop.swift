@@ -33,8 +33,6 @@ import Atomics
 // TODO: Clear ports from run loop observers found in modes in deinit of RunLoop
 // TODO: Clear ports from timers found in modes in deinit of RunLoop
 // TODO: Traverses list of stored blocks in runloop and check if any block is scheduled in current runloop while determining if mode is empty
-// TODO: Reposition timer in timers list
-// TODO: Arm next timer
 
 // smumriak: original CoreFoundation code performs weakCompareExchange operation with sequentially consistend rules for success and failure. this code does not need that since it explicitly checks initial state on every operation, so it is safe to use atomic sequentially consistend storage operation
 public typealias TFValid = AtomicSequentiallyConsistent
@@ -186,9 +184,8 @@ internal let timeoutLimit: TimeInterval = 0
                     mode.lock.synchronized {
                         mode.sources.forEach { source in
                             source.lock.synchronized {
-                                if let index = source.runLoops.firstIndex(of: self) {
-                                    source.runLoops.remove(at: index)
-                                }
+                                // smumriak: weak references to run loop that is being deinitialized already read as nil
+                                source.runLoops.removeAll { $0.runLoop == nil }
                             }
 
                             source.context.cleanupOnDeinit(runLoop: self, mode: mode, name: name)
@@ -247,9 +244,13 @@ internal let timeoutLimit: TimeInterval = 0
                 }
 
                 let mode = createModeForNameIfNeeded(name)
-                mode.sources.formUnion(commonModeItems.sources)
+                commonModeItems.sources.forEach {
+                    mode.addSource($0)
+                }
                 mode.observers.append(contentsOf: commonModeItems.observers)
-                mode.timers.append(contentsOf: commonModeItems.timers)
+                commonModeItems.timers.forEach {
+                    mode.addTimer($0, runLoop: self)
+                }
                 
                 modes[name] = mode
                 commonModes.insert(name)
@@ -343,6 +344,47 @@ internal let timeoutLimit: TimeInterval = 0
             }
         }
 
+        fileprivate func fireTimers(in mode: RunLoopMode) -> Bool {
+            // runloop and mode are locked on entrance and exit
+            let now: UInt64 = .absoluteTime
+            let timers = mode.timers.timersToFire(at: now)
+
+            guard timers.isEmpty == false else { return false }
+
+            mode.lock.desynchronized {
+                lock.desynchronized {
+                    timers.forEach { timer in
+                        let callBack: Timer1.CallBack? = timer.lock.synchronized {
+                            guard timer.isValid && timer.isFiring == false else {
+                                return nil
+                            }
+
+                            timer.isFiring = true
+                            return timer.callBack
+                        }
+
+                        guard let callBack else { return }
+
+                        callBack(timer)
+
+                        timer.lock.synchronized {
+                            timer.isFiring = false
+                        }
+
+                        guard timer.isValid else { return }
+
+                        if timer.repeats {
+                            rescheduleTimer(timer, fireTSR: timer.nextFireTSR(after: now))
+                        } else {
+                            timer.invalidate()
+                        }
+                    }
+                }
+            }
+
+            return true
+        }
+
         fileprivate func actualRun(in mode: RunLoopMode, name: Mode, duration: TimeInterval, stopAfterHandle: Bool, previousMode: RunLoopMode?) throws -> RunResult {
             let startTSR: UInt64 = .absoluteTime
 
@@ -418,40 +460,57 @@ internal let timeoutLimit: TimeInterval = 0
                     }
 
                     notifyObservers(for: .afterWaiting, mode: mode)
-                    let result: RunResult
 
-                    switch wakeUpResult {
-                        case .awokenPort(let value) where value.isEqual(to: wakeUpPort):
-                            try wakeUpPort.acknowledge()
-                            result = .handledSource
+                    let awokenPorts: [any OSPortProtocol]
 
-                        case .awokenPort(let value) where value.isEqual(to: mode.timerPort):
-                            try mode.timerPort.acknowledge()
-                            result = .handledSource
+                    switch wakeUpResult {
+                        case .timeout:
+                            awokenPorts = []
 
-                        case .awokenPort(let value) where value.isEqual(to: dispatchMainQueuePort):
-                            isInMainQueue = true
-                            defer { isInMainQueue = false }
-                            let dummy: UnsafeMutableRawPointer? = nil
-                            _dispatch_main_queue_callback_4CF(dummy)
-                            try dispatchMainQueuePort?.acknowledge()
-                            result = .handledSource
+                        case .awokenPort(let value):
+                            awokenPorts = [value]
 
-                        case .timeout:
-                            result = .timedOut
+                        case .awokenPorts(let values):
+                            awokenPorts = values
 
                         #if os(Windows)
-                            case .windowsEvent:
-                                break
+                            case .windowsEvent, .inputOutputCompletion:
+                                awokenPorts = []
 
-                            case .inputOutputCompletion:
-                                break
+                            case .abandonedMutex(let value):
+                                awokenPorts = [value]
                         #endif
+                    }
 
-                        case let value:
-                            fatalError("Unhandled port set wait result: \(value)")
+                    if awokenPorts.isEmpty {
+                        return .timedOut
+                    }
+
+                    // smumriak: epoll can report many ready ports in one wait, every one of them is handled before going back to sleep
+                    for port in awokenPorts {
+                        if port.isEqual(to: wakeUpPort) {
+                            try wakeUpPort.acknowledge()
+                        } else if port.isEqual(to: mode.timerPort) {
+                            try mode.timerPort.acknowledge()
+                            mode.armedTimerDeadline = nil
+                            _ = fireTimers(in: mode)
+                            mode.armTimerPort()
+                        } else if port.isEqual(to: dispatchMainQueuePort) {
+                            isInMainQueue = true
+                            defer { isInMainQueue = false }
+                            let dummy: UnsafeMutableRawPointer? = nil
+                            _dispatch_main_queue_callback_4CF(dummy)
+                            try dispatchMainQueuePort?.acknowledge()
+                        } else if let source = mode.portSources[port.handle], source.isValid {
+                            mode.lock.desynchronized {
+                                lock.desynchronized {
+                                    source.context.perform()
+                                }
+                            }
+                        }
                     }
 
+                    let result: RunResult = .handledSource
                     return result
                 }
             }
@@ -14,8 +14,10 @@
         internal var timerPort: OSTimerPort
         public internal(set) var activity: RunLoop1.Activity = []
         internal var sources: Set<RunLoop1.Source> = []
+        internal var portSources: [OSPort.HandleType: RunLoop1.Source] = [:]
         internal var observers: [RunLoop1.Observer] = []
-        internal var timers: [Timer1] = []
+        internal var timers = TimerQueue()
+        internal var armedTimerDeadline: UInt64? = nil
 
         deinit {
             do {
@@ -51,6 +53,9 @@
         func addSource(_ source: RunLoop1.Source) {
             lock.synchronized {
                 source.context.addTo(portSet: &portSet)
+                if let portHandle = source.context.portHandle {
+                    portSources[portHandle] = source
+                }
                 sources.insert(source)
             }
         }
@@ -59,6 +64,9 @@
         func removeSource(_ source: RunLoop1.Source) {
             lock.synchronized {
                 source.context.removeFrom(portSet: &portSet)
+                if let portHandle = source.context.portHandle {
+                    portSources[portHandle] = nil
+                }
                 sources.remove(source)
             }
         }
@@ -93,8 +101,10 @@
                     } else if timer.runLoop != runLoop {
                         return
                     }
-                
-                    // TODO: Reposition timer in timers list
+
+                    timer.modes.insert(name)
+                    timers.insert(timer)
+                    armTimerPort()
                 }
             }
         }
@@ -102,32 +112,32 @@
         @_transparent
         func removeTimer(_ timer: Timer1) {
             lock.synchronized {
-                if let index = timers.firstIndex(of: timer) {
-                    timers.remove(at: index)
+                if timers.remove(timer) {
                     timer.modes.remove(self.name)
                     if timer.modes.isEmpty {
                         timer.runLoop = nil
                     }
 
-                    // TODO: Arm next timer
+                    armTimerPort()
                 }
             }
         }
 
-        @_transparent
-        func repositionTimer(_ timer: Timer1, isAlreadyPresent: Bool) {
-            // smumriak: mode is locked on enter and exit
-            if isAlreadyPresent {
-                if let index = timers.firstIndex(of: timer) {
-                    timers.remove(at: index)
-                } else {
-                    return
+        // smumriak: mode is locked on enter and exit. there is exactly one timerfd per mode and it is always armed for the earliest deadline. syscall is skipped if the deadline did not change, which is the common case when timers are added to the back of the queue
+        func armTimerPort() {
+            do {
+                if let deadline = timers.nextDeadline {
+                    if deadline != armedTimerDeadline {
+                        try timerPort.schedule(deadline: deadline)
+                        armedTimerDeadline = deadline
+                    }
+                } else if armedTimerDeadline != nil {
+                    try timerPort.cancel()
+                    armedTimerDeadline = nil
                 }
+            } catch {
+                fatalError("Sorry, RunLoop failed to arm timer port with error: \(error)")
             }
-
-            let newIndex = timers.findInsertionIndex(for: timer, keyPath: \.fireDate, options: .anyEqual)
-            timers.insert(timer, at: newIndex)
-            // TODO: Arm next timer
         }
     }
 
@@ -40,7 +40,8 @@ import Atomics
             internal var signaledTime: UInt64 = 0
         
             internal let context: Context
-            internal var runLoops: [RunLoop1] = []
+            // smumriak: run loop retains source through its modes, so source only keeps weak references back to avoid retain cycle
+            internal var runLoops: [WeakRunLoop] = []
         
             internal enum Context {
                 case zero(_ context: any RunLoopSourceContext0)
@@ -96,6 +97,17 @@ import Atomics
                     }
                 }
 
+                @_transparent
+                var portHandle: OSPort.HandleType? {
+                    switch self {
+                        case .zero(_):
+                            return nil
+
+                        case let .one(context):
+                            return context.port.handle
+                    }
+                }
+
                 @_transparent
                 func addTo(portSet: inout OSPortSet) {
                     switch self {
@@ -165,6 +177,9 @@ import Atomics
                 lock.synchronized {
                     isValid = false
 
+                    let runLoops = self.runLoops.compactMap { $0.runLoop }
+                    self.runLoops.removeAll()
+
                     if runLoops.isEmpty == false {
                         lock.desynchronized {
                             runLoops.forEach {
@@ -184,6 +199,10 @@ import Atomics
             }
         }
 
+        internal struct WeakRunLoop {
+            weak var runLoop: RunLoop1?
+        }
+
         @_transparent
         internal func removeSource(_ source: Source) {
             lock.synchronized {
@@ -191,10 +210,27 @@ import Atomics
                 modes.values.forEach { mode in
                     mode.removeSource(source)
                 }
+
+                forgetSource(source)
+            }
+        }
+
+        /// Drops reference to this run loop from source if source is not scheduled in any of the modes anymore. Must be called with run loop locked
+        internal func forgetSource(_ source: Source) {
+            let isScheduled = commonModeItems.sources.contains(source) || modes.values.contains { mode in
+                mode.lock.synchronized { mode.sources.contains(source) }
+            }
+
+            guard isScheduled == false else { return }
+
+            source.lock.synchronized {
+                source.runLoops.removeAll { $0.runLoop == nil || $0.runLoop === self }
             }
         }
 
         func addSource(_ source: Source, mode modeName: Mode) {
+            guard source.isValid else { return }
+
             lock.synchronized {
                 if modeName == .common {
                     commonModeItems.sources.insert(source)
@@ -202,7 +238,15 @@ import Atomics
                         modes[$0]?.addSource(source)
                     }
                 } else {
-                    modes[modeName]?.addSource(source)
+                    createModeForNameIfNeeded(modeName).addSource(source)
+                }
+
+                source.lock.synchronized {
+                    source.runLoops.removeAll { $0.runLoop == nil }
+
+                    if source.runLoops.contains(where: { $0.runLoop === self }) == false {
+                        source.runLoops.append(WeakRunLoop(runLoop: self))
+                    }
                 }
             }
         }
@@ -217,6 +261,8 @@ import Atomics
                 } else {
                     modes[modeName]?.removeSource(source)
                 }
+
+                forgetSource(source)
             }
         }
     }
@@ -23,13 +23,35 @@ import Foundation
         internal let callBack: CallBack
     
         public let timeInterval: TimeInterval
-        public var tolerance: TimeInterval = 0.0
+        public var tolerance: TimeInterval = 0.0 {
+            didSet {
+                guard tolerance != oldValue else { return }
+
+                if let runLoop = lock.synchronized({ self.runLoop }) {
+                    runLoop.rescheduleTimer(self, fireTSR: fireTSR)
+                } else {
+                    lock.synchronized {
+                        setFireTSR(fireTSR)
+                    }
+                }
+            }
+        }
 
         public internal(set) var fireDate: Date
 
         internal let lock = RecursiveLock()
         internal unowned var runLoop: RunLoop1? = nil
         internal var modes: Set<RunLoop1.Mode> = []
+        internal var isFiring: Bool = false
+
+        // smumriak: fire date and fire date plus tolerance in UInt64.absoluteTime domain. these are keys of timer heaps in run loop modes, so they are changed only while timer is not in any of them
+        internal private(set) var fireTSR: UInt64 = 0
+        internal private(set) var deadlineTSR: UInt64 = 0
+
+        internal var intervalNanoseconds: UInt64 {
+            // smumriak: same lower limit CFRunLoopTimer has for repeating timers
+            UInt64(max(timeInterval, 0.0001) * 1_000_000_000)
+        }
 
         deinit {
             invalidate()
@@ -40,6 +62,8 @@ import Foundation
             self.repeats = repeats
             self.callBack = block
             self.fireDate = fireDate
+
+            setFireTSR(UInt64.absoluteTime + fireDate.timeIntervalSinceNow.nanosecondsIfPositive)
         }
 
         public convenience init(interval timeInterval: TimeInterval, repeats: Bool, block: @escaping CallBack) {
@@ -53,6 +77,31 @@ import Foundation
         }
     
         public func fire() {
+            guard isValid else { return }
+
+            callBack(self)
+
+            if repeats == false {
+                invalidate()
+            }
+        }
+
+        internal func setFireTSR(_ value: UInt64) {
+            fireTSR = value
+            deadlineTSR = value + tolerance.nanosecondsIfPositive
+            fireDate = Date(timeIntervalSinceNow: value.timeIntervalUntilTSR / 1_000_000_000)
+        }
+
+        internal func nextFireTSR(after now: UInt64) -> UInt64 {
+            let interval = intervalNanoseconds
+            var result = fireTSR + interval
+
+            // smumriak: skip missed fire dates instead of firing them in a burst
+            if result <= now {
+                result += ((now - result) / interval + 1) * interval
+            }
+
+            return result
         }
 
         public func invalidate() {
@@ -74,7 +123,39 @@ import Foundation
         }
     }
 
+    internal extension TimeInterval {
+        @_transparent
+        var nanosecondsIfPositive: UInt64 {
+            self > 0 ? UInt64(self * 1_000_000_000) : 0
+        }
+    }
+
     public extension RunLoop1 {
+        internal func rescheduleTimer(_ timer: Timer1, fireTSR: UInt64) {
+            lock.synchronized {
+                let containingModes = modes.values.filter { mode in
+                    mode.lock.synchronized { mode.timers.contains(timer) }
+                }
+
+                containingModes.forEach { mode in
+                    mode.lock.synchronized {
+                        mode.timers.remove(timer)
+                    }
+                }
+
+                timer.lock.synchronized {
+                    timer.setFireTSR(fireTSR)
+                }
+
+                containingModes.forEach { mode in
+                    mode.lock.synchronized {
+                        mode.timers.insert(timer)
+                        mode.armTimerPort()
+                    }
+                }
+            }
+        }
+
         internal func removeTimer(_ timer: Timer1) {
             lock.synchronized {
                 commonModeItems.timers.remove(timer)
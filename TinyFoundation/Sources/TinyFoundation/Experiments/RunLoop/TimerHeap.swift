@@ -0,0 +1,223 @@
+//
+//  TimerHeap.swift
+//  TinyFoundation
+//
+//  Created by Serhii Mumriak on 19.10.2026
+//
+
+#if !(os(macOS) || os(iOS) || os(tvOS) || os(watchOS))
+    // smumriak: binary min heap that also remembers where each timer lives, so removal of arbitrary timer is O(log n) instead of linear search in sorted array
+    internal struct TimerHeap {
+        internal let keyPath: KeyPath<Timer1, UInt64>
+        internal private(set) var storage: [Timer1] = []
+        internal private(set) var positions: [ObjectIdentifier: Int] = [:]
+
+        internal init(keyPath: KeyPath<Timer1, UInt64>) {
+            self.keyPath = keyPath
+        }
+
+        @_transparent
+        internal var isEmpty: Bool {
+            storage.isEmpty
+        }
+
+        @_transparent
+        internal var count: Int {
+            storage.count
+        }
+
+        @_transparent
+        internal var first: Timer1? {
+            storage.first
+        }
+
+        @_transparent
+        internal func contains(_ timer: Timer1) -> Bool {
+            positions[ObjectIdentifier(timer)] != nil
+        }
+
+        internal mutating func insert(_ timer: Timer1) {
+            if contains(timer) {
+                return
+            }
+
+            storage.append(timer)
+            positions[ObjectIdentifier(timer)] = storage.count - 1
+            siftUp(from: storage.count - 1)
+        }
+
+        @discardableResult
+        internal mutating func remove(_ timer: Timer1) -> Bool {
+            guard let index = positions[ObjectIdentifier(timer)] else {
+                return false
+            }
+
+            remove(at: index)
+            return true
+        }
+
+        @discardableResult
+        internal mutating func popFirst() -> Timer1? {
+            guard let first = storage.first else {
+                return nil
+            }
+
+            remove(at: 0)
+            return first
+        }
+
+        internal mutating func removeAll() {
+            storage.removeAll()
+            positions.removeAll()
+        }
+
+        /// All timers with key less than or equal to `limit`, in no particular order. Visits only matching nodes and their direct children
+        internal func elements(upTo limit: UInt64) -> [Timer1] {
+            var result: [Timer1] = []
+            var pending: [Int] = storage.isEmpty ? [] : [0]
+
+            while let index = pending.popLast() {
+                let timer = storage[index]
+                guard timer[keyPath: keyPath] <= limit else {
+                    continue
+                }
+
+                result.append(timer)
+
+                let left = 2 * index + 1
+                if left < storage.count {
+                    pending.append(left)
+                }
+                if left + 1 < storage.count {
+                    pending.append(left + 1)
+                }
+            }
+
+            return result
+        }
+
+        internal mutating func remove(at index: Int) {
+            let removed = storage[index]
+            positions[ObjectIdentifier(removed)] = nil
+
+            let lastIndex = storage.count - 1
+            if index == lastIndex {
+                storage.removeLast()
+                return
+            }
+
+            let last = storage.removeLast()
+            storage[index] = last
+            positions[ObjectIdentifier(storage[index])] = index
+
+            if index > 0 && key(at: index) < key(at: (index - 1) / 2) {
+                siftUp(from: index)
+            } else {
+                siftDown(from: index)
+            }
+        }
+
+        @_transparent
+        internal func key(at index: Int) -> UInt64 {
+            storage[index][keyPath: keyPath]
+        }
+
+        internal mutating func siftUp(from index: Int) {
+            var child = index
+
+            while child > 0 {
+                let parent = (child - 1) / 2
+                guard key(at: child) < key(at: parent) else {
+                    break
+                }
+
+                swapAt(child, parent)
+                child = parent
+            }
+        }
+
+        internal mutating func siftDown(from index: Int) {
+            var parent = index
+
+            while true {
+                let left = 2 * parent + 1
+                let right = left + 1
+                var smallest = parent
+
+                if left < storage.count && key(at: left) < key(at: smallest) {
+                    smallest = left
+                }
+                if right < storage.count && key(at: right) < key(at: smallest) {
+                    smallest = right
+                }
+
+                if smallest == parent {
+                    break
+                }
+
+                swapAt(parent, smallest)
+                parent = smallest
+            }
+        }
+
+        @_transparent
+        internal mutating func swapAt(_ lhs: Int, _ rhs: Int) {
+            storage.swapAt(lhs, rhs)
+            positions[ObjectIdentifier(storage[lhs])] = lhs
+            positions[ObjectIdentifier(storage[rhs])] = rhs
+        }
+    }
+
+    /// Timers of single run loop mode. Ordered by fire time to know what has to be fired, and by fire time plus tolerance to know when the timer port has to be armed. Arming at the earliest deadline instead of earliest fire time lets every timer whose fire time has passed by then to be handled in the same wake up
+    internal struct TimerQueue {
+        internal private(set) var byFireTime = TimerHeap(keyPath: \.fireTSR)
+        internal private(set) var byDeadline = TimerHeap(keyPath: \.deadlineTSR)
+
+        @_transparent
+        internal var isEmpty: Bool {
+            byFireTime.isEmpty
+        }
+
+        @_transparent
+        internal var count: Int {
+            byFireTime.count
+        }
+
+        @_transparent
+        internal var nextDeadline: UInt64? {
+            byDeadline.first?.deadlineTSR
+        }
+
+        @_transparent
+        internal var timers: [Timer1] {
+            byFireTime.storage
+        }
+
+        @_transparent
+        internal func contains(_ timer: Timer1) -> Bool {
+            byFireTime.contains(timer)
+        }
+
+        internal mutating func insert(_ timer: Timer1) {
+            byFireTime.insert(timer)
+            byDeadline.insert(timer)
+        }
+
+        @discardableResult
+        internal mutating func remove(_ timer: Timer1) -> Bool {
+            byDeadline.remove(timer)
+            return byFireTime.remove(timer)
+        }
+
+        internal mutating func removeAll() {
+            byFireTime.removeAll()
+            byDeadline.removeAll()
+        }
+
+        /// Timers that should fire at `time`, including the ones that were coalesced into this wake up because their tolerance allowed it
+        internal func timersToFire(at time: UInt64) -> [Timer1] {
+            byFireTime.elements(upTo: time)
+                .sorted { $0.fireTSR < $1.fireTSR }
+        }
+    }
+#endif
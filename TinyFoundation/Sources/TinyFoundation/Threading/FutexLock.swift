@@ -0,0 +1,312 @@
+//
+//  FutexLock.swift
+//  TinyFoundation
+//
+//  Created by Serhii Mumriak on 19.10.2026
+//
+
+import Foundation
+import Atomics
+
+#if canImport(LinuxSys)
+    import LinuxSys
+#endif
+
+internal let kLockStatisticsEnabled: Bool = ProcessInfo.processInfo.environment["APPKID_LOCK_STATISTICS"] != nil
+
+public struct LockStatistics: Equatable {
+    public var acquisitions: Int = 0
+    /// Acquisitions that found the lock taken and had to spin or sleep
+    public var contendedAcquisitions: Int = 0
+    /// Total time threads spent waiting for the lock, in nanoseconds
+    public var waitTime: UInt64 = 0
+
+    public init() {}
+}
+
+#if os(Linux)
+    /// Mutex built on top of a single futex word. Uncontended lock and unlock are one atomic operation each and never enter the kernel. Contended lock spins for a number of iterations that adapts to how long the lock was held recently and only then sleeps in the kernel
+    public final class FutexLock: LockProtocol {
+        // smumriak: 0 - unlocked, 1 - locked, 2 - locked and there might be sleeping waiters
+        internal let word: UnsafeMutablePointer<UInt32.AtomicRepresentation>
+
+        public static let maximumSpinCount: Int = 1000
+
+        public let collectsStatistics: Bool
+        fileprivate let spinEstimate = ManagedAtomic<Int>(0)
+        fileprivate let acquisitions = ManagedAtomic<Int>(0)
+        fileprivate let contendedAcquisitions = ManagedAtomic<Int>(0)
+        fileprivate let waitTime = ManagedAtomic<UInt64>(0)
+
+        internal var state: UnsafeAtomic<UInt32> {
+            UnsafeAtomic(at: word)
+        }
+
+        internal var futexAddress: UnsafeMutablePointer<UInt32> {
+            UnsafeMutableRawPointer(word).assumingMemoryBound(to: UInt32.self)
+        }
+
+        public init(collectsStatistics: Bool = kLockStatisticsEnabled) {
+            self.collectsStatistics = collectsStatistics
+
+            word = .allocate(capacity: 1)
+            word.initialize(to: UInt32.AtomicRepresentation(0))
+        }
+
+        deinit {
+            word.deinitialize(count: 1)
+            word.deallocate()
+        }
+
+        public var statistics: LockStatistics {
+            var result = LockStatistics()
+            result.acquisitions = acquisitions.load(ordering: .relaxed)
+            result.contendedAcquisitions = contendedAcquisitions.load(ordering: .relaxed)
+            result.waitTime = waitTime.load(ordering: .relaxed)
+            return result
+        }
+
+        public func resetStatistics() {
+            acquisitions.store(0, ordering: .relaxed)
+            contendedAcquisitions.store(0, ordering: .relaxed)
+            waitTime.store(0, ordering: .relaxed)
+        }
+
+        public func lock() {
+            if state.compareExchange(expected: 0, desired: 1, ordering: .acquiring).exchanged {
+                if collectsStatistics {
+                    acquisitions.wrappingIncrement(ordering: .relaxed)
+                }
+                return
+            }
+
+            lockContended()
+        }
+
+        public func unlock() {
+            if state.exchange(0, ordering: .releasing) == 2 {
+                futexWake(futexAddress, 1)
+            }
+        }
+
+        public func `try`() -> Bool {
+            let result = state.compareExchange(expected: 0, desired: 1, ordering: .acquiring).exchanged
+
+            if result && collectsStatistics {
+                acquisitions.wrappingIncrement(ordering: .relaxed)
+            }
+
+            return result
+        }
+
+        @inline(never)
+        internal func lockContended() {
+            let start: UInt64 = collectsStatistics ? .absoluteTime : 0
+
+            let estimate = spinEstimate.load(ordering: .relaxed)
+            let spinLimit = min(FutexLock.maximumSpinCount, estimate * 2 + 10)
+
+            var spins = 0
+            var acquired = false
+
+            while spins < spinLimit {
+                spins += 1
+                cpuRelax()
+
+                if state.load(ordering: .relaxed) == 0 && state.compareExchange(expected: 0, desired: 1, ordering: .acquiring).exchanged {
+                    acquired = true
+                    break
+                }
+            }
+
+            // smumriak: same as glibc adaptive mutex, estimate moves by one eighth towards the number of spins that were needed this time
+            spinEstimate.store(estimate + (spins - estimate) / 8, ordering: .relaxed)
+
+            if acquired == false {
+                while state.exchange(2, ordering: .acquiring) != 0 {
+                    futexWait(futexAddress, 2, nil)
+                }
+            }
+
+            if collectsStatistics {
+                acquisitions.wrappingIncrement(ordering: .relaxed)
+                contendedAcquisitions.wrappingIncrement(ordering: .relaxed)
+                waitTime.wrappingIncrement(by: UInt64.absoluteTime - start, ordering: .relaxed)
+            }
+        }
+    }
+
+    /// Condition variable for `FutexLock`. Waiters sleep on a sequence number that every signal and broadcast increments, so wake ups that happen between unlocking and sleeping are not lost
+    public final class FutexCondition {
+        internal let word: UnsafeMutablePointer<UInt32.AtomicRepresentation>
+
+        internal var sequence: UnsafeAtomic<UInt32> {
+            UnsafeAtomic(at: word)
+        }
+
+        internal var futexAddress: UnsafeMutablePointer<UInt32> {
+            UnsafeMutableRawPointer(word).assumingMemoryBound(to: UInt32.self)
+        }
+
+        public init() {
+            word = .allocate(capacity: 1)
+            word.initialize(to: UInt32.AtomicRepresentation(0))
+        }
+
+        deinit {
+            word.deinitialize(count: 1)
+            word.deallocate()
+        }
+
+        /// Unlocks the lock, sleeps until signaled and locks it again. Like any condition variable it can wake up spuriously
+        public func wait(with lock: FutexLock) {
+            let value = sequence.load(ordering: .relaxed)
+
+            lock.unlock()
+            futexWait(futexAddress, value, nil)
+            lock.lock()
+        }
+
+        /// Returns false if the limit has passed before the condition was signaled
+        public func wait(with lock: FutexLock, until limit: Date) -> Bool {
+            let interval = limit.timeIntervalSinceNow
+
+            if interval <= 0 {
+                return false
+            }
+
+            let value = sequence.load(ordering: .relaxed)
+            var timeout = timespec(tv_sec: Int(interval), tv_nsec: Int((interval - interval.rounded(.down)) * 1_000_000_000))
+
+            lock.unlock()
+            let result = futexWait(futexAddress, value, &timeout)
+            lock.lock()
+
+            return result != ETIMEDOUT
+        }
+
+        public func signal() {
+            sequence.wrappingIncrement(ordering: .releasing)
+            futexWake(futexAddress, 1)
+        }
+
+        public func broadcast() {
+            sequence.wrappingIncrement(ordering: .releasing)
+            futexWake(futexAddress, CInt.max)
+        }
+    }
+#else
+    // smumriak: futex is linux only, other platforms get pthread mutex and condition variable that count contention the same way
+    public final class FutexLock: LockProtocol {
+        internal let mutex: UnsafeMutablePointer<pthread_mutex_t>
+
+        public let collectsStatistics: Bool
+        fileprivate let acquisitions = ManagedAtomic<Int>(0)
+        fileprivate let contendedAcquisitions = ManagedAtomic<Int>(0)
+        fileprivate let waitTime = ManagedAtomic<UInt64>(0)
+
+        public init(collectsStatistics: Bool = kLockStatisticsEnabled) {
+            self.collectsStatistics = collectsStatistics
+
+            mutex = .allocate(capacity: 1)
+            mutex.initialize(to: pthread_mutex_t())
+            pthread_mutex_init(mutex, nil)
+        }
+
+        deinit {
+            pthread_mutex_destroy(mutex)
+            mutex.deinitialize(count: 1)
+            mutex.deallocate()
+        }
+
+        public var statistics: LockStatistics {
+            var result = LockStatistics()
+            result.acquisitions = acquisitions.load(ordering: .relaxed)
+            result.contendedAcquisitions = contendedAcquisitions.load(ordering: .relaxed)
+            result.waitTime = waitTime.load(ordering: .relaxed)
+            return result
+        }
+
+        public func resetStatistics() {
+            acquisitions.store(0, ordering: .relaxed)
+            contendedAcquisitions.store(0, ordering: .relaxed)
+            waitTime.store(0, ordering: .relaxed)
+        }
+
+        public func lock() {
+            guard collectsStatistics else {
+                pthread_mutex_lock(mutex)
+                return
+            }
+
+            acquisitions.wrappingIncrement(ordering: .relaxed)
+
+            if pthread_mutex_trylock(mutex) == 0 {
+                return
+            }
+
+            let start: UInt64 = .absoluteTime
+            pthread_mutex_lock(mutex)
+
+            contendedAcquisitions.wrappingIncrement(ordering: .relaxed)
+            waitTime.wrappingIncrement(by: UInt64.absoluteTime - start, ordering: .relaxed)
+        }
+
+        public func unlock() {
+            pthread_mutex_unlock(mutex)
+        }
+
+        public func `try`() -> Bool {
+            let result = pthread_mutex_trylock(mutex) == 0
+
+            if result && collectsStatistics {
+                acquisitions.wrappingIncrement(ordering: .relaxed)
+            }
+
+            return result
+        }
+    }
+
+    /// Condition variable for `FutexLock`, waits on the pthread mutex of the lock
+    public final class FutexCondition {
+        internal let condition: UnsafeMutablePointer<pthread_cond_t>
+
+        public init() {
+            condition = .allocate(capacity: 1)
+            condition.initialize(to: pthread_cond_t())
+            pthread_cond_init(condition, nil)
+        }
+
+        deinit {
+            pthread_cond_destroy(condition)
+            condition.deinitialize(count: 1)
+            condition.deallocate()
+        }
+
+        /// Unlocks the lock, sleeps until signaled and locks it again. Like any condition variable it can wake up spuriously
+        public func wait(with lock: FutexLock) {
+            pthread_cond_wait(condition, lock.mutex)
+        }
+
+        /// Returns false if the limit has passed before the condition was signaled
+        public func wait(with lock: FutexLock, until limit: Date) -> Bool {
+            if limit.timeIntervalSinceNow <= 0 {
+                return false
+            }
+
+            // smumriak: default pthread condition measures absolute time with realtime clock, same as Date
+            let interval = limit.timeIntervalSince1970
+            var endTime = timespec(tv_sec: Int(interval), tv_nsec: Int((interval - interval.rounded(.down)) * 1_000_000_000))
+
+            return pthread_cond_timedwait(condition, lock.mutex, &endTime) != ETIMEDOUT
+        }
+
+        public func signal() {
+            pthread_cond_signal(condition)
+        }
+
+        public func broadcast() {
+            pthread_cond_broadcast(condition)
+        }
+    }
+#endif
@@ -0,0 +1,60 @@
+//
+//  ReadWriteLock.swift
+//  TinyFoundation
+//
+//  Created by Serhii Mumriak on 19.10.2026
+//
+
+#if canImport(LinuxSys)
+    import LinuxSys
+#endif
+#if canImport(Glibc)
+    import Glibc
+#endif
+#if canImport(Darwin)
+    import Darwin
+#endif
+
+/// Lock that lets any number of readers in at the same time and writers one at a time. Made for read mostly data where readers would otherwise wait for each other
+public final class ReadWriteLock {
+    internal let rwlock: UnsafeMutablePointer<pthread_rwlock_t>
+
+    public init() {
+        rwlock = .allocate(capacity: 1)
+        rwlock.initialize(to: pthread_rwlock_t())
+        pthread_rwlock_init(rwlock, nil)
+    }
+
+    deinit {
+        pthread_rwlock_destroy(rwlock)
+        rwlock.deallocate()
+    }
+
+    public func readLock() {
+        pthread_rwlock_rdlock(rwlock)
+    }
+
+    public func writeLock() {
+        pthread_rwlock_wrlock(rwlock)
+    }
+
+    public func unlock() {
+        pthread_rwlock_unlock(rwlock)
+    }
+
+    @_transparent
+    public func reading<T>(_ body: () throws -> T) rethrows -> T {
+        readLock()
+        defer { unlock() }
+
+        return try body()
+    }
+
+    @_transparent
+    public func writing<T>(_ body: () throws -> T) rethrows -> T {
+        writeLock()
+        defer { unlock() }
+
+        return try body()
+    }
+}
@@ -0,0 +1,53 @@
+//
+//  FutexLockTests.swift
+//  TinyFoundation
+//
+//  Created by Serhii Mumriak on 19.10.2026
+//
+
+import XCTest
+import Foundation
+@testable import TinyFoundation
+
+final class FutexLockTests: XCTestCase {
+    func testConditionWakesWaiter() {
+        let lock = FutexLock()
+        let condition = FutexCondition()
+        var isReady = false
+        let finished = XCTestExpectation()
+
+        let thread = Thread {
+            lock.lock()
+            while isReady == false {
+                condition.wait(with: lock)
+            }
+            lock.unlock()
+
+            finished.fulfill()
+        }
+        thread.start()
+
+        usleep(10_000)
+
+        lock.synchronized {
+            isReady = true
+        }
+        condition.signal()
+
+        wait(for: [finished], timeout: 5)
+
+        lock.lock()
+        XCTAssertFalse(condition.wait(with: lock, until: Date(timeIntervalSinceNow: 0.01)))
+        lock.unlock()
+    }
+
+    func testTryFailsWhileLocked() {
+        let lock = FutexLock(collectsStatistics: true)
+
+        XCTAssertTrue(lock.try())
+        XCTAssertFalse(lock.try())
+        lock.unlock()
+
+        XCTAssertEqual(lock.statistics.acquisitions, 1)
+    }
+}
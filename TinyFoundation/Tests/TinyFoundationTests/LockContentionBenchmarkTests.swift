@@ -0,0 +1,110 @@
+//
+//  LockContentionBenchmarkTests.swift
+//  TinyFoundation
+//
+//  Created by Serhii Mumriak on 19.10.2026
+//
+
+import XCTest
+import Foundation
+@testable import TinyFoundation
+
+#if os(Linux)
+    final class LockContentionBenchmarkTests: XCTestCase {
+        let threadCount = max(2, min(8, ProcessInfo.processInfo.activeProcessorCount))
+        let iterationsPerThread = 200_000
+
+        var isBenchmarkEnabled: Bool {
+            ProcessInfo.processInfo.environment["APPKID_LOCK_BENCHMARKS"] != nil
+        }
+
+        /// Every thread increments shared counter under the lock. Returns nanoseconds per acquisition
+        func measureContention<L: LockProtocol>(_ lock: L) -> Double {
+            var counter = 0
+
+            let start: UInt64 = .absoluteTime
+
+            DispatchQueue.concurrentPerform(iterations: threadCount) { _ in
+                for _ in 0..<iterationsPerThread {
+                    lock.lock()
+                    counter += 1
+                    lock.unlock()
+                }
+            }
+
+            let elapsed = UInt64.absoluteTime - start
+
+            XCTAssertEqual(counter, threadCount * iterationsPerThread)
+
+            return Double(elapsed) / Double(threadCount * iterationsPerThread)
+        }
+
+        func testContendedCounter() throws {
+            try XCTSkipUnless(isBenchmarkEnabled, "Set APPKID_LOCK_BENCHMARKS to run lock benchmarks")
+
+            let mutexTime = measureContention(Lock())
+            let recursiveMutexTime = measureContention(RecursiveLock())
+
+            let futexLock = FutexLock(collectsStatistics: true)
+            let futexTime = measureContention(futexLock)
+            let statistics = futexLock.statistics
+
+            print("Lock contention, \(threadCount) threads: Lock \(format(mutexTime)) ns, RecursiveLock \(format(recursiveMutexTime)) ns, FutexLock \(format(futexTime)) ns per acquisition. FutexLock contended \(statistics.contendedAcquisitions) of \(statistics.acquisitions) acquisitions, waited \(format(Double(statistics.waitTime) / 1_000_000)) ms")
+
+            XCTAssertEqual(statistics.acquisitions, threadCount * iterationsPerThread)
+            XCTAssertLessThanOrEqual(statistics.contendedAcquisitions, statistics.acquisitions)
+        }
+
+        func testShardedLookups() throws {
+            try XCTSkipUnless(isBenchmarkEnabled, "Set APPKID_LOCK_BENCHMARKS to run lock benchmarks")
+
+            let keyCount = 1024
+            let sharded = ShardedDictionary<Int, Int>()
+            let readWriteLock = ReadWriteLock()
+            var dictionary: [Int: Int] = [:]
+            let lock = RecursiveLock()
+
+            for key in 0..<keyCount {
+                sharded[key] = key
+                dictionary[key] = key
+            }
+
+            let mismatchesLock = Lock()
+            var mismatches = 0
+
+            func measureLookups(_ lookup: (Int) -> Int?) -> Double {
+                let start: UInt64 = .absoluteTime
+
+                DispatchQueue.concurrentPerform(iterations: threadCount) { thread in
+                    var threadMismatches = 0
+
+                    for index in 0..<iterationsPerThread {
+                        let key = (index &* 31 &+ thread) % keyCount
+                        if lookup(key) != key {
+                            threadMismatches += 1
+                        }
+                    }
+
+                    mismatchesLock.synchronized {
+                        mismatches += threadMismatches
+                    }
+                }
+
+                return Double(UInt64.absoluteTime - start) / Double(threadCount * iterationsPerThread)
+            }
+
+            let recursiveLockTime = measureLookups { key in lock.synchronized { dictionary[key] } }
+            let readWriteLockTime = measureLookups { key in readWriteLock.reading { dictionary[key] } }
+            let shardedTime = measureLookups { key in sharded[key] }
+
+            print("Cache lookups, \(threadCount) threads: RecursiveLock \(format(recursiveLockTime)) ns, ReadWriteLock \(format(readWriteLockTime)) ns, ShardedDictionary \(format(shardedTime)) ns per lookup")
+
+            XCTAssertEqual(mismatches, 0)
+            XCTAssertEqual(sharded.count, keyCount)
+        }
+
+        private func format(_ value: Double) -> String {
+            String(format: "%.1f", value)
+        }
+    }
+#endif
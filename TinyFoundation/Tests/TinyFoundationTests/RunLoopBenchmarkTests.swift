@@ -0,0 +1,168 @@
+//
+//  RunLoopBenchmarkTests.swift
+//  TinyFoundation
+//
+//  Created by Serhii Mumriak on 19.10.2026
+//
+
+import XCTest
+@_spi(AppKid) @testable import TinyFoundation
+
+#if os(Linux)
+    import Glibc
+
+    final class RunLoopBenchmarkTests: XCTestCase {
+        final class PortContext: RunLoopSourceContext1 {
+            let port: OSPort
+            var performCount = 0
+
+            init() throws {
+                port = try OSPort()
+            }
+
+            deinit {
+                try? port.free()
+            }
+
+            func perform() {
+                try? port.acknowledge()
+                performCount += 1
+            }
+
+            func hash(into hasher: inout Hasher) {
+                hasher.combine(ObjectIdentifier(self))
+            }
+
+            static func == (lhs: PortContext, rhs: PortContext) -> Bool {
+                return lhs === rhs
+            }
+        }
+
+        var runLoop: RunLoop1!
+
+        var isBenchmarkEnabled: Bool {
+            ProcessInfo.processInfo.environment["APPKID_RUNLOOP_BENCHMARKS"] != nil
+        }
+
+        override func setUp() {
+            super.setUp()
+
+            runLoop = .current
+        }
+
+        override func tearDown() {
+            RunLoop1.clearRunLoop(Thread.current)
+            runLoop = nil
+
+            super.tearDown()
+        }
+
+        func spin(for duration: TimeInterval) -> (wakeUps: Int, elapsed: TimeInterval) {
+            let start: UInt64 = .absoluteTime
+            let end = start + UInt64(duration * 1_000_000_000)
+            var wakeUps = 0
+
+            while UInt64.absoluteTime < end {
+                runLoop.run(mode: .default, before: Date(timeIntervalSinceNow: 0.1))
+                wakeUps += 1
+            }
+
+            return (wakeUps, TimeInterval(UInt64.absoluteTime - start) / 1_000_000_000)
+        }
+
+        func testTenThousandTimers() throws {
+            try XCTSkipUnless(isBenchmarkEnabled, "Set APPKID_RUNLOOP_BENCHMARKS to run run loop benchmarks")
+
+            let timerCount = 10_000
+            var firedCount = 0
+
+            let timers: [Timer1] = (0..<timerCount).map { index in
+                // smumriak: intervals between 5 and 55 ms with 10% tolerance
+                let interval = 0.005 + TimeInterval(index % 100) * 0.0005
+                let timer = Timer1(fire: Date(timeIntervalSinceNow: interval), interval: interval, repeats: true) { _ in
+                    firedCount += 1
+                }
+                timer.tolerance = interval * 0.1
+                return timer
+            }
+
+            let insertionStart: UInt64 = .absoluteTime
+            timers.forEach {
+                runLoop.addTimer($0, forMode: .default)
+            }
+            let insertionTime = TimeInterval(UInt64.absoluteTime - insertionStart) / 1_000_000_000
+
+            let (wakeUps, elapsed) = spin(for: 1.0)
+
+            let removalStart: UInt64 = .absoluteTime
+            timers.forEach {
+                $0.invalidate()
+            }
+            let removalTime = TimeInterval(UInt64.absoluteTime - removalStart) / 1_000_000_000
+
+            print("RunLoop1 \(timerCount) timers: inserted in \(insertionTime * 1000) ms, removed in \(removalTime * 1000) ms, \(Int(Double(wakeUps) / elapsed)) wake ups/s, \(Int(Double(firedCount) / elapsed)) timer fires/s, \(Double(firedCount) / Double(max(wakeUps, 1))) fires per wake up")
+
+            XCTAssertGreaterThan(firedCount, timerCount)
+            XCTAssertLessThan(wakeUps, firedCount)
+            XCTAssertTrue(runLoop.isFinished(in: .default) || RunLoop1.main === runLoop)
+        }
+
+        func testThousandPorts() throws {
+            try XCTSkipUnless(isBenchmarkEnabled, "Set APPKID_RUNLOOP_BENCHMARKS to run run loop benchmarks")
+
+            let portCount = 1000
+
+            var limit = rlimit()
+            getrlimit(__rlimit_resource_t(RLIMIT_NOFILE.rawValue), &limit)
+            if limit.rlim_cur < rlim_t(portCount * 2) {
+                limit.rlim_cur = min(rlim_t(portCount * 4), limit.rlim_max)
+                setrlimit(__rlimit_resource_t(RLIMIT_NOFILE.rawValue), &limit)
+            }
+
+            let contexts = try (0..<portCount).map { _ in try PortContext() }
+            let sources = contexts.map { RunLoop1.Source(order: 0, context: $0) }
+            sources.forEach {
+                runLoop.addSource($0, mode: .default)
+            }
+
+            let lock = Lock()
+            var isRunning = true
+            var signalCount = 0
+            let finished = XCTestExpectation()
+
+            let signalingThread = Thread {
+                var index = 0
+                while lock.synchronized({ isRunning }) {
+                    try? contexts[index % portCount].port.signal()
+                    index += 1
+
+                    // smumriak: let the run loop catch up, otherwise this measures how fast eventfd counters saturate
+                    if index % portCount == 0 {
+                        usleep(500)
+                    }
+                }
+
+                signalCount = index
+                finished.fulfill()
+            }
+            signalingThread.start()
+
+            let (wakeUps, elapsed) = spin(for: 1.0)
+
+            lock.synchronized {
+                isRunning = false
+            }
+            wait(for: [finished], timeout: 5)
+
+            sources.forEach {
+                $0.invalidate()
+            }
+
+            let performCount = contexts.reduce(0) { $0 + $1.performCount }
+
+            print("RunLoop1 \(portCount) ports: \(Int(Double(wakeUps) / elapsed)) wake ups/s, \(Int(Double(performCount) / elapsed)) handled ports/s, \(Double(performCount) / Double(max(wakeUps, 1))) ports per wake up, \(signalCount) signals sent")
+
+            XCTAssertGreaterThan(performCount, 0)
+        }
+    }
+#endif
@@ -0,0 +1,79 @@
+//
+//  TimerHeapTests.swift
+//  TinyFoundation
+//
+//  Created by Serhii Mumriak on 19.10.2026
+//
+
+import XCTest
+@testable import TinyFoundation
+
+final class TimerHeapTests: XCTestCase {
+    func makeTimers(count: Int) -> [Timer1] {
+        (0..<count).map { _ in
+            Timer1(fire: Date(timeIntervalSinceNow: .random(in: 1...100)), interval: 1, repeats: false) { _ in }
+        }
+    }
+
+    func testPopsInFireOrder() {
+        let timers = makeTimers(count: 1000)
+        var heap = TimerHeap(keyPath: \.fireTSR)
+        timers.forEach { heap.insert($0) }
+
+        XCTAssertEqual(heap.count, timers.count)
+
+        var previous: UInt64 = 0
+        while let timer = heap.popFirst() {
+            XCTAssertGreaterThanOrEqual(timer.fireTSR, previous)
+            previous = timer.fireTSR
+        }
+
+        XCTAssertTrue(heap.isEmpty)
+    }
+
+    func testRemoveKeepsOrder() {
+        let timers = makeTimers(count: 1000)
+        var heap = TimerHeap(keyPath: \.fireTSR)
+        timers.forEach { heap.insert($0) }
+
+        let removed = Set(timers.enumerated().filter { $0.offset % 3 == 0 }.map { ObjectIdentifier($0.element) })
+        timers.filter { removed.contains(ObjectIdentifier($0)) }.forEach {
+            XCTAssertTrue(heap.remove($0))
+            XCTAssertFalse(heap.contains($0))
+        }
+
+        XCTAssertEqual(heap.count, timers.count - removed.count)
+
+        var previous: UInt64 = 0
+        while let timer = heap.popFirst() {
+            XCTAssertFalse(removed.contains(ObjectIdentifier(timer)))
+            XCTAssertGreaterThanOrEqual(timer.fireTSR, previous)
+            previous = timer.fireTSR
+        }
+    }
+
+    func testElementsUpToLimit() {
+        let timers = makeTimers(count: 1000)
+        var heap = TimerHeap(keyPath: \.fireTSR)
+        timers.forEach { heap.insert($0) }
+
+        let limit = timers.map { $0.fireTSR }.sorted()[499]
+        let result = heap.elements(upTo: limit)
+
+        XCTAssertEqual(result.count, timers.filter { $0.fireTSR <= limit }.count)
+        XCTAssertTrue(result.allSatisfy { $0.fireTSR <= limit })
+    }
+
+    func testQueueArmsAtEarliestDeadline() {
+        let early = Timer1(fire: Date(timeIntervalSinceNow: 1), interval: 1, repeats: false) { _ in }
+        early.tolerance = 10
+        let late = Timer1(fire: Date(timeIntervalSinceNow: 2), interval: 1, repeats: false) { _ in }
+
+        var queue = TimerQueue()
+        queue.insert(early)
+        queue.insert(late)
+
+        XCTAssertEqual(queue.nextDeadline, late.deadlineTSR)
+        XCTAssertEqual(queue.timersToFire(at: late.fireTSR).count, 2)
+    }
+}
@@ -54,12 +54,14 @@ public class Buffer: DeviceEntity<VkBuffer_T> {
     public let size: VkDeviceSize
     public let usage: VkBufferUsageFlagBits
     public let sharingMode: VkSharingMode
+    public let accessQueueFamiliesIndices: [CUnsignedInt]
     public let memoryChunk: MemoryChunk
 
-    public init(device: Device, handle: SharedPointer<VkBuffer_T>, size: VkDeviceSize, usage: VkBufferUsageFlagBits, sharingMode: VkSharingMode, memoryChunk: MemoryChunk, shouldBind: Bool = true) throws {
+    public init(device: Device, handle: SharedPointer<VkBuffer_T>, size: VkDeviceSize, usage: VkBufferUsageFlagBits, sharingMode: VkSharingMode, accessQueueFamiliesIndices: [CUnsignedInt] = [], memoryChunk: MemoryChunk, shouldBind: Bool = true) throws {
         self.size = size
         self.usage = usage
         self.sharingMode = sharingMode
+        self.accessQueueFamiliesIndices = accessQueueFamiliesIndices
         self.memoryChunk = memoryChunk
 
         try super.init(device: device, handle: handle)
@@ -77,6 +79,7 @@ public class Buffer: DeviceEntity<VkBuffer_T> {
         self.size = descriptor.size
         self.usage = descriptor.usage
         self.sharingMode = descriptor.sharingMode
+        self.accessQueueFamiliesIndices = descriptor.accessQueueFamiliesIndices
         self.memoryChunk = try device.memoryAllocator.allocate(for: handle, descriptor: descriptor)
 
         try super.init(device: device, handle: handle)
@@ -37,6 +37,22 @@ public final class CommandBuffer: DeviceEntity<VkCommandBuffer_T> {
         }
     }
 
+    /// Begins secondary command buffer that continues `subpass` of `renderPass`. Viewports, scissors and every other piece of dynamic state are not inherited from the primary command buffer and have to be set again
+    public func beginSecondary(inheriting renderPass: RenderPass, subpass: Int = 0, framebuffer: Framebuffer? = nil, flags: VkCommandBufferUsageFlagBits = [.oneTimeSubmit]) throws {
+        try VkCommandBufferBeginInfo.lava {
+            \.flags <- flags.union(.renderPassContinue)
+            \.pInheritanceInfo <- {
+                \.renderPass <- renderPass
+                \.subpass <- subpass
+                \.framebuffer <- framebuffer?.pointer
+            }
+        }.withUnsafeResultPointer { info in
+            try vulkanInvoke {
+                vkBeginCommandBuffer(pointer, info)
+            }
+        }
+    }
+
     public func end() throws {
         try vulkanInvoke {
             vkEndCommandBuffer(pointer)
@@ -56,6 +72,19 @@ public final class CommandBuffer: DeviceEntity<VkCommandBuffer_T> {
         }
     }
 
+    public func execute(commandBuffers: [CommandBuffer]) throws {
+        if commandBuffers.isEmpty {
+            return
+        }
+
+        try commandBuffers.optionalMutablePointers()
+            .withUnsafeBufferPointer { commandBuffers in
+                try vulkanInvoke {
+                    vkCmdExecuteCommands(pointer, CUnsignedInt(commandBuffers.count), commandBuffers.baseAddress!)
+                }
+            }
+    }
+
     public func endRenderPass() throws {
         try vulkanInvoke {
             vkCmdEndRenderPass(pointer)
@@ -196,6 +225,35 @@ public final class CommandBuffer: DeviceEntity<VkCommandBuffer_T> {
         }
     }
 
+    public func copyTexture(_ texture: Texture, to buffer: Buffer, bufferOffset: VkDeviceSize = 0, mipLevel: CUnsignedInt = 0, texelsPerRow: CUnsignedInt? = nil, height: CUnsignedInt? = nil, textureRect: VkRect3D? = nil, copiedLayersRange: Range<CUnsignedInt> = 0..<1) throws {
+        let textureRect = textureRect ?? VkRect3D(offset: .zero, extent: texture.extent)
+        let texelsPerRow: CUnsignedInt = texelsPerRow ?? 0
+        let height: CUnsignedInt = height ?? 0
+
+        let imageSubresource = VkImageSubresourceLayers(aspectMask: texture.imageView.aspect.rawValue, mipLevel: mipLevel, baseArrayLayer: copiedLayersRange.startIndex, layerCount: CUnsignedInt(copiedLayersRange.count))
+        var bufferCopyRegion = VkBufferImageCopy(bufferOffset: bufferOffset, bufferRowLength: texelsPerRow, bufferImageHeight: height, imageSubresource: imageSubresource, imageOffset: textureRect.offset, imageExtent: textureRect.extent)
+
+        try vulkanInvoke {
+            vkCmdCopyImageToBuffer(pointer, texture.image.pointer, texture.layout, buffer.pointer, 1, &bufferCopyRegion)
+        }
+    }
+
+    /// Global memory barrier, i.e. to make transfer writes visible to host reads after the fence wait
+    public func memoryBarrier(sourceStage: VkPipelineStageFlagBits, destinationStage: VkPipelineStageFlagBits, sourceAccessMask: VkAccessFlagBits, destinationAccessMask: VkAccessFlagBits) throws {
+        var barrier = VkMemoryBarrier.new()
+        barrier.srcAccessMask = sourceAccessMask.rawValue
+        barrier.dstAccessMask = destinationAccessMask.rawValue
+
+        try vulkanInvoke {
+            vkCmdPipelineBarrier(pointer,
+                                 sourceStage.rawValue, destinationStage.rawValue,
+                                 0,
+                                 1, &barrier, // memory barriers
+                                 0, nil, // buffer memory barriers
+                                 0, nil) // image memory barriers
+        }
+    }
+
     @_spi(AppKid) public func performPredefinedLayoutTransition(for texture: Texture, newLayout: VkImageLayout) throws {
         var barrier = VkImageMemoryBarrier.new()
 
@@ -228,6 +286,13 @@ public final class CommandBuffer: DeviceEntity<VkCommandBuffer_T> {
                 sourceStage.formUnion(.fragmentShader)
                 destinationStage.formUnion(.transfer)
 
+            case (.presentSourceKhr, .transferSourceOptimal), (.colorAttachmentOptimal, .transferSourceOptimal):
+                sourceAccessMask.formUnion(.colorAttachmentWrite)
+                destinationAccessMask.formUnion(.transferRead)
+
+                sourceStage.formUnion(.colorAttachmentOutput)
+                destinationStage.formUnion(.transfer)
+
             default:
                 assertionFailure("Volcano: Unsupported layout transition from \(oldLayout) to \(newLayout)")
         }
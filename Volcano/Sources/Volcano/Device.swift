@@ -35,6 +35,9 @@ public final class Device: PhysicalDeviceEntity<VkDevice_T> {
     internal let vkGetSemaphoreCounterValueKHR: PFN_vkGetSemaphoreCounterValueKHR
     internal let vkWaitSemaphoresKHR: PFN_vkWaitSemaphoresKHR
     internal let vkSignalSemaphoreKHR: PFN_vkSignalSemaphoreKHR
+    internal let vkGetFenceFdKHR: PFN_vkGetFenceFdKHR?
+
+    public let enabledExtensions: Set<DeviceExtension>
 
     public init(physicalDevice: PhysicalDevice, queueRequests: [QueueRequest] = [.default], extensions: Set<DeviceExtension> = [], memoryAllocatorClass: MemoryAllocator.Type = DirectMemoryAllocator.self) throws {
         var features = physicalDevice.features
@@ -85,6 +88,14 @@ public final class Device: PhysicalDeviceEntity<VkDevice_T> {
         vkWaitSemaphoresKHR = try handle.loadFunction(named: "vkWaitSemaphoresKHR")
         vkSignalSemaphoreKHR = try handle.loadFunction(named: "vkSignalSemaphoreKHR")
 
+        if extensions.contains(.externalFenceFdKhr) {
+            vkGetFenceFdKHR = try handle.loadFunction(named: "vkGetFenceFdKHR")
+        } else {
+            vkGetFenceFdKHR = nil
+        }
+
+        enabledExtensions = extensions
+
         try super.init(physicalDevice: physicalDevice, handle: handle)
 
         _memoryAllocator = try memoryAllocatorClass.init(device: self)
@@ -15,6 +15,39 @@ public final class Fence: DeviceEntity<VkFence_T> {
         
         try super.init(device: device, handle: handle)
     }
+
+    /// Fence which payload can be exported as file descriptor. Requires corresponding external fence extension to be enabled on device
+    public init(device: Device, flags: VkFenceCreateFlagBits = [], exportHandleTypes: VkExternalFenceHandleTypeFlagBits) throws {
+        var exportInfo = VkExportFenceCreateInfo.new()
+        exportInfo.handleTypes = exportHandleTypes.rawValue
+
+        let handle: SharedPointer<VkFence_T> = try withUnsafePointer(to: &exportInfo) { exportInfo in
+            var info = VkFenceCreateInfo(sType: .fenceCreateInfo, pNext: exportInfo, flags: flags.rawValue)
+
+            return try device.create(with: &info)
+        }
+
+        try super.init(device: device, handle: handle)
+    }
+
+    /// Exports fence payload as file descriptor. Caller owns returned descriptor. For `.syncFd` this has to be called after fence signal operation was submitted, export acts as fence reset and `nil` is returned if fence was already signaled
+    public func exportFileDescriptor(handleType: VkExternalFenceHandleTypeFlagBits = .syncFd) throws -> CInt? {
+        guard let vkGetFenceFdKHR = device.vkGetFenceFdKHR else {
+            throw VulkanError.deviceFunctionNotFound("vkGetFenceFdKHR")
+        }
+
+        var info = VkFenceGetFdInfoKHR.new()
+        info.fence = pointer
+        info.handleType = handleType
+
+        var result: CInt = -1
+
+        try vulkanInvoke {
+            vkGetFenceFdKHR(device.pointer, &info, &result)
+        }
+
+        return result == -1 ? nil : result
+    }
     
     public var isSignaled: Bool {
         get throws {
@@ -14,6 +14,9 @@ public class GraphicsPipelineDescriptor {
     public var geometryShader: Shader?
     public var fragmentShader: Shader?
 
+    public var vertexShaderSpecializationConstants: SpecializationConstants?
+    public var fragmentShaderSpecializationConstants: SpecializationConstants?
+
     // MARK: - Pipeline Layout
     
     // smumriak:TODO: maybe allowing clients to pass already created layout here and creating one if they did not is the way to go for future
@@ -186,11 +189,11 @@ internal extension GraphicsPipelineDescriptor {
     @_transparent
     @LavaArray<VkPipelineShaderStageCreateInfo>
     var shaders: LavaContainerArray<VkPipelineShaderStageCreateInfo> {
-        vertexShader?.builder(for: .vertex)
+        vertexShader?.builder(for: .vertex, specializationConstants: vertexShaderSpecializationConstants)
         tessellationControlShader?.builder(for: .tessellationControl)
         tessellationEvaluationShader?.builder(for: .tessellationEvaluation)
         geometryShader?.builder(for: .geometry)
-        fragmentShader?.builder(for: .fragment)
+        fragmentShader?.builder(for: .fragment, specializationConstants: fragmentShaderSpecializationConstants)
     }
 }
 
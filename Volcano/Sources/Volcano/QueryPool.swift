@@ -0,0 +1,60 @@
+//
+//  QueryPool.swift
+//  Volcano
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import TinyFoundation
+
+public final class QueryPool: DeviceEntity<VkQueryPool_T> {
+    public let type: VkQueryType
+    public let count: Int
+
+    public init(device: Device, type: VkQueryType, count: Int) throws {
+        self.type = type
+        self.count = count
+
+        try super.init(info: VkQueryPoolCreateInfo.self, device: device) {
+            \.queryType <- type
+            \.queryCount <- CUnsignedInt(count)
+        }
+    }
+
+    /// Reads 64 bit results of queries in range. Returns `nil` if any of them is not available yet and `wait` is `false`
+    public func results(in range: Range<Int>, wait: Bool = false) throws -> [UInt64]? {
+        if range.isEmpty {
+            return []
+        }
+
+        var result = [UInt64](repeating: 0, count: range.count)
+        var flags: VkQueryResultFlagBits = [.sixtyFour]
+        if wait {
+            flags.insert(.wait)
+        }
+
+        let status: VkResult = result.withUnsafeMutableBytes { buffer in
+            vkGetQueryPoolResults(device.pointer, pointer, CUnsignedInt(range.lowerBound), CUnsignedInt(range.count), buffer.count, buffer.baseAddress!, VkDeviceSize(MemoryLayout<UInt64>.stride), flags.rawValue)
+        }
+
+        switch status {
+            case .success: return result
+            case .notReady: return nil
+            default: throw VulkanError.badResult(status)
+        }
+    }
+}
+
+public extension CommandBuffer {
+    func reset(queryPool: QueryPool, range: Range<Int>) throws {
+        try vulkanInvoke {
+            vkCmdResetQueryPool(pointer, queryPool.pointer, CUnsignedInt(range.lowerBound), CUnsignedInt(range.count))
+        }
+    }
+
+    func writeTimestamp(to queryPool: QueryPool, index: Int, stage: VkPipelineStageFlagBits = .bottomOfPipe) throws {
+        try vulkanInvoke {
+            vkCmdWriteTimestamp(pointer, stage, queryPool.pointer, CUnsignedInt(index))
+        }
+    }
+}
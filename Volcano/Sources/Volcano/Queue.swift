@@ -37,35 +37,23 @@ public final class Queue: SharedPointerStorage<VkQueue_T> {
     }
 
     public func submit(with descriptor: SubmitDescriptor) throws {
-        try VkSubmitInfo.lava {
-            (\.waitSemaphoreCount, \.pWaitSemaphores) <- descriptor.waitSemaphores
-            (\.signalSemaphoreCount, \.pSignalSemaphores) <- descriptor.signalSemaphores
-            \.pWaitDstStageMask <- descriptor.waitStages
-            (\.commandBufferCount, \.pCommandBuffers) <- descriptor.commandBuffers
-
-            if descriptor.hasTimeline {
-                next(VkTimelineSemaphoreSubmitInfo.self) {
-                    (\.waitSemaphoreValueCount, \.pWaitSemaphoreValues) <- descriptor.waitSemaphoreValues
-                    (\.signalSemaphoreValueCount, \.pSignalSemaphoreValues) <- descriptor.signalSemaphoreValues
-                }
-            }
+        try submit(with: [descriptor], fence: descriptor.fence)
+    }
 
-            // <-Chain {
-            //     if descriptor.hasTimeline {
-            //         Lava<VkTimelineSemaphoreSubmitInfo> {
-            //             (\.waitSemaphoreValueCount, \.pWaitSemaphoreValues) <- descriptor.waitSemaphoreValues
-            //             (\.signalSemaphoreValueCount, \.pSignalSemaphoreValues) <- descriptor.signalSemaphoreValues
-            //         }
-            //     }
-            // }
+    /// Submits every descriptor in a single vkQueueSubmit call. Fences of individual descriptors are ignored, the batch is tracked by `fence`
+    public func submit(with descriptors: [SubmitDescriptor], fence: Fence?) throws {
+        if descriptors.isEmpty {
+            return
         }
-        .withUnsafeResultPointer { info in
-            try lock.synchronized {
-                try vulkanInvoke {
-                    vkQueueSubmit(pointer, 1, info, descriptor.fence?.pointer)
+
+        try LavaContainerArray(descriptors.map { $0.submitInfo })
+            .withUnsafeResultPointer { infos in
+                try lock.synchronized {
+                    try vulkanInvoke {
+                        vkQueueSubmit(pointer, CUnsignedInt(infos.count), infos.baseAddress!, fence?.pointer)
+                    }
                 }
             }
-        }
     }
 
     public func present(swapchains: [Swapchain],
@@ -86,6 +74,38 @@ public final class Queue: SharedPointerStorage<VkQueue_T> {
         }
     }
 
+    /// Presents all swapchains with one call and returns result for each of them. Out of date and suboptimal swapchains do not throw, so one window that is being resized does not prevent presentation of others
+    public func presentReturningResults(swapchains: [Swapchain],
+                                        waitSemaphores: [Volcano.Semaphore] = [],
+                                        imageIndices: [CUnsignedInt]) throws -> [VkResult] {
+        assert(swapchains.count == imageIndices.count)
+
+        var results = [VkResult](repeating: .success, count: swapchains.count)
+
+        let result: VkResult = VkPresentInfoKHR.lava {
+            (\.waitSemaphoreCount, \.pWaitSemaphores) <- waitSemaphores
+            (\.swapchainCount, \.pSwapchains) <- swapchains
+            \.pImageIndices <- imageIndices
+        }
+        .withUnsafeMutableResultPointer { info in
+            results.withUnsafeMutableBufferPointer { results in
+                info.pointee.pResults = results.baseAddress!
+
+                return lock.synchronized {
+                    device.vkQueuePresentKHR(pointer, info)
+                }
+            }
+        }
+
+        switch result {
+            case .success, .suboptimalKhr, .errorOutOfDateKhr:
+                return results
+
+            default:
+                throw VulkanError.badResult(result)
+        }
+    }
+
     public func oneShot(in commandPool: CommandPool, wait: Bool, semaphores: [TimelineSemaphore] = [], disposalBag: DisposalBag? = nil, _ body: (_ commandBuffer: CommandBuffer) throws -> ()) throws {
         let commandBuffer = try commandPool.createCommandBuffer()
         disposalBag?.append(commandBuffer)
@@ -192,6 +212,30 @@ public class SubmitDescriptor {
         self.fence = fence
     }
 
+    @Lava<VkSubmitInfo>
+    internal var submitInfo: LavaContainer<VkSubmitInfo> {
+        (\.waitSemaphoreCount, \.pWaitSemaphores) <- waitSemaphores
+        (\.signalSemaphoreCount, \.pSignalSemaphores) <- signalSemaphores
+        \.pWaitDstStageMask <- waitStages
+        (\.commandBufferCount, \.pCommandBuffers) <- commandBuffers
+
+        if hasTimeline {
+            next(VkTimelineSemaphoreSubmitInfo.self) {
+                (\.waitSemaphoreValueCount, \.pWaitSemaphoreValues) <- waitSemaphoreValues
+                (\.signalSemaphoreValueCount, \.pSignalSemaphoreValues) <- signalSemaphoreValues
+            }
+        }
+
+        // <-Chain {
+        //     if hasTimeline {
+        //         Lava<VkTimelineSemaphoreSubmitInfo> {
+        //             (\.waitSemaphoreValueCount, \.pWaitSemaphoreValues) <- waitSemaphoreValues
+        //             (\.signalSemaphoreValueCount, \.pSignalSemaphoreValues) <- signalSemaphoreValues
+        //         }
+        //     }
+        // }
+    }
+
     public func add(_ descriptor: WaitDescriptor) {
         waitSemaphores.append(descriptor.semaphore)
         waitSemaphoreValues.append(descriptor.value)
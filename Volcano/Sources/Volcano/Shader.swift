@@ -62,6 +62,7 @@ public extension Shader {
     fileprivate static let defaultShaderEntryPointNamePointer = strdup(defaultShaderEntryPointName)
 
     // smumriak:Do not delete this and keep in sync with builder implementation. This is to allow fallback to use infos directly. For Shader only
+    // smumriak: specialization info is not set here, its pointer would not outlive this function
     func createStageInfo(for stage: VkShaderStageFlagBits, flags: VkPipelineShaderStageCreateFlagBits = []) -> VkPipelineShaderStageCreateInfo {
         var result = VkPipelineShaderStageCreateInfo.new()
         
@@ -76,11 +77,13 @@ public extension Shader {
     }
 
     @Lava<VkPipelineShaderStageCreateInfo>
-    func builder(for stage: VkShaderStageFlagBits, flags: VkPipelineShaderStageCreateFlagBits = []) -> LavaContainer<VkPipelineShaderStageCreateInfo> {
+    func builder(for stage: VkShaderStageFlagBits, flags: VkPipelineShaderStageCreateFlagBits = [], specializationConstants: SpecializationConstants? = nil) -> LavaContainer<VkPipelineShaderStageCreateInfo> {
         \.flags <- flags
         \.stage <- stage
         \.module <- self
         \.pName <- entryPoint
-        \.pSpecializationInfo <- nil
+        if let specializationConstants = specializationConstants {
+            \.pSpecializationInfo <- specializationConstants.info
+        }
     }
 }
@@ -0,0 +1,55 @@
+//
+//  SpecializationConstants.swift
+//  Volcano
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import TinyFoundation
+
+/// Values of specialization constants of one shader stage, keyed by `constant_id` from shader source. Every value takes 32 bits, which covers bool, int, uint and float constants
+public final class SpecializationConstants {
+    public let values: [CUnsignedInt: CUnsignedInt]
+
+    // smumriak: pipeline creation info points into this storage, so it lives as long as the object
+    fileprivate let mapEntries: UnsafeMutableBufferPointer<VkSpecializationMapEntry>
+    fileprivate let data: UnsafeMutableBufferPointer<CUnsignedInt>
+
+    public var info: VkSpecializationInfo {
+        var result = VkSpecializationInfo()
+        result.mapEntryCount = CUnsignedInt(mapEntries.count)
+        result.pMapEntries = UnsafePointer(mapEntries.baseAddress)
+        result.dataSize = data.count * MemoryLayout<CUnsignedInt>.stride
+        result.pData = UnsafeRawPointer(data.baseAddress)
+
+        return result
+    }
+
+    public init(_ values: [CUnsignedInt: CUnsignedInt]) {
+        self.values = values
+
+        let sortedValues = values.sorted { $0.key < $1.key }
+
+        mapEntries = .allocate(capacity: sortedValues.count)
+        data = .allocate(capacity: sortedValues.count)
+
+        for (index, element) in sortedValues.enumerated() {
+            var entry = VkSpecializationMapEntry()
+            entry.constantID = element.key
+            entry.offset = CUnsignedInt(index * MemoryLayout<CUnsignedInt>.stride)
+            entry.size = MemoryLayout<CUnsignedInt>.stride
+
+            mapEntries[index] = entry
+            data[index] = element.value
+        }
+    }
+
+    public convenience init(booleans: [CUnsignedInt: Bool]) {
+        self.init(booleans.mapValues { $0.vkBool })
+    }
+
+    deinit {
+        mapEntries.deallocate()
+        data.deallocate()
+    }
+}
@@ -78,6 +78,18 @@ public extension Texture {
     var extent: VkExtent3D { return VkExtent3D(width: CUnsignedInt(width), height: CUnsignedInt(height), depth: CUnsignedInt(depth)) }
 }
 
+@_spi(AppKid) public extension Texture {
+    /// Size of device memory allocated for the texture. Zero for textures that do not own their memory, like swapchain images
+    var allocatedMemorySize: VkDeviceSize {
+        (self as? GenericTexture)?.memoryChunk.size ?? 0
+    }
+
+    /// Lazily allocated memory is committed by the driver only if the contents have to leave tile memory, which never happens for transient attachments on tiled GPUs
+    var isLazilyAllocated: Bool {
+        (self as? GenericTexture)?.memoryChunk.properties.contains(.lazilyAllocated) ?? false
+    }
+}
+
 internal class SwapchainTexture: Texture, Hashable {
     let device: Device
     let swapchain: Swapchain
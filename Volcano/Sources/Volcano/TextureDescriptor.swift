@@ -21,6 +21,8 @@ public struct TextureUsage: OptionSet {
     public static let shaderWrite = TextureUsage(rawValue: 1 << 1)
     public static let renderTarget = TextureUsage(rawValue: 1 << 2)
     public static let pixelFormatView = TextureUsage(rawValue: 1 << 4)
+    /// Render target whose contents never leave the render pass, i.e. multisampled attachment that is only resolved. Can be backed by lazily allocated memory
+    public static let transientAttachment = TextureUsage(rawValue: 1 << 5)
 }
 
 public final class TextureDescriptor {
@@ -81,9 +83,14 @@ public extension TextureDescriptor {
             imageUsageFlags.formUnion([.transferSource, .sampled, .inputAttachment])
         }
 
-        if usage.contains(.renderTarget) {
+        if usage.contains(.transientAttachment) {
+            // smumriak: transient images are only allowed to be attachments
+            imageUsageFlags.formUnion(.transientAttachment)
+        } else if usage.contains(.renderTarget) {
             imageUsageFlags.formUnion(.transferDestination)
+        }
 
+        if usage.contains(.renderTarget) || usage.contains(.transientAttachment) {
             if isDepthTexture || isStencilTexture {
                 imageUsageFlags.formUnion(.depthStencilAttachment)
             } else {
@@ -8,6 +8,11 @@
 public struct VkRect3D {
     public let offset: VkOffset3D
     public let extent: VkExtent3D
+
+    public init(offset: VkOffset3D, extent: VkExtent3D) {
+        self.offset = offset
+        self.extent = extent
+    }
 }
 
 public extension VkRect3D {
@@ -41,7 +41,7 @@ extension BufferDescriptor: MemoryAllocateDescriptor {
     }
 
     public func createEntity(device: Device, handle: SharedPointer<Info.Result>, memoryChunk: MemoryChunk) throws -> Buffer {
-        return try Buffer(device: device, handle: handle, size: size, usage: usage, sharingMode: sharingMode, memoryChunk: memoryChunk, shouldBind: true)
+        return try Buffer(device: device, handle: handle, size: size, usage: usage, sharingMode: sharingMode, accessQueueFamiliesIndices: accessQueueFamiliesIndices, memoryChunk: memoryChunk, shouldBind: true)
     }
 }
 
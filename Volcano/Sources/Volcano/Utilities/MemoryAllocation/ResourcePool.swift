@@ -0,0 +1,267 @@
+//
+//  ResourcePool.swift
+//  Volcano
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import TinyFoundation
+
+/// Keeps retired buffers and textures around so that next request with matching descriptor reuses them instead of going through allocator. The pool does not know anything about GPU progress, resources have to be recycled only after the GPU is done with them, i.e. through `RetirementQueue`
+public final class ResourcePool {
+    public struct BufferKey: Hashable {
+        public let size: VkDeviceSize
+        public let usage: VkBufferUsageFlagBits.RawValue
+        public let sharingMode: VkSharingMode.RawValue
+        public let accessQueueFamiliesIndices: [CUnsignedInt]
+
+        public init(_ descriptor: BufferDescriptor) {
+            size = descriptor.size
+            usage = descriptor.usage.rawValue
+            sharingMode = descriptor.sharingMode.rawValue
+            accessQueueFamiliesIndices = descriptor.accessQueueFamiliesIndices.sorted()
+        }
+
+        public init(_ buffer: Buffer) {
+            size = buffer.size
+            usage = buffer.usage.rawValue
+            sharingMode = buffer.sharingMode.rawValue
+            accessQueueFamiliesIndices = buffer.accessQueueFamiliesIndices.sorted()
+        }
+    }
+
+    public struct TextureKey: Hashable {
+        public let textureType: VkImageViewType.RawValue
+        public let pixelFormat: VkFormat.RawValue
+        public let width: Int
+        public let height: Int
+        public let depth: Int
+        public let mipmapLevelCount: Int
+        public let sampleCount: VkSampleCountFlagBits.RawValue
+        public let arrayLength: Int
+        public let usage: TextureUsage.RawValue
+        public let tiling: VkImageTiling.RawValue
+        public let swizzle: [VkComponentSwizzle.RawValue]
+        public let accessQueueFamiliesIndices: [CUnsignedInt]
+
+        public init(_ descriptor: TextureDescriptor) {
+            textureType = descriptor.textureType.rawValue
+            pixelFormat = descriptor.pixelFormat.rawValue
+            width = descriptor.width
+            height = descriptor.height
+            depth = descriptor.depth
+            mipmapLevelCount = descriptor.mipmapLevelCount
+            sampleCount = descriptor.sampleCount.rawValue
+            arrayLength = descriptor.arrayLength
+            usage = descriptor.usage.rawValue
+            tiling = descriptor.tiling.rawValue
+            swizzle = [descriptor.swizzle.r.rawValue, descriptor.swizzle.g.rawValue, descriptor.swizzle.b.rawValue, descriptor.swizzle.a.rawValue]
+            accessQueueFamiliesIndices = descriptor.accessQueueFamiliesIndices.sorted()
+        }
+
+        public init(_ texture: Texture) {
+            textureType = texture.textureType.rawValue
+            pixelFormat = texture.pixelFormat.rawValue
+            width = texture.width
+            height = texture.height
+            depth = texture.depth
+            mipmapLevelCount = texture.mipmapLevelCount
+            sampleCount = texture.sampleCount.rawValue
+            arrayLength = texture.arrayLength
+            usage = texture.usage.rawValue
+            tiling = texture.tiling.rawValue
+            swizzle = [texture.swizzle.r.rawValue, texture.swizzle.g.rawValue, texture.swizzle.b.rawValue, texture.swizzle.a.rawValue]
+            accessQueueFamiliesIndices = texture.accessQueueFamiliesIndices.sorted()
+        }
+    }
+
+    public struct Statistics {
+        public internal(set) var hits: UInt64 = 0
+        public internal(set) var misses: UInt64 = 0
+        public internal(set) var recycled: UInt64 = 0
+        public internal(set) var evicted: UInt64 = 0
+        public internal(set) var retainedBytes: UInt64 = 0
+    }
+
+    internal struct Entry<Resource> {
+        let resource: Resource
+        let bytes: UInt64
+        let memoryProperties: VkMemoryPropertyFlagBits
+        let age: UInt64
+    }
+
+    public let device: Device
+    public let maximumRetainedBytes: UInt64
+    public let maximumEntriesPerKey: Int
+
+    internal let lock = Lock()
+    internal var buffers: [BufferKey: [Entry<Buffer>]] = [:]
+    internal var textures: [TextureKey: [Entry<Texture>]] = [:]
+    internal var ageCounter: UInt64 = 0
+    internal var _statistics = Statistics()
+
+    public var statistics: Statistics {
+        lock.synchronized { _statistics }
+    }
+
+    public init(device: Device, maximumRetainedBytes: UInt64 = 64 << 20, maximumEntriesPerKey: Int = 4) {
+        self.device = device
+        self.maximumRetainedBytes = maximumRetainedBytes
+        self.maximumEntriesPerKey = maximumEntriesPerKey
+    }
+
+    // MARK: - Buffers
+
+    /// Buffers with create flags are never pooled
+    public func buffer(with descriptor: BufferDescriptor) throws -> Buffer {
+        if descriptor.flags.isEmpty == false {
+            return try device.memoryAllocator.create(with: descriptor).result
+        }
+
+        let key = BufferKey(descriptor)
+        let requiredMemoryProperties = descriptor.requiredMemoryProperties
+
+        let pooled: Buffer? = lock.synchronized {
+            let result = take(from: &buffers, key: key, requiredMemoryProperties: requiredMemoryProperties)
+            if result == nil {
+                _statistics.misses += 1
+            } else {
+                _statistics.hits += 1
+            }
+            return result
+        }
+
+        if let pooled = pooled {
+            return pooled
+        }
+
+        return try device.memoryAllocator.create(with: descriptor).result
+    }
+
+    public func recycle(_ buffer: Buffer) {
+        let entry = Entry<Buffer>(resource: buffer, bytes: UInt64(buffer.size), memoryProperties: buffer.memoryChunk.properties, age: 0)
+
+        lock.synchronized {
+            put(entry, into: &buffers, key: BufferKey(buffer))
+        }
+    }
+
+    // MARK: - Textures
+
+    public func texture(with descriptor: TextureDescriptor) throws -> Texture {
+        let key = TextureKey(descriptor)
+        let requiredMemoryProperties = descriptor.requiredMemoryProperties
+
+        let pooled: Texture? = lock.synchronized {
+            let result = take(from: &textures, key: key, requiredMemoryProperties: requiredMemoryProperties)
+            if result == nil {
+                _statistics.misses += 1
+            } else {
+                _statistics.hits += 1
+            }
+            return result
+        }
+
+        if let pooled = pooled {
+            // smumriak: contents of recycled image are garbage anyway, transition from undefined layout is always valid and lets driver skip preserving them
+            pooled.layout = descriptor.initialLayout
+            return pooled
+        }
+
+        return try device.createTexture(with: descriptor)
+    }
+
+    /// Only textures that own their memory can be recycled, swapchain and buffer backed textures are ignored
+    public func recycle(_ texture: Texture) {
+        guard let texture = texture as? GenericTexture else {
+            return
+        }
+
+        let bytes = UInt64(texture.memoryChunk.size)
+        let entry = Entry<Texture>(resource: texture, bytes: bytes, memoryProperties: texture.memoryChunk.properties, age: 0)
+
+        lock.synchronized {
+            put(entry, into: &textures, key: TextureKey(texture))
+        }
+    }
+
+    // MARK: - Maintenance
+
+    public func purge() {
+        lock.synchronized {
+            buffers.removeAll()
+            textures.removeAll()
+            _statistics.retainedBytes = 0
+        }
+    }
+
+    internal func take<Key: Hashable, Resource>(from storage: inout [Key: [Entry<Resource>]], key: Key, requiredMemoryProperties: VkMemoryPropertyFlagBits) -> Resource? {
+        guard var entries = storage[key], let index = entries.lastIndex(where: { $0.memoryProperties.isSuperset(of: requiredMemoryProperties) }) else {
+            return nil
+        }
+
+        let entry = entries.remove(at: index)
+        storage[key] = entries.isEmpty ? nil : entries
+        _statistics.retainedBytes -= entry.bytes
+
+        return entry.resource
+    }
+
+    internal func put<Key: Hashable, Resource>(_ entry: Entry<Resource>, into storage: inout [Key: [Entry<Resource>]], key: Key) {
+        if entry.bytes > maximumRetainedBytes {
+            return
+        }
+
+        ageCounter += 1
+        let entry = Entry(resource: entry.resource, bytes: entry.bytes, memoryProperties: entry.memoryProperties, age: ageCounter)
+
+        var entries = storage[key] ?? []
+        if entries.count >= maximumEntriesPerKey {
+            let evicted = entries.removeFirst()
+            _statistics.retainedBytes -= evicted.bytes
+            _statistics.evicted += 1
+        }
+        entries.append(entry)
+        storage[key] = entries
+
+        _statistics.retainedBytes += entry.bytes
+        _statistics.recycled += 1
+
+        evictIfNeeded()
+    }
+
+    // smumriak: drops the oldest entries across both kinds of resources until retained memory fits the budget
+    internal func evictIfNeeded() {
+        while _statistics.retainedBytes > maximumRetainedBytes {
+            let oldestBuffer = buffers.compactMap { key, entries in entries.first.map { (key, $0.age) } }.min { $0.1 < $1.1 }
+            let oldestTexture = textures.compactMap { key, entries in entries.first.map { (key, $0.age) } }.min { $0.1 < $1.1 }
+
+            switch (oldestBuffer, oldestTexture) {
+                case (.some(let buffer), .some(let texture)) where buffer.1 < texture.1:
+                    evictFirst(from: &buffers, key: buffer.0)
+
+                case (_, .some(let texture)):
+                    evictFirst(from: &textures, key: texture.0)
+
+                case (.some(let buffer), .none):
+                    evictFirst(from: &buffers, key: buffer.0)
+
+                case (.none, .none):
+                    _statistics.retainedBytes = 0
+                    return
+            }
+        }
+    }
+
+    internal func evictFirst<Key: Hashable, Resource>(from storage: inout [Key: [Entry<Resource>]], key: Key) {
+        guard var entries = storage[key], entries.isEmpty == false else {
+            return
+        }
+
+        let evicted = entries.removeFirst()
+        storage[key] = entries.isEmpty ? nil : entries
+        _statistics.retainedBytes -= evicted.bytes
+        _statistics.evicted += 1
+    }
+}
@@ -0,0 +1,302 @@
+//
+//  FenceCompletionPort.swift
+//  Volcano
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+@_spi(AppKid) import TinyFoundation
+
+#if os(Linux)
+    import Glibc
+
+    /// Delivers fence completions through single pollable file descriptor. With VK_KHR_external_fence_fd every fence is exported as sync file and registered in epoll set, so completions are picked up by whichever run loop polls `fileDescriptor` without any extra threads. Without the extension fences are waited on a background queue which then signals the same descriptor
+    public final class FenceCompletionPort {
+        public enum Error: Swift.Error {
+            case portCreationFailed
+            case syncFileError
+        }
+
+        /// Called with failure if waiting for the fence failed. Fence is reset by the time callback is called
+        public typealias Callback = (_ result: Result<Void, Swift.Error>) -> ()
+
+        public let device: Device
+        public let isNative: Bool
+
+        /// epoll descriptor that becomes readable when at least one fence has completed
+        public var fileDescriptor: CInt { fileDescriptorPort.fileDescriptor }
+
+        internal let fileDescriptorPort: FileDescriptorPort
+        internal let fallbackEventDescriptor: CInt
+        internal let lock = RecursiveLock()
+        internal var pendingCallbacks: [CInt: Callback] = [:]
+        internal var readyCompletions: [() -> ()] = []
+        internal var isValid = true
+
+        internal lazy var fallbackQueue = DispatchQueue(label: "FenceCompletionPort.fallback", qos: .userInitiated)
+
+        public static func isNativelySupported(on device: Device) -> Bool {
+            device.vkGetFenceFdKHR != nil
+        }
+
+        deinit {
+            invalidate()
+        }
+
+        public init(device: Device) throws {
+            self.device = device
+            isNative = Self.isNativelySupported(on: device)
+
+            let epollFileDescriptor = try syscall {
+                epoll_create1(CInt(EPOLL_CLOEXEC))
+            }
+
+            guard let fileDescriptorPort = FileDescriptorPort(fileDescriptor: epollFileDescriptor, closeOnInvalidate: true) else {
+                close(epollFileDescriptor)
+                throw Error.portCreationFailed
+            }
+
+            self.fileDescriptorPort = fileDescriptorPort
+
+            do {
+                fallbackEventDescriptor = try syscall {
+                    eventfd(0, CInt(EFD_CLOEXEC | EFD_NONBLOCK))
+                }
+            } catch {
+                fileDescriptorPort.invalidate()
+                throw error
+            }
+
+            var event = epoll_event()
+            event.events = EPOLLIN.rawValue
+            event.data.fd = fallbackEventDescriptor
+
+            try syscall {
+                epoll_ctl(epollFileDescriptor, EPOLL_CTL_ADD, fallbackEventDescriptor, &event)
+            }
+
+            fileDescriptorPort.enableNotificationType([.read])
+            fileDescriptorPort.setDelegate(self)
+        }
+
+        /// Fence that can be handed to `notify(when:callback:)`. Regular fences also work, but always go through fallback path
+        public func createFence(flags: VkFenceCreateFlagBits = []) throws -> Fence {
+            if isNative {
+                return try Fence(device: device, flags: flags, exportHandleTypes: .syncFd)
+            } else {
+                return try Fence(device: device, flags: flags)
+            }
+        }
+
+        /// Calls `callback` from `handleEvents()` once GPU signals the fence. The fence has to be already submitted and nobody else should wait on it or reset it until callback is called
+        public func notify(when fence: Fence, callback: @escaping Callback) throws {
+            if isNative {
+                do {
+                    // smumriak: exporting sync file resets the fence
+                    guard let syncFileDescriptor = try fence.exportFileDescriptor(handleType: .syncFd) else {
+                        // smumriak: already signaled, deliver on next handleEvents to keep callbacks asynchronous
+                        enqueueReady {
+                            callback(.success(()))
+                        }
+                        return
+                    }
+
+                    do {
+                        try lock.synchronized {
+                            var event = epoll_event()
+                            event.events = EPOLLIN.rawValue | EPOLLONESHOT.rawValue
+                            event.data.fd = syncFileDescriptor
+
+                            try syscall {
+                                epoll_ctl(fileDescriptor, EPOLL_CTL_ADD, syncFileDescriptor, &event)
+                            }
+
+                            pendingCallbacks[syncFileDescriptor] = callback
+                        }
+                    } catch {
+                        close(syncFileDescriptor)
+                        throw error
+                    }
+
+                    return
+                } catch VulkanError.badResult(let result) where result == .errorInvalidExternalHandle {
+                    // smumriak: fence was not created with sync fd export enabled, fallback to waiting on the queue
+                }
+            }
+
+            fallbackQueue.async { [weak self] in
+                let result = Result<Void, Swift.Error> {
+                    try fence.wait()
+                    try fence.reset()
+                }
+
+                self?.enqueueReady {
+                    callback(result)
+                }
+            }
+        }
+
+        /// Drains every completion that is ready without blocking. Returns number of callbacks that were called
+        @discardableResult
+        public func handleEvents() -> Int {
+            var completions: [() -> ()] = []
+
+            withUnsafeTemporaryAllocation(of: epoll_event.self, capacity: 64) { events in
+                while true {
+                    let count: CInt
+
+                    do {
+                        count = try syscall {
+                            epoll_wait(fileDescriptor, events.baseAddress!, CInt(events.count), 0)
+                        }
+                    } catch {
+                        // smumriak: nothing registered in broken epoll set can complete anymore, every waiter gets the error
+                        completions.append(contentsOf: failPendingCallbacks(with: error))
+                        break
+                    }
+
+                    if count == 0 {
+                        break
+                    }
+
+                    lock.synchronized {
+                        for event in events.prefix(Int(count)) {
+                            let descriptor = event.data.fd
+
+                            if descriptor == fallbackEventDescriptor {
+                                var value: eventfd_t = 0
+                                _ = eventfd_read(fallbackEventDescriptor, &value)
+                                completions.append(contentsOf: readyCompletions)
+                                readyCompletions.removeAll()
+                            } else if let callback = pendingCallbacks.removeValue(forKey: descriptor) {
+                                _ = epoll_ctl(fileDescriptor, EPOLL_CTL_DEL, descriptor, nil)
+                                close(descriptor)
+
+                                // smumriak: sync file reports device loss or other fence errors as poll error
+                                if event.events & EPOLLERR.rawValue != 0 {
+                                    completions.append { callback(.failure(Error.syncFileError)) }
+                                } else {
+                                    completions.append { callback(.success(())) }
+                                }
+                            }
+                        }
+                    }
+
+                    if count < events.count {
+                        break
+                    }
+                }
+            }
+
+            completions.forEach { $0() }
+
+            return completions.count
+        }
+
+        /// Blocks calling thread until at least one fence completes, then calls callbacks of every completed fence on it. For ports that are not scheduled in any run loop
+        @discardableResult
+        public func waitForEvents() throws -> Int {
+            var pollDescriptor = pollfd(fd: fileDescriptor, events: Int16(POLLIN), revents: 0)
+
+            try syscall {
+                poll(&pollDescriptor, 1, -1)
+            }
+
+            return handleEvents()
+        }
+
+        public func invalidate() {
+            lock.synchronized {
+                guard isValid else { return }
+                isValid = false
+
+                pendingCallbacks.keys.forEach {
+                    close($0)
+                }
+                pendingCallbacks.removeAll()
+                readyCompletions.removeAll()
+
+                close(fallbackEventDescriptor)
+                fileDescriptorPort.invalidate()
+            }
+        }
+
+        internal func enqueueReady(_ completion: @escaping () -> ()) {
+            lock.synchronized {
+                guard isValid else { return }
+
+                readyCompletions.append(completion)
+                _ = eventfd_write(fallbackEventDescriptor, 1)
+            }
+        }
+
+        internal func failPendingCallbacks(with error: Swift.Error) -> [() -> ()] {
+            lock.synchronized {
+                var result: [() -> ()] = pendingCallbacks.map { descriptor, callback in
+                    _ = epoll_ctl(fileDescriptor, EPOLL_CTL_DEL, descriptor, nil)
+                    close(descriptor)
+
+                    return { callback(.failure(error)) }
+                }
+                pendingCallbacks.removeAll()
+
+                result.append(contentsOf: readyCompletions)
+                readyCompletions.removeAll()
+
+                return result
+            }
+        }
+    }
+
+    // MARK: - Run loop integration
+
+    public extension FenceCompletionPort {
+        func schedule(in runLoop: RunLoop, forMode mode: RunLoop.Mode) {
+            fileDescriptorPort.schedule(in: runLoop, forMode: mode)
+        }
+
+        func remove(from runLoop: RunLoop, forMode mode: RunLoop.Mode) {
+            fileDescriptorPort.remove(from: runLoop, forMode: mode)
+        }
+
+        /// Context for scheduling the port in `RunLoop1` as a port based source
+        var runLoopSourceContext: RunLoopSourceContext {
+            RunLoopSourceContext(port: self)
+        }
+
+        final class RunLoopSourceContext: RunLoopSourceContext1 {
+            public unowned let completionPort: FenceCompletionPort
+            public let port: OSPort
+
+            internal init(port: FenceCompletionPort) {
+                completionPort = port
+                self.port = OSPort(port.fileDescriptor, shouldFree: false)
+            }
+
+            public func perform() {
+                completionPort.handleEvents()
+            }
+
+            public func hash(into hasher: inout Hasher) {
+                hasher.combine(ObjectIdentifier(self))
+            }
+
+            public static func == (lhs: RunLoopSourceContext, rhs: RunLoopSourceContext) -> Bool {
+                return lhs === rhs
+            }
+        }
+    }
+
+    extension FenceCompletionPort: FileDescriptorPortDelegate {
+        public func handle(_ message: PortMessage) {}
+
+        public func handle(awokenFileDescriptorPort: FileDescriptorPort) {
+            // 1. call back every fence that has completed since last wake up, without blocking
+            handleEvents()
+
+            // 2. enable read notification on awoken file descriptor
+            awokenFileDescriptorPort.enableNotificationType([.read])
+        }
+    }
+#endif
@@ -0,0 +1,189 @@
+//
+//  RetirementQueue.swift
+//  Volcano
+//
+//  Created by Serhii Mumriak on 19.10.2026.
+//
+
+import Foundation
+import TinyFoundation
+
+/// Holds on to objects that are still referenced by submitted GPU work and lets them go once timeline semaphore reaches the value of submission that used them last. Every submission that uses retired objects has to signal `semaphore` with `nextValue` and report it via `didSubmit(value:)`
+public final class RetirementQueue {
+    public typealias Completion = () -> ()
+
+    internal struct Batch {
+        let value: UInt64
+        var objects: [Any] = []
+        var commandBuffers: [CommandBuffer] = []
+        var buffers: [Buffer] = []
+        var textures: [Texture] = []
+        var completions: [Completion] = []
+
+        init(value: UInt64) {
+            self.value = value
+        }
+    }
+
+    public let device: Device
+    public let semaphore: TimelineSemaphore
+    public let resourcePool: ResourcePool?
+
+    /// When set, destruction and recycling of reclaimed batches happens here instead of the thread that called `reclaim()`
+    public let reclamationQueue: DispatchQueue?
+
+    internal let lock = Lock()
+    internal var batches: [Batch] = []
+    internal var _submittedValue: UInt64 = 0
+
+    /// Value signaled by the latest submission. Objects retired without explicit value wait for it
+    public var submittedValue: UInt64 {
+        lock.synchronized { _submittedValue }
+    }
+
+    /// Value that next submission should signal on `semaphore`
+    public var nextValue: UInt64 {
+        lock.synchronized { _submittedValue + 1 }
+    }
+
+    public var pendingBatchesCount: Int {
+        lock.synchronized { batches.count }
+    }
+
+    public init(device: Device, resourcePool: ResourcePool? = nil, reclaimsOnBackgroundQueue: Bool = false) throws {
+        self.device = device
+        self.resourcePool = resourcePool
+        semaphore = try TimelineSemaphore(device: device)
+
+        if reclaimsOnBackgroundQueue {
+            reclamationQueue = DispatchQueue(label: "RetirementQueue.reclamation", qos: .utility)
+        } else {
+            reclamationQueue = nil
+        }
+    }
+
+    /// Has to be called only after the submission that signals `value` went through successfully, otherwise reclamation would wait for a value that never comes
+    public func didSubmit(value: UInt64) {
+        lock.synchronized {
+            assert(value > _submittedValue, "Timeline semaphore values have to strictly increase")
+            _submittedValue = value
+        }
+    }
+
+    // MARK: - Retiring
+
+    public func retire(_ object: Any, after value: UInt64? = nil) {
+        append(after: value) {
+            if let commandBuffer = object as? CommandBuffer {
+                $0.commandBuffers.append(commandBuffer)
+            } else {
+                $0.objects.append(object)
+            }
+        }
+    }
+
+    /// Buffer goes back to `resourcePool` instead of being destroyed
+    public func recycle(_ buffer: Buffer, after value: UInt64? = nil) {
+        append(after: value) {
+            $0.buffers.append(buffer)
+        }
+    }
+
+    /// Texture goes back to `resourcePool` instead of being destroyed
+    public func recycle(_ texture: Texture, after value: UInt64? = nil) {
+        append(after: value) {
+            $0.textures.append(texture)
+        }
+    }
+
+    /// Completion is called on the thread that calls `reclaim()` once GPU has passed `value`
+    public func notify(after value: UInt64? = nil, _ completion: @escaping Completion) {
+        append(after: value) {
+            $0.completions.append(completion)
+        }
+    }
+
+    // MARK: - Reclaiming
+
+    /// Releases every batch that GPU has already finished with. Does not block. Returns number of reclaimed batches
+    @discardableResult
+    public func reclaim() throws -> Int {
+        let hasBatches = lock.synchronized { batches.isEmpty == false }
+        if hasBatches == false {
+            return 0
+        }
+
+        let completedValue = try semaphore.value
+
+        return reclaim(upTo: completedValue)
+    }
+
+    /// Waits for the GPU to finish every submission reported so far and releases everything
+    public func drain() throws {
+        let value = submittedValue
+        if value > 0 {
+            try semaphore.wait(value: value)
+        }
+
+        reclaim(upTo: .max)
+
+        reclamationQueue?.sync {}
+    }
+
+    @discardableResult
+    internal func reclaim(upTo completedValue: UInt64) -> Int {
+        let ready: [Batch] = lock.synchronized {
+            // smumriak: there are only as many batches as frames in flight, linear scan is fine
+            let count = batches.firstIndex { $0.value > completedValue } ?? batches.count
+            let result = Array(batches.prefix(count))
+            batches.removeFirst(count)
+            return result
+        }
+
+        if ready.isEmpty {
+            return 0
+        }
+
+        ready.forEach { batch in
+            batch.completions.forEach { $0() }
+        }
+
+        // smumriak: command buffers are freed back into their pool, which requires external synchronization with whoever records from it. they are not captured by the release closure, so they go away on this thread together with `ready`
+        let objects = ready.flatMap { $0.objects }
+        let buffers = ready.flatMap { $0.buffers }
+        let textures = ready.flatMap { $0.textures }
+        let resourcePool = self.resourcePool
+
+        let release = {
+            if let resourcePool = resourcePool {
+                buffers.forEach { resourcePool.recycle($0) }
+                textures.forEach { resourcePool.recycle($0) }
+            }
+
+            withExtendedLifetime(objects) {}
+        }
+
+        if let reclamationQueue = reclamationQueue {
+            reclamationQueue.async(execute: release)
+        } else {
+            release()
+        }
+
+        return ready.count
+    }
+
+    internal func append(after value: UInt64?, _ body: (inout Batch) -> ()) {
+        lock.synchronized {
+            let value = value ?? _submittedValue
+
+            // smumriak: everything retired for the same submission lands in one batch, so reclamation walks batches instead of individual objects. objects retired after an older value than the newest batch join it, which is conservative and keeps batches ordered
+            if let last = batches.last, last.value >= value {
+                body(&batches[batches.count - 1])
+            } else {
+                var batch = Batch(value: value)
+                body(&batch)
+                batches.append(batch)
+            }
+        }
+    }
+}
@@ -9,10 +9,15 @@ import Foundation
 import TinyFoundation
 
 public final class SemaphoreWatcher {
-    private var thread: Thread
-    private let lock = RecursiveLock()
+    /// Watcher thread is only started when the first semaphore is added
+    private var thread: Thread? = nil
+    private let lock = FutexLock()
     public let runLoop: SemaphoreRunLoop
     public private(set) var sources: Set<SemaphoreRunLoop.Source> = []
+    #if os(Linux)
+        /// When set, callbacks are called on the run loop the port is scheduled in instead of the watcher thread
+        public private(set) var completionPort: FenceCompletionPort? = nil
+    #endif
 
     deinit {
         do {
@@ -23,9 +28,26 @@ public final class SemaphoreWatcher {
     }
 
     public init(device: Device) throws {
-        let runLoop = try SemaphoreRunLoop(device: device)
-        
-        thread = Thread {
+        runLoop = try SemaphoreRunLoop(device: device)
+    }
+
+    #if os(Linux)
+        public convenience init(device: Device, completionPort: FenceCompletionPort) throws {
+            try self.init(device: device)
+
+            self.completionPort = completionPort
+        }
+    #endif
+
+    /// Has to be called with lock acquired
+    private func startThreadIfNeeded() {
+        if thread != nil {
+            return
+        }
+
+        let runLoop = self.runLoop
+
+        let thread = Thread {
             do {
                 repeat {
                     _ = try runLoop.run(before: .distantFuture)
@@ -39,19 +61,31 @@ public final class SemaphoreWatcher {
             }
         }
 
-        self.runLoop = runLoop
-
+        thread.name = "SepahoreWatcher"
         thread.start()
 
-        thread.name = "SepahoreWatcher"
+        self.thread = thread
     }
 
     @discardableResult
     public func add(semaphore: TimelineSemaphore, waitValue: UInt64? = nil, callback: @escaping SemaphoreRunLoop.Source.Callback) throws -> SemaphoreRunLoop.Source {
         try lock.synchronized {
+            var callback = callback
+
+            #if os(Linux)
+                // smumriak: timeline semaphores can not be exported as pollable sync files, so they are still waited on the watcher thread, but callbacks are handed over to the completion port and run on its run loop
+                if let completionPort = completionPort {
+                    let watcherCallback = callback
+                    callback = {
+                        completionPort.enqueueReady(watcherCallback)
+                    }
+                }
+            #endif
+
             let source = try SemaphoreRunLoop.Source(with: semaphore, waitValue: waitValue ?? semaphore.value, callback: callback)
             sources.insert(source)
 
+            startThreadIfNeeded()
             try runLoop.add(source: source)
 
             return source
@@ -64,6 +98,7 @@ public final class SemaphoreWatcher {
             let source = try SemaphoreRunLoop.Source(with: semaphore, waitValue: waitValue ?? semaphore.value, continuation: continuation)
             sources.insert(source)
 
+            startThreadIfNeeded()
             try runLoop.add(source: source)
 
             return source
@@ -76,6 +111,7 @@ public final class SemaphoreWatcher {
             let source = try SemaphoreRunLoop.Source(with: semaphore, waitValue: waitValue ?? semaphore.value, throwingContinuation: throwingContinuation)
             sources.insert(source)
 
+            startThreadIfNeeded()
             try runLoop.add(source: source)
 
             return source